@@ -0,0 +1,46 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#version 330 core
+
+// One jump flooding step: takes the nearest of the rejected pixels known to
+// the pixel and to its eight neighbors stepSize pixels away.
+
+#define NO_SEED 65535u
+
+uniform usampler2D seeds;
+uniform int stepSize;
+
+// Size of the camera image (the seed textures may be larger):
+uniform int width;
+uniform int height;
+
+out uvec2 Seed;
+
+void main()
+{
+    ivec2 coords = ivec2(gl_FragCoord.xy);
+
+    uvec2 best = uvec2(NO_SEED);
+    int bestDistance = 0x7fffffff;
+
+    for(int dY = -1; dY <= 1; ++dY){
+        for(int dX = -1; dX <= 1; ++dX){
+            ivec2 neighbor = coords + ivec2(dX, dY) * stepSize;
+            if(neighbor.x < 0 || neighbor.y < 0 || neighbor.x >= width || neighbor.y >= height)
+                continue;
+
+            uvec2 seed = texelFetch(seeds, neighbor, 0).xy;
+            if(seed.x == NO_SEED)
+                continue;
+
+            ivec2 offset = ivec2(seed) - coords;
+            int squaredDistance = offset.x * offset.x + offset.y * offset.y;
+            if(squaredDistance < bestDistance){
+                bestDistance = squaredDistance;
+                best = seed;
+            }
+        }
+    }
+
+    Seed = best;
+}
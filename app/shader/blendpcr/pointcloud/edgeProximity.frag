@@ -3,42 +3,34 @@
 
 #version 330 core
 
-uniform sampler2D rejectedTexture;
-uniform int kernelRadius = 10;
+// Converts the distance to the nearest rejected pixel (found by jump
+// flooding, see edgeJumpFlood.frag) into the proximity: 1 on rejected
+// pixels, falling linearly to 0 at edgeRadius pixels away.
+
+#define NO_SEED 65535u
 
-in vec2 vScreenPos;
+uniform sampler2D rejectedTexture;
+uniform usampler2D seeds;
+uniform float edgeRadius = 5.0;
 
 out vec4 FragColor;
 
 void main()
 {
-    vec2 texelSize = 1.0 / textureSize(rejectedTexture, 0);
+    ivec2 coords = ivec2(gl_FragCoord.xy);
 
-    float edgeVal = texture(rejectedTexture, vScreenPos).r;
+    float edgeVal = texelFetch(rejectedTexture, coords, 0).r;
     if(edgeVal > 0.5){
         FragColor = vec4(1.0, 1.0, 1.0, 1.0);
         return;
     }
 
-	int steps = 3;
-    int rad = 5;
-
     float maxInfluence = 0.0;
-    for(float _dX = -rad*steps; _dX <= rad*steps; _dX += steps){
-        for(float _dY = -rad*steps; _dY <= rad*steps; _dY += steps){
-			float dX = _dX / steps;
-			float dY = _dY / steps;
-		
-            vec2 offset = vec2(dX, dY) * texelSize;
-            vec2 coord = vScreenPos + offset;
-            float value = texture(rejectedTexture, coord).r;
-
-            if(value > 0.5){
-                float d = clamp((rad - sqrt(float(dX) * float(dX) + float(dY) * float(dY))) / rad, 0.0, 1.0);
-                if(!isnan(d))
-                    maxInfluence = max(maxInfluence, d);
-            }
-        }
+
+    uvec2 seed = texelFetch(seeds, coords, 0).xy;
+    if(seed.x != NO_SEED){
+        float d = length(vec2(ivec2(seed) - coords));
+        maxInfluence = clamp((edgeRadius - d) / edgeRadius, 0.0, 1.0);
     }
 
     FragColor = vec4(maxInfluence, maxInfluence, maxInfluence, 1.0);
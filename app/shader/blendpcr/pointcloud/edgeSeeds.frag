@@ -0,0 +1,20 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#version 330 core
+
+// Initializes the jump flooding of the edge proximity: rejected pixels are
+// their own nearest rejected pixel, all others have none yet.
+
+#define NO_SEED 65535u
+
+uniform sampler2D rejectedTexture;
+
+out uvec2 Seed;
+
+void main()
+{
+    ivec2 coords = ivec2(gl_FragCoord.xy);
+    bool rejected = texelFetch(rejectedTexture, coords, 0).r > 0.5;
+
+    Seed = rejected ? uvec2(coords) : uvec2(NO_SEED);
+}
@@ -9,6 +9,9 @@ uniform float p_h = 1.f;
 uniform float kernelSpread = 1.f;
 uniform int kernelRadius = 2;
 
+// Distance between the samples (1: exact, 2: strided MLS with a quarter of the taps):
+uniform int sampleStride = 1;
+
 uniform sampler2D pointCloud;
 uniform sampler2D edgeProximity;
 
@@ -43,8 +46,8 @@ void main()
     vec3 sumPoints = vec3(0,0,0);
     float sumWeights = 0;
 
-    for(int dX = -usedRadius; dX <= usedRadius; ++dX){
-        for(int dY = -usedRadius; dY <= usedRadius; ++dY){
+    for(int dX = -usedRadius; dX <= usedRadius; dX += sampleStride){
+        for(int dY = -usedRadius; dY <= usedRadius; dY += sampleStride){
             vec2 coord = vScreenPos + vec2(dX, dY) * texelSize;
             vec3 p = texture(pointCloud, coord).xyz;
             float edgeDist = texture(edgeProximity, coord).r;
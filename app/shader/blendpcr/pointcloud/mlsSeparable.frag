@@ -0,0 +1,65 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#version 330 core
+
+// One direction of the separable approximation of mls.frag: the first pass
+// smoothes along the rows, the second one smoothes the result along the
+// columns (2 * 21 instead of 21 * 21 taps). The weights are the same as in
+// mls.frag, but relative to the center vertex of the respective pass.
+
+in vec2 vScreenPos;
+
+uniform float p_h = 1.f;
+
+// (1, 0) for the first pass, (0, 1) for the second pass:
+uniform vec2 direction = vec2(1.0, 0.0);
+
+uniform sampler2D pointCloud;
+uniform sampler2D edgeProximity;
+
+out vec4 FragColor;
+
+float calculateTheta(vec3 p, vec3 x){
+    float d = distance(p, x);
+    return pow(2.71828, -(d*d) / (p_h*p_h));
+}
+
+void main()
+{
+    vec2 texelSize = 1.0 / textureSize(pointCloud, 0);
+
+    vec3 mid = texture(pointCloud, vScreenPos).xyz;
+    float edgeDistance = texture(edgeProximity, vScreenPos).r;
+
+    if(edgeDistance > 0.99){
+        FragColor = vec4(0, 0, -1.0, 1.0);
+        return;
+    }
+
+    int usedRadius = 10;
+
+    vec3 sumPoints = vec3(0,0,0);
+    float sumWeights = 0;
+
+    for(int d = -usedRadius; d <= usedRadius; ++d){
+        vec2 coord = vScreenPos + direction * float(d) * texelSize;
+        vec3 p = texture(pointCloud, coord).xyz;
+        float edgeDist = texture(edgeProximity, coord).r;
+
+        if(edgeDist > 0.99)
+            continue;
+
+        float theta = 1;
+        if(d != 0)
+            theta = calculateTheta(mid, p);
+
+        float weight = theta * clamp(edgeDist, 0.5, 1.0);
+        sumPoints += p * weight;
+        sumWeights += clamp(weight,0.000001,100000);
+    }
+
+    if(sumWeights > 0.000000001)
+        FragColor.rgba = vec4(sumPoints / sumWeights, 1.0);
+    else
+        FragColor = vec4(0.0, 0.0, 10.0, 1.0);
+}
@@ -17,6 +17,7 @@ in vec2 vScreenPos;
 uniform float p_h = 0.05f;
 uniform float kernelSpread = 1.f;
 uniform int kernelRadius = 2;
+uniform int normalRadius = 2;
 
 uniform int depthImageWidth;
 uniform int depthImageHeight;
@@ -271,7 +272,7 @@ void main()
     // Calculate Covariance Matrix:
     mat3 B = mat3(0);
 
-    int radius = 2;
+    int radius = normalRadius;
 
     for(int dX = -radius; dX <= radius; ++dX){
         for(int dY = -radius; dY <= radius; ++dY){
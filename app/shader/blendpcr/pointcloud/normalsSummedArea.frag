@@ -0,0 +1,129 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#version 330 core
+
+// Normal estimation from the summed-area tables built by normalSums.comp:
+// the covariance of the window is assembled from four lookups per table
+// (independent of the radius) and its smallest eigenvector is computed in
+// closed form. Unlike normals.frag, all valid vertices of the window have
+// the same weight (the sums can not depend on the center).
+
+in vec2 vScreenPos;
+
+uniform int normalRadius = 2;
+uniform float quantization = 2000.0;
+
+// Size of the camera image (the tables may be larger):
+uniform int width;
+uniform int height;
+
+uniform sampler2D texture2D_mlsVertices;
+uniform usampler2D sumsA;
+uniform usampler2D sumsB;
+uniform usampler2D sumsC;
+
+out vec4 FragColor;
+
+#define SUM_COUNT 10
+
+void fetchSums(ivec2 coords, out uint sums[SUM_COUNT]){
+    if(coords.x < 0 || coords.y < 0){
+        for(int k = 0; k < SUM_COUNT; ++k)
+            sums[k] = 0u;
+        return;
+    }
+
+    uvec4 a = texelFetch(sumsA, coords, 0);
+    uvec4 b = texelFetch(sumsB, coords, 0);
+    uvec2 c = texelFetch(sumsC, coords, 0).xy;
+    sums = uint[SUM_COUNT](a.x, a.y, a.z, a.w, b.x, b.y, b.z, b.w, c.x, c.y);
+}
+
+/**
+ * Returns the eigenvector of the smallest eigenvalue of the symmetric matrix
+ * (trigonometric solution of the characteristic polynomial).
+ */
+vec3 smallestEigenvector(mat3 B){
+    float p1 = B[0][1] * B[0][1] + B[0][2] * B[0][2] + B[1][2] * B[1][2];
+    float q = (B[0][0] + B[1][1] + B[2][2]) / 3.0;
+    float p2 = (B[0][0] - q) * (B[0][0] - q) + (B[1][1] - q) * (B[1][1] - q) + (B[2][2] - q) * (B[2][2] - q) + 2.0 * p1;
+    float p = sqrt(p2 / 6.0);
+
+    // All eigenvalues are equal, no preferred direction:
+    if(p < 1e-6 * max(abs(q), 1e-20))
+        return vec3(0.0, 0.0, 1.0);
+
+    float r = clamp(determinant((B - q * mat3(1.0)) / p) * 0.5, -1.0, 1.0);
+    float phi = acos(r) / 3.0;
+    float lambda = q + 2.0 * p * cos(phi + 2.0943951);
+
+    // The eigenvector is orthogonal to the rows of B - lambda * I, take the most stable cross product:
+    mat3 M = B - lambda * mat3(1.0);
+    vec3 c01 = cross(M[0], M[1]);
+    vec3 c02 = cross(M[0], M[2]);
+    vec3 c12 = cross(M[1], M[2]);
+
+    float d01 = dot(c01, c01);
+    float d02 = dot(c02, c02);
+    float d12 = dot(c12, c12);
+
+    vec3 eigenvector = d01 >= d02 && d01 >= d12 ? c01 : (d02 >= d12 ? c02 : c12);
+    return normalize(eigenvector);
+}
+
+void main()
+{
+    ivec2 coords = ivec2(vScreenPos * vec2(width, height));
+    vec3 a = texelFetch(texture2D_mlsVertices, coords, 0).xyz;
+
+    if(a.z < 0.1)
+        return;
+
+    // Window sum from the four corners (lower corner exclusive):
+    ivec2 lower = max(coords - normalRadius, ivec2(0)) - 1;
+    ivec2 upper = min(coords + normalRadius, ivec2(width, height) - 1);
+
+    uint s11[SUM_COUNT], s01[SUM_COUNT], s10[SUM_COUNT], s00[SUM_COUNT];
+    fetchSums(upper, s11);
+    fetchSums(ivec2(lower.x, upper.y), s01);
+    fetchSums(ivec2(upper.x, lower.y), s10);
+    fetchSums(lower, s00);
+
+    uint s[SUM_COUNT];
+    for(int k = 0; k < SUM_COUNT; ++k)
+        s[k] = s11[k] - s01[k] - s10[k] + s00[k];
+
+    uint n = s[0];
+    if(n < 3u){
+        FragColor.rgba = vec4(0.0, 0.0, 1.0, 1.0);
+        return;
+    }
+
+    // Covariance around a: sum (p - a)(p - a)^T = S_pp - a S_p^T - S_p a^T + n a a^T.
+    // Computed modulo 2^32 like the sums, the result is exact as long as it fits into an int:
+    uvec3 c = uvec3(ivec3(round(a * quantization)));
+    uvec3 sp = uvec3(s[1], s[2], s[3]);
+
+    float xx = float(int(s[4] - 2u * c.x * sp.x + n * c.x * c.x));
+    float xy = float(int(s[5] - c.x * sp.y - c.y * sp.x + n * c.x * c.y));
+    float xz = float(int(s[6] - c.x * sp.z - c.z * sp.x + n * c.x * c.z));
+    float yy = float(int(s[7] - 2u * c.y * sp.y + n * c.y * c.y));
+    float yz = float(int(s[8] - c.y * sp.z - c.z * sp.y + n * c.y * c.z));
+    float zz = float(int(s[9] - 2u * c.z * sp.z + n * c.z * c.z));
+
+    // In quantization units squared (the scale does not change the eigenvectors):
+    mat3 B = mat3(xx, xy, xz,
+                  xy, yy, yz,
+                  xz, yz, zz);
+
+    vec3 normal = smallestEigenvector(B);
+
+    // if normal shows away from the camera, invert it:
+    if(normal.z < 0)
+        normal = -normal;
+
+    FragColor.rgba = vec4(normal, 1.0);
+
+    if(vScreenPos.x > 0.9993)
+        FragColor.rgba = vec4(1.0, 1.0, 1.0, 1.0);
+}
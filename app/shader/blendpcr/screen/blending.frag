@@ -2,18 +2,24 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Specialized by the application for the active camera count:
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 3
+#endif
 
 in vec2 vScreenPos;
 
-uniform sampler2D color[CAMERA_NUM];
-uniform sampler2D vertices[CAMERA_NUM];
-uniform sampler2D normals[CAMERA_NUM];
-uniform sampler2D depth[CAMERA_NUM];
+// One layer per camera:
+uniform sampler2DArray color;
+uniform sampler2DArray vertices;
+uniform sampler2DArray normals;
+uniform sampler2DArray depth;
 
-uniform sampler2D miniWeightsA;
+// Camera weights (one layer per camera, quarter resolution):
+uniform sampler2DArray cameraWeights;
 
-uniform bool isCameraActive[CAMERA_NUM];
+// Camera parameters (cameras[i].isActive):
+#include "../../cameraBlock.shader"
 
 out vec4 FragColor;
 
@@ -28,15 +34,12 @@ void main()
 
     float lastDistToCam = 10000;
 
-    vec4 miniWValueA = texture(miniWeightsA, vScreenPos).rgba;
-	//miniWValueA = vec4(0.0, 1.0, 0.0, 0.0);
-
     for(int i=0; i < CAMERA_NUM; ++i){
-        if(isCameraActive[i]){
-            vec4 currentVertex = vec4(texture(vertices[i], vScreenPos).xyz, 1.0);
-            vec2 blendFactors = vec2(texture(vertices[i], vScreenPos).a, texture(normals[i], vScreenPos).a);
+        if(cameras[i].isActive != 0){
+            vec4 currentVertex = vec4(texture(vertices, vec3(vScreenPos, i)).xyz, 1.0);
+            vec2 blendFactors = vec2(texture(vertices, vec3(vScreenPos, i)).a, texture(normals, vec3(vScreenPos, i)).a);
 
-            float currentAlpha = miniWValueA[i] * blendFactors.y;
+            float currentAlpha = texture(cameraWeights, vec3(vScreenPos, i)).r * blendFactors.y;
 
             float distToCam = length(currentVertex.xyz);
 
@@ -53,9 +56,9 @@ void main()
                 continue;
             }
 
-            vec3 currentNormal = texture(normals[i], vScreenPos).xyz;
-            vec3 currentColor = texture(color[i], vScreenPos).rgb;
-            float currentDepth = texture(depth[i], vScreenPos).r;
+            vec3 currentNormal = texture(normals, vec3(vScreenPos, i)).xyz;
+            vec3 currentColor = texture(color, vec3(vScreenPos, i)).rgb;
+            float currentDepth = texture(depth, vec3(vScreenPos, i)).r;
 
             sumColor += currentColor * currentAlpha;
             sumNormal += currentNormal * currentAlpha;
@@ -2,16 +2,21 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Specialized by the application for the active camera count:
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 3
+#endif
 
 in vec2 vScreenPos;
 
-uniform sampler2D color[CAMERA_NUM];
-uniform sampler2D vertices[CAMERA_NUM];
-uniform sampler2D normals[CAMERA_NUM];
-uniform sampler2D depth[CAMERA_NUM];
+// One layer per camera:
+uniform sampler2DArray color;
+uniform sampler2DArray vertices;
+uniform sampler2DArray normals;
+uniform sampler2DArray depth;
 
-uniform bool isCameraActive[CAMERA_NUM];
+// Camera parameters (cameras[i].isActive):
+#include "../../cameraBlock.shader"
 
 uniform bool useFusion = false;
 uniform vec4 cameraVector;
@@ -23,12 +28,12 @@ void main()
 {		
     float distanceTreshold = 0.05;
 
-    vec2 halfTexelSize = 2.0 / textureSize(vertices[0], 0);
+    vec2 halfTexelSize = 2.0 / textureSize(vertices, 0).xy;
 
     float mainDistToCam = 9999.0;
     for(int i=0; i < CAMERA_NUM; ++i){
-        if(isCameraActive[i]){
-            vec4 tVertex = vec4(texture(vertices[i], vScreenPos).xyz, 1.0);
+        if(cameras[i].isActive != 0){
+            vec4 tVertex = vec4(texture(vertices, vec3(vScreenPos, i)).xyz, 1.0);
             float tDistToCam = length(tVertex.xyz);
 
             if(tDistToCam >= 0.01 && tDistToCam < mainDistToCam){
@@ -43,8 +48,8 @@ void main()
     float lastDistToCam = 10000;
 
     for(int i=0; i < CAMERA_NUM; ++i){
-        if(isCameraActive[i]){
-            vec4 vtxTexValue = texture(vertices[i], vScreenPos);
+        if(cameras[i].isActive != 0){
+            vec4 vtxTexValue = texture(vertices, vec3(vScreenPos, i));
             vec4 currentVertex = vec4(vtxTexValue.xyz, 1.0);
 
             float currentAlpha = vtxTexValue.a;
@@ -7,11 +7,8 @@
 
 in vec2 vScreenPos;
 
-struct Projector {
-	vec4 direction;
-};
-
-uniform Projector projectors[PROJECTOR_COUNT];
+// Projector parameters (only used by the disabled filter below):
+#include "../../projectorBlock.shader"
 
 uniform sampler2D vertexTexture;
 uniform usampler2D nearestIndicesTexture;
@@ -6,19 +6,14 @@
 #define PROJECTOR_COUNT 3
 in vec2 vScreenPos;
 
-struct Projector {
-	mat4 projection;
-	mat4 view;
-	vec4 position;
-	vec4 direction;
-};
-
-uniform Projector projectors[PROJECTOR_COUNT];
+// Projector and camera parameters:
+#include "../../projectorBlock.shader"
+#include "../../cameraBlock.shader"
 
 uniform sampler2D vertexTexture;
 uniform sampler2D distanceTexture;
 
-uniform mat4 model;
+uniform int cameraID;
 
 out vec4 FragColor;
 
@@ -29,6 +24,7 @@ void main()
 {
     // Relative size of one pixel:
     vec2 texelSize = 1.0 / textureSize(vertexTexture, 0);
+	mat4 model = cameras[cameraID].model;
 		
 	
 	vec4 totalColor = vec4(0.0);
@@ -46,6 +42,9 @@ void main()
 			float bestValue = 0.0;
 	
 			for(int projectorID = 0; projectorID < PROJECTOR_COUNT; ++projectorID){
+				if(projectorID >= projectorCount)
+					continue;
+
 				vec4 vertexPS = projectors[projectorID].view * vertex;
 				vec4 vertexProjected = projectors[projectorID].projection * vertexPS;
 				vec2 vertexPImageS = (vertexProjected).xy / vertexProjected.w * 0.5 + 0.5;
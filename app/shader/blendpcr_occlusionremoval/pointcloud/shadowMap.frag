@@ -7,17 +7,17 @@
 
 in vec2 vScreenPos;
 
-struct Projector {
-	sampler2D distanceMap;
-	mat4 projection;
-	mat4 view;
-};
+// Projector and camera parameters:
+#include "../../projectorBlock.shader"
+#include "../../cameraBlock.shader"
 
-uniform Projector projectors[PROJECTOR_COUNT];
+// Distance maps rendered from the projectors with distanceMapProjection:
+uniform sampler2D projectorDistanceMaps[PROJECTOR_COUNT];
+uniform mat4 distanceMapProjection;
 
 uniform sampler2D vertexTexture;
 
-uniform mat4 model;
+uniform int cameraID;
 
 out vec4 FragColor;
 
@@ -28,6 +28,7 @@ void main()
 {
     // Relative size of one pixel:
     vec2 texelSize = 1.0 / textureSize(vertexTexture, 0);
+	mat4 model = cameras[cameraID].model;
 	vec4 vertexCS = vec4(texture(vertexTexture, vScreenPos).xyz, 1.0);
     vec4 vertex = model * vertexCS;
 	
@@ -38,6 +39,9 @@ void main()
 	
 	FragColor = vec4(0.0, 0.0, 0.0, 0.0);
 	for(int projectorID = 0; projectorID < PROJECTOR_COUNT; ++projectorID){
+		if(projectorID >= projectorCount)
+			continue;
+
 		int shadowed = 0;
 		int total = 0;
 	
@@ -51,14 +55,14 @@ void main()
 					continue;
 				
 				vec4 samplePS = projectors[projectorID].view * sampleWS;
-				vec4 sampleProjected = projectors[projectorID].projection * samplePS;
+				vec4 sampleProjected = distanceMapProjection * samplePS;
 				vec2 samplePImageS = (sampleProjected).xy / sampleProjected.w * 0.5 + 0.5;
 				
 				if(samplePImageS.x < 0.0 || samplePImageS.x >= 1.0 || samplePImageS.y < 0.0 || samplePImageS.y >= 1.0){
 					continue;
 				}
 				
-				float dist = texture(projectors[projectorID].distanceMap, samplePImageS).x * 4;
+				float dist = texture(projectorDistanceMaps[projectorID], samplePImageS).x * 4;
 				
 				if(dist < length(samplePS.xyz) - 0.1)
 					++shadowed;
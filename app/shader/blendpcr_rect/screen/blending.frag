@@ -2,7 +2,10 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Specialized by the application for the active camera count:
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 3
+#endif
 
 #define MAX_SHADOW_TILES 50
 
@@ -20,14 +23,14 @@ uniform bool ignoreShadowAvoidance;
 uniform int shadowTileCount;
 uniform ShadowTile shadowTiles[MAX_SHADOW_TILES];
 
-uniform sampler2D color[CAMERA_NUM];
-uniform sampler2D vertices[CAMERA_NUM];
-uniform sampler2D normals[CAMERA_NUM];
-uniform sampler2D depth[CAMERA_NUM];
+// One layer per camera:
+uniform sampler2DArray color;
+uniform sampler2DArray vertices;
+uniform sampler2DArray normals;
+uniform sampler2DArray depth;
 
-uniform sampler2D miniWeightsA;
-
-uniform bool isCameraActive[CAMERA_NUM];
+// Camera parameters (cameras[i].isActive):
+#include "../../cameraBlock.shader"
 
 uniform usampler2D texture2D_segmentID;
 uniform sampler2D texture2D_ui;
@@ -89,15 +92,10 @@ void main()
 
     float lastDistToCam = 10000;
  
-    float smoothBlend[4];
-    vec4 miniWValueA = texture(miniWeightsA, vScreenPos).rgba;
-
-	//miniWValueA = vec4(0.0, 0.0, 1.0, 0.0);
-
     for(int i=0; i < CAMERA_NUM; ++i){
-        if(isCameraActive[i]){
-            vec3 currentVertex = texture(vertices[i], vScreenPos).xyz;
-            vec2 blendFactors = vec2(texture(vertices[i], vScreenPos).a, texture(normals[i], vScreenPos).a);
+        if(cameras[i].isActive != 0){
+            vec3 currentVertex = texture(vertices, vec3(vScreenPos, i)).xyz;
+            vec2 blendFactors = vec2(texture(vertices, vec3(vScreenPos, i)).a, texture(normals, vec3(vScreenPos, i)).a);
 
             float currentAlpha = blendFactors.x * 0.1 + blendFactors.y;
 
@@ -117,9 +115,9 @@ void main()
                 continue;
             }
 
-            vec3 currentNormal = texture(normals[i], vScreenPos).xyz;
-            vec3 currentColor = texture(color[i], vScreenPos).rgb;
-            float currentDepth = texture(depth[i], vScreenPos).r;
+            vec3 currentNormal = texture(normals, vec3(vScreenPos, i)).xyz;
+            vec3 currentColor = texture(color, vec3(vScreenPos, i)).rgb;
+            float currentDepth = texture(depth, vec3(vScreenPos, i)).r;
 
             sumProjectorWeight += currentColor.r * currentAlpha;
 			sumVertex += currentVertex * currentAlpha;
@@ -0,0 +1,21 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+// RGBD camera parameters shared by all shaders, filled by SceneUniforms (the
+// std140 layout has to match CameraBlock in SceneUniforms.h).
+
+#ifndef CAMERA_BLOCK_SHADER
+#define CAMERA_BLOCK_SHADER
+
+#define UNIFORM_BLOCK_MAX_CAMERAS 8
+
+struct CameraParameters {
+	mat4 model;        // camera to world space
+	mat4 view;         // inverse of the model matrix
+	int isActive;      // 'active' is a reserved word in GLSL
+};
+
+layout(std140) uniform CameraBlock {
+	CameraParameters cameras[UNIFORM_BLOCK_MAX_CAMERAS];
+};
+
+#endif
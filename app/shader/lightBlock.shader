@@ -0,0 +1,22 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+// Point lights shared by all shaders, filled by SceneUniforms (the std140
+// layout has to match LightBlock in SceneUniforms.h).
+
+#ifndef LIGHT_BLOCK_SHADER
+#define LIGHT_BLOCK_SHADER
+
+#define UNIFORM_BLOCK_MAX_LIGHTS 10
+
+struct LightParameters {
+	vec4 position;     // in world space
+	vec4 color;
+	float range;
+};
+
+layout(std140) uniform LightBlock {
+	LightParameters lights[UNIFORM_BLOCK_MAX_LIGHTS];
+	int lightCount;
+};
+
+#endif
@@ -10,18 +10,11 @@ uniform bool useMaterialColorTexture = false;
 /** The shininess of the mesh: */
 uniform float shininess = 0;
 
-// Structure for point lights:
-struct Light {
-    vec4 position;
-	float range;
-    vec4 color;
-};
+// Point lights (in world space) and their count:
+#include "lightBlock.shader"
 
-// Predefined point lights:
-uniform Light lights[10];
-
-// Number of lights that should actually be used:
-uniform int light_num = 0;
+// Transforms the lights into camera space:
+uniform mat4 view;
 
 /**
  * Blinn-Phong-Lightingmodel implementation.
@@ -40,16 +33,18 @@ vec4 calculateLight(vec4 albedoColor) {
     vec3 I_out_temp = vec3(0.0);
     vec3 normal = normalize(normal_from_vs);
 
-    for (int j = 0; j < light_num; j++){
-        Light light = lights[j];
+    for (int j = 0; j < lightCount; j++){
+        LightParameters light = lights[j];
+        vec3 lightPosition = (view * light.position).xyz;
+
         // Distance from light:
-        float dist = distance(light.position.xyz, position_from_vs.xyz);
+        float dist = distance(lightPosition, position_from_vs.xyz);
 
         // Skip if out of the lights range:
         if (dist >= light.range) continue;
 
         // Diffuse light:
-        vec3 l_j = normalize(light.position.xyz - position_from_vs.xyz);
+        vec3 l_j = normalize(lightPosition - position_from_vs.xyz);
         float lightMax = max(0.0, dot(normal, l_j));
 
         // Specular light:
@@ -21,23 +21,15 @@ in vec4 position_from_vs_ws;
 
 /* -- Projectors -- */
 
-// Structure for projector:
-struct Projector {
-	bool is_active; // 'active' is a reserved word in GLSL
-    mat4 model;
-	mat4 invModel;
-	mat4 projectionMatrix;
-};
+// Projector parameters (projectors, projectorCount):
+#include "projectorBlock.shader"
 
 // Projected images (Unfortunately can not be stored in the struct):
-uniform sampler2D images[5];
+uniform sampler2D images[UNIFORM_BLOCK_MAX_PROJECTORS];
 
 // ProjectingIntensity (for all projectors the same):
 uniform float projectingIntensity;
 
-uniform int proj_num;
-uniform Projector projectors[5];
-
 /** The color of the mesh: */
 uniform vec4 color = vec4(1.0);
 
@@ -86,15 +78,15 @@ void main() {
 	// Local projector direction in 2D:
 	const vec2 dirX2D = vec2(1.0, 0.0);
 
-	for (int i = 0; i < proj_num; i++) {
-		Projector projector = projectors[i];
+	for (int i = 0; i < projectorCount; i++) {
+		ProjectorParameters projector = projectors[i];
 
-		if (!projector.is_active) continue;
+		if (projector.isActive == 0) continue;
 
 		vec4 proj_origin = projector.model[3];
 		vec4 ray_to_point = normalize(position_from_vs_ws - proj_origin);
 		
-		vec4 point_proj_space = projector.projectionMatrix * projector.invModel * position_from_vs_ws;
+		vec4 point_proj_space = projector.projection * projector.view * position_from_vs_ws;
 
 		vec3 point_ndc = point_proj_space.xyz / point_proj_space.w;
 
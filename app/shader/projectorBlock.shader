@@ -0,0 +1,25 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+// Projector parameters shared by all shaders, filled by SceneUniforms (the
+// std140 layout has to match ProjectorBlock in SceneUniforms.h).
+
+#ifndef PROJECTOR_BLOCK_SHADER
+#define PROJECTOR_BLOCK_SHADER
+
+#define UNIFORM_BLOCK_MAX_PROJECTORS 5
+
+struct ProjectorParameters {
+	mat4 projection;
+	mat4 view;         // inverse of the model matrix
+	mat4 model;
+	vec4 position;
+	vec4 direction;    // viewing direction in world space
+	int isActive;      // 'active' is a reserved word in GLSL
+};
+
+layout(std140) uniform ProjectorBlock {
+	ProjectorParameters projectors[UNIFORM_BLOCK_MAX_PROJECTORS];
+	int projectorCount;
+};
+
+#endif
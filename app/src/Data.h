@@ -92,6 +92,12 @@ struct Data {
     /** Simulate RGBD noise */
     bool simulateRGBDNoise = false;
 
+    /** Simulate the RGBD cameras by raycasting on the CPU (off the render thread) instead of rendering */
+    bool raycastRGBDSimulation = false;
+
+    /** Duration of the last raycasted frame (all cameras) in ms */
+    float raycastRGBDFrameMs = 0.f;
+
     /** UI selection of camera */
     int selectedRGBDCamera = -1;
 
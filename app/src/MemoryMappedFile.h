@@ -0,0 +1,136 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps a whole file read-only into memory (Windows & POSIX), so that large
+ * recordings or lookup tables can be accessed without reading them first.
+ */
+class MemoryMappedFile {
+    const uint8_t* mappedData = nullptr;
+    size_t mappedSize = 0;
+
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+public:
+    MemoryMappedFile() {}
+
+    MemoryMappedFile(const std::string& path){
+        open(path);
+    }
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    ~MemoryMappedFile(){
+        close();
+    }
+
+    /** Maps the given file. Returns false if it could not be opened. */
+    bool open(const std::string& path){
+        close();
+
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(fileHandle == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0){
+            close();
+            return false;
+        }
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mappingHandle == nullptr){
+            close();
+            return false;
+        }
+
+        mappedData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        mappedSize = size_t(fileSize.QuadPart);
+#else
+        fileDescriptor = ::open(path.c_str(), O_RDONLY);
+        if(fileDescriptor < 0)
+            return false;
+
+        struct stat fileStat;
+        if(fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0){
+            close();
+            return false;
+        }
+
+        void* data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        if(data != MAP_FAILED){
+            mappedData = static_cast<const uint8_t*>(data);
+            mappedSize = size_t(fileStat.st_size);
+        }
+#endif
+
+        if(mappedData == nullptr){
+            std::cerr << "Could not map file " << path << " into memory." << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close(){
+#ifdef _WIN32
+        if(mappedData != nullptr)
+            UnmapViewOfFile(mappedData);
+        if(mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+        if(fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if(mappedData != nullptr)
+            munmap(const_cast<uint8_t*>(mappedData), mappedSize);
+        if(fileDescriptor >= 0)
+            ::close(fileDescriptor);
+
+        fileDescriptor = -1;
+#endif
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+
+    bool isOpen() const {
+        return mappedData != nullptr;
+    }
+
+    const uint8_t* data() const {
+        return mappedData;
+    }
+
+    size_t size() const {
+        return mappedSize;
+    }
+};
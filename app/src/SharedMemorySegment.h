@@ -0,0 +1,188 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A named shared memory segment (POSIX shm_open / Windows file mapping), which
+ * is mapped read-write so that several processes can exchange data without
+ * copying it through a pipe or socket.
+ *
+ * The creating process owns the name: on POSIX it is unlinked when the owner
+ * closes the segment. Processes which still have it mapped keep their mapping
+ * until they close it.
+ */
+class SharedMemorySegment {
+    uint8_t* mappedData = nullptr;
+    size_t mappedSize = 0;
+    std::string segmentName;
+    bool owner = false;
+
+#ifdef _WIN32
+    HANDLE mappingHandle = nullptr;
+
+    static std::string systemName(const std::string& name){
+        return "Local\\" + name;
+    }
+#else
+    int fileDescriptor = -1;
+
+    static std::string systemName(const std::string& name){
+        return "/" + name;
+    }
+#endif
+
+public:
+    SharedMemorySegment() {}
+
+    SharedMemorySegment(const SharedMemorySegment&) = delete;
+    SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+    ~SharedMemorySegment(){
+        close();
+    }
+
+    /**
+     * Creates the segment with the given size (zero-initialized). An existing
+     * segment of the same name is replaced.
+     */
+    bool create(const std::string& name, size_t size){
+        close();
+
+#ifdef _WIN32
+        mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(uint64_t(size) >> 32), DWORD(size & 0xFFFFFFFFu), systemName(name).c_str());
+        if(mappingHandle == nullptr){
+            std::cerr << "Could not create shared memory " << name << std::endl;
+            return false;
+        }
+
+        // The segment still exists if a reader has it open, so it is reused (and cleared):
+        bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+
+        mappedData = static_cast<uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        if(mappedData != nullptr && existed)
+            std::memset(mappedData, 0, size);
+#else
+        shm_unlink(systemName(name).c_str());
+
+        fileDescriptor = shm_open(systemName(name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fileDescriptor < 0 || ftruncate(fileDescriptor, off_t(size)) != 0){
+            std::cerr << "Could not create shared memory " << name << std::endl;
+            shm_unlink(systemName(name).c_str());
+            close();
+            return false;
+        }
+
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if(data != MAP_FAILED)
+            mappedData = static_cast<uint8_t*>(data);
+#endif
+
+        segmentName = name;
+        owner = true;
+
+        if(mappedData == nullptr){
+            std::cerr << "Could not map shared memory " << name << std::endl;
+            close();
+            return false;
+        }
+        mappedSize = size;
+        return true;
+    }
+
+    /** Maps an existing segment (completely). Returns false if there is none. */
+    bool open(const std::string& name){
+        close();
+
+#ifdef _WIN32
+        mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName(name).c_str());
+        if(mappingHandle == nullptr)
+            return false;
+
+        mappedData = static_cast<uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+
+        MEMORY_BASIC_INFORMATION info;
+        if(mappedData != nullptr && VirtualQuery(mappedData, &info, sizeof(info)) != 0)
+            mappedSize = info.RegionSize;
+#else
+        fileDescriptor = shm_open(systemName(name).c_str(), O_RDWR, 0600);
+        if(fileDescriptor < 0)
+            return false;
+
+        struct stat segmentStat;
+        if(fstat(fileDescriptor, &segmentStat) != 0 || segmentStat.st_size == 0){
+            close();
+            return false;
+        }
+
+        void* data = mmap(nullptr, size_t(segmentStat.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if(data != MAP_FAILED){
+            mappedData = static_cast<uint8_t*>(data);
+            mappedSize = size_t(segmentStat.st_size);
+        }
+#endif
+
+        segmentName = name;
+        owner = false;
+
+        if(mappedData == nullptr){
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close(){
+#ifdef _WIN32
+        if(mappedData != nullptr)
+            UnmapViewOfFile(mappedData);
+        if(mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+
+        mappingHandle = nullptr;
+#else
+        if(mappedData != nullptr)
+            munmap(mappedData, mappedSize);
+        if(fileDescriptor >= 0)
+            ::close(fileDescriptor);
+        if(owner)
+            shm_unlink(systemName(segmentName).c_str());
+
+        fileDescriptor = -1;
+#endif
+        mappedData = nullptr;
+        mappedSize = 0;
+        owner = false;
+    }
+
+    bool isOpen() const {
+        return mappedData != nullptr;
+    }
+
+    uint8_t* data() const {
+        return mappedData;
+    }
+
+    size_t size() const {
+        return mappedSize;
+    }
+};
@@ -0,0 +1,154 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A simple pool of worker threads for CPU-side processing.
+ *
+ * Tasks can be enqueued fire-and-forget, and parallelFor splits an index range
+ * into chunks which are processed by the workers and the calling thread. Since
+ * the calling thread works on the chunks itself, parallelFor may also be
+ * called from within a task of the same pool.
+ */
+class WorkerPool {
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+
+    void workerLoop(){
+        while(true){
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this]{ return stopping || !tasks.empty(); });
+
+                if(tasks.empty())
+                    return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    /** Shared state of one parallelFor call */
+    struct ParallelJob {
+        std::function<void(int begin, int end)> function;
+        int end;
+        int chunkSize;
+        std::atomic<int> nextBegin;
+        std::atomic<int> remainingChunks;
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+
+        /** Processes chunks until none are left */
+        void work(){
+            while(true){
+                int begin = nextBegin.fetch_add(chunkSize);
+                if(begin >= end)
+                    return;
+
+                function(begin, std::min(end, begin + chunkSize));
+
+                if(remainingChunks.fetch_sub(1) == 1){
+                    std::unique_lock lock(doneMutex);
+                    doneCondition.notify_all();
+                }
+            }
+        }
+    };
+
+public:
+    /** Creates a pool with the given number of threads (0: one per hardware thread - 1) */
+    WorkerPool(unsigned int threadCount = 0){
+        if(threadCount == 0){
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        for(unsigned int i = 0; i < threadCount; ++i)
+            threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+
+    ~WorkerPool(){
+        {
+            std::unique_lock lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+
+        for(std::thread& thread : threads)
+            thread.join();
+    }
+
+    /** Pool shared by the whole application */
+    static WorkerPool& getInstance(){
+        static WorkerPool pool;
+        return pool;
+    }
+
+    unsigned int getThreadCount() const {
+        return unsigned(threads.size());
+    }
+
+    /** Executes the task on one of the workers */
+    void enqueue(std::function<void()> task){
+        {
+            std::unique_lock lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        condition.notify_one();
+    }
+
+    /**
+     * Calls function(begin, end) for consecutive chunks of [begin, end) in
+     * parallel and returns when all chunks are done.
+     */
+    void parallelForChunks(int begin, int end, int chunkSize, std::function<void(int begin, int end)> function){
+        if(end <= begin)
+            return;
+
+        chunkSize = std::max(1, chunkSize);
+        int chunkCount = (end - begin + chunkSize - 1) / chunkSize;
+
+        std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+        job->function = std::move(function);
+        job->end = end;
+        job->chunkSize = chunkSize;
+        job->nextBegin = begin;
+        job->remainingChunks = chunkCount;
+
+        int helpers = std::min<int>(chunkCount - 1, int(threads.size()));
+        for(int i = 0; i < helpers; ++i)
+            enqueue([job]{ job->work(); });
+
+        job->work();
+
+        std::unique_lock lock(job->doneMutex);
+        job->doneCondition.wait(lock, [&job]{ return job->remainingChunks.load() == 0; });
+    }
+
+    /** Calls function(i) for every i in [begin, end) in parallel */
+    void parallelFor(int begin, int end, std::function<void(int i)> function){
+        int chunkSize = std::max(1, (end - begin) / int(4 * (threads.size() + 1)));
+        parallelForChunks(begin, end, chunkSize, [&function](int chunkBegin, int chunkEnd){
+            for(int i = chunkBegin; i < chunkEnd; ++i)
+                function(i);
+        });
+    }
+};
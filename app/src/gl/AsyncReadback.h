@@ -0,0 +1,178 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * Reads textures back from the GPU without stalling the pipeline.
+ *
+ * read() copies the texture into a pixel pack buffer (which the driver does
+ * asynchronously) and inserts a fence. poll() is called once per frame and
+ * delivers every readback whose fence has signaled to its callback, in
+ * request order, typically one or two frames later. If a readback is still
+ * not finished after maxLatencyFrames, poll() waits for it to bound the
+ * latency and the number of buffers in flight.
+ *
+ * The pack buffers are recycled by size. Must only be used from the OpenGL
+ * thread.
+ */
+class AsyncReadback {
+public:
+    typedef std::function<void(const void* data, size_t size)> Callback;
+
+    struct Statistics {
+        size_t pending = 0;
+        size_t delivered = 0;
+
+        /** Readbacks for which poll() had to wait (exceeded maxLatencyFrames) */
+        size_t forcedWaits = 0;
+
+        /** Pack buffers allocated (in flight + free) */
+        size_t buffers = 0;
+    };
+
+    /** Frames after which poll() waits for an unfinished readback */
+    int maxLatencyFrames = 3;
+
+private:
+    struct PackBuffer {
+        GLuint name = 0;
+        size_t size = 0;
+    };
+
+    struct Request {
+        PackBuffer buffer;
+        GLsync fence = nullptr;
+        uint64_t frame = 0;
+        Callback callback;
+    };
+
+    std::deque<Request> pending;
+    std::vector<PackBuffer> freeBuffers;
+
+    uint64_t frame = 0;
+    size_t delivered = 0;
+    size_t forcedWaits = 0;
+    size_t allocatedBuffers = 0;
+
+    PackBuffer acquireBuffer(size_t size){
+        for(size_t i = 0; i < freeBuffers.size(); ++i){
+            if(freeBuffers[i].size == size){
+                PackBuffer buffer = freeBuffers[i];
+                freeBuffers.erase(freeBuffers.begin() + i);
+                return buffer;
+            }
+        }
+
+        PackBuffer buffer;
+        buffer.size = size;
+        glGenBuffers(1, &buffer.name);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.name);
+        glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(size), nullptr, GL_STREAM_READ);
+        ++allocatedBuffers;
+        return buffer;
+    }
+
+    void deliver(Request& request){
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, request.buffer.name);
+        const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(request.buffer.size), GL_MAP_READ_BIT);
+        if(data != nullptr){
+            request.callback(data, request.buffer.size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            std::cerr << "AsyncReadback: Could not map pack buffer." << std::endl;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glDeleteSync(request.fence);
+        freeBuffers.push_back(request.buffer);
+        ++delivered;
+    }
+
+public:
+    static AsyncReadback& getInstance(){
+        static AsyncReadback readback;
+        return readback;
+    }
+
+    /**
+     * Starts reading the given mip level of the texture. The callback receives
+     * width * height * bytesPerPixel bytes (rows tightly packed) in a later poll().
+     */
+    void read(GLuint texture, GLint level, GLenum format, GLenum type, size_t size, Callback callback){
+        Request request;
+        request.buffer = acquireBuffer(size);
+        request.frame = frame;
+        request.callback = std::move(callback);
+
+        GLint previousPackAlignment;
+        glGetIntegerv(GL_PACK_ALIGNMENT, &previousPackAlignment);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, request.buffer.name);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexImage(GL_TEXTURE_2D, level, format, type, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, previousPackAlignment);
+
+        request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pending.push_back(std::move(request));
+    }
+
+    /** Delivers all finished readbacks (call once per frame) */
+    void poll(){
+        while(!pending.empty()){
+            Request& request = pending.front();
+
+            GLenum state = glClientWaitSync(request.fence, 0, 0);
+            if(state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED){
+                if(frame - request.frame < uint64_t(maxLatencyFrames))
+                    break;
+
+                // Too old, wait for it (one second at most):
+                ++forcedWaits;
+                state = glClientWaitSync(request.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+                if(state == GL_TIMEOUT_EXPIRED || state == GL_WAIT_FAILED){
+                    std::cerr << "AsyncReadback: Readback did not finish in time." << std::endl;
+                    break;
+                }
+            }
+
+            Request finished = std::move(request);
+            pending.pop_front();
+            deliver(finished);
+        }
+
+        ++frame;
+    }
+
+    Statistics getStatistics() const {
+        Statistics statistics;
+        statistics.pending = pending.size();
+        statistics.delivered = delivered;
+        statistics.forcedWaits = forcedWaits;
+        statistics.buffers = allocatedBuffers;
+        return statistics;
+    }
+
+    /** Drops pending readbacks and deletes all buffers (before the context is destroyed) */
+    void release(){
+        for(Request& request : pending){
+            glDeleteSync(request.fence);
+            glDeleteBuffers(1, &request.buffer.name);
+        }
+        for(PackBuffer& buffer : freeBuffers)
+            glDeleteBuffers(1, &buffer.name);
+
+        pending.clear();
+        freeBuffers.clear();
+        allocatedBuffers = 0;
+    }
+};
@@ -0,0 +1,188 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// Not part of the OpenGL 3.3 core profile loaded by glad (OpenGL 4.3 / ARB_compute_shader):
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#endif
+#ifndef GL_TEXTURE_FETCH_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#endif
+#ifndef GL_TEXTURE_UPDATE_BARRIER_BIT
+#define GL_TEXTURE_UPDATE_BARRIER_BIT 0x00000100
+#endif
+#ifndef GL_FRAMEBUFFER_BARRIER_BIT
+#define GL_FRAMEBUFFER_BARRIER_BIT 0x00000400
+#endif
+
+/**
+ * A compute shader program (requires OpenGL 4.3 or ARB_compute_shader).
+ *
+ * The context is created as OpenGL 3.3 core and glad only loads those
+ * functions, so the compute functions are fetched through GLFW. Check
+ * isSupported() before creating compute shaders; without support, callers
+ * keep using their fragment shader passes.
+ *
+ * Image units are bound with bindImage() and declared with explicit
+ * layout(binding = N) in the shader, samplers are set with setUniform like
+ * in Shader. Must only be used from the OpenGL thread.
+ */
+class ComputeShader {
+    typedef void (APIENTRYP DispatchComputeFunction)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+    typedef void (APIENTRYP BindImageTextureFunction)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
+    typedef void (APIENTRYP MemoryBarrierFunction)(GLbitfield barriers);
+
+    struct Functions {
+        DispatchComputeFunction dispatchCompute = nullptr;
+        BindImageTextureFunction bindImageTexture = nullptr;
+        MemoryBarrierFunction memoryBarrier = nullptr;
+    };
+
+    static const Functions& getFunctions(){
+        static Functions functions = [](){
+            Functions loaded;
+
+            GLint major = 0, minor = 0;
+            glGetIntegerv(GL_MAJOR_VERSION, &major);
+            glGetIntegerv(GL_MINOR_VERSION, &minor);
+            bool supported = major > 4 || (major == 4 && minor >= 3);
+
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for(GLint i = 0; i < extensionCount && !supported; ++i){
+                const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, GLuint(i)));
+                supported = extension != nullptr && std::strcmp(extension, "GL_ARB_compute_shader") == 0;
+            }
+
+            if(supported){
+                loaded.dispatchCompute = reinterpret_cast<DispatchComputeFunction>(glfwGetProcAddress("glDispatchCompute"));
+                loaded.bindImageTexture = reinterpret_cast<BindImageTextureFunction>(glfwGetProcAddress("glBindImageTexture"));
+                loaded.memoryBarrier = reinterpret_cast<MemoryBarrierFunction>(glfwGetProcAddress("glMemoryBarrier"));
+            }
+            return loaded;
+        }();
+        return functions;
+    }
+
+    unsigned int shaderProgram = 0;
+    std::string path;
+
+public:
+    /** Is set to true in the constructor if compiling and linking worked */
+    bool initialized = false;
+
+    /** Whether the context supports compute shaders (and image load / store) */
+    static bool isSupported(){
+        const Functions& functions = getFunctions();
+        return functions.dispatchCompute != nullptr && functions.bindImageTexture != nullptr && functions.memoryBarrier != nullptr;
+    }
+
+    /**
+     * Compiles the compute shader. The defines are inserted after the
+     * #version line (e.g. to set the tile size).
+     */
+    ComputeShader(const std::string& path, const std::map<std::string, std::string>& defines = {})
+        : path(path)
+    {
+        if(!isSupported())
+            return;
+
+        std::ifstream ifs(path);
+        std::string sourceCode(std::istreambuf_iterator<char>{ifs}, {});
+        if(sourceCode.empty()){
+            std::cout << "Compute Shader not found: " << path << std::endl;
+            return;
+        }
+
+        std::string defineLines;
+        for(const auto& [name, value] : defines)
+            defineLines += "#define " + name + " " + value + "\n";
+
+        size_t versionPosition = sourceCode.find("#version");
+        size_t lineEnd = versionPosition == std::string::npos ? std::string::npos : sourceCode.find('\n', versionPosition);
+        sourceCode.insert(lineEnd == std::string::npos ? 0 : lineEnd + 1, defineLines);
+
+        const char* source = sourceCode.c_str();
+        unsigned int computeShader = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(computeShader, 1, &source, nullptr);
+        glCompileShader(computeShader);
+
+        int success;
+        glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+        if(!success){
+            char infoLog[1024];
+            glGetShaderInfoLog(computeShader, 1024, nullptr, infoLog);
+            std::cout << "Compute Shader Compilation failed:\n" << "File: " << path << infoLog << std::endl;
+            glDeleteShader(computeShader);
+            return;
+        }
+
+        shaderProgram = glCreateProgram();
+        glAttachShader(shaderProgram, computeShader);
+        glLinkProgram(shaderProgram);
+        glDeleteShader(computeShader);
+
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        if(!success){
+            char infoLog[1024];
+            glGetProgramInfoLog(shaderProgram, 1024, nullptr, infoLog);
+            std::cout << "Compute Shader Linking failed:\n" << "File: " << path << infoLog << std::endl;
+            return;
+        }
+
+        initialized = true;
+    }
+
+    ComputeShader(const ComputeShader&) = delete;
+    ComputeShader& operator=(const ComputeShader&) = delete;
+
+    ~ComputeShader(){
+        if(shaderProgram != 0)
+            glDeleteProgram(shaderProgram);
+    }
+
+    void bind(){
+        glUseProgram(shaderProgram);
+    }
+
+    void setUniform(const std::string& name, int value){
+        int loc = glGetUniformLocation(shaderProgram, name.c_str());
+        if(loc != -1)
+            glUniform1i(loc, value);
+    }
+
+    void setUniform(const std::string& name, float value){
+        int loc = glGetUniformLocation(shaderProgram, name.c_str());
+        if(loc != -1)
+            glUniform1f(loc, value);
+    }
+
+    /** Binds level 0 of the texture to the image unit (access: GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE) */
+    static void bindImage(unsigned int unit, unsigned int texture, GLenum access, GLenum format){
+        getFunctions().bindImageTexture(unit, texture, 0, GL_FALSE, 0, access, format);
+    }
+
+    /** Runs the bound shader with the given number of work groups */
+    static void dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ = 1){
+        getFunctions().dispatchCompute(groupsX, groupsY, groupsZ);
+    }
+
+    /** Makes image stores visible to the following commands of the given kind (GL_*_BARRIER_BIT) */
+    static void memoryBarrier(GLbitfield barriers){
+        getFunctions().memoryBarrier(barriers);
+    }
+};
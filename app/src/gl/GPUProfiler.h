@@ -0,0 +1,375 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * Measures the GPU time of named, nestable scopes (passes) in every frame
+ * with timestamp queries.
+ *
+ * The queries of a frame are read back FRAME_LATENCY frames later, when they
+ * are available (the profiler never waits for the GPU; frames whose queries
+ * are still pending when their slot is reused are dropped). For every pass
+ * the GPU time of the last HISTORY_FRAMES frames is kept (summed if the pass
+ * runs several times per frame), from which the statistics, the timeline in
+ * the GUI and the CSV export are computed.
+ *
+ * Calls outside of beginFrame() / endFrame() are ignored. Must only be used
+ * from the OpenGL thread.
+ */
+class GPUProfiler {
+public:
+    /** Frames whose queries may be in flight */
+    static constexpr int FRAME_LATENCY = 4;
+
+    /** Frames of which the pass times are kept */
+    static constexpr int HISTORY_FRAMES = 300;
+
+    struct PassStatistics {
+        std::string name;
+
+        /** Nesting depth at the first measurement (0 = top level) */
+        int depth = 0;
+
+        /** Over the frames of the history in which the pass ran (ms) */
+        float meanMs = 0.f;
+        float p50Ms = 0.f;
+        float p95Ms = 0.f;
+        float maxMs = 0.f;
+        size_t samples = 0;
+    };
+
+    /** Measures the enclosing block */
+    class Scope {
+    public:
+        Scope(const char* name){
+            GPUProfiler::getInstance().begin(name);
+        }
+
+        ~Scope(){
+            GPUProfiler::getInstance().end();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    struct ScopeRecord {
+        int pass;
+        GLuint beginQuery;
+        GLuint endQuery = 0;
+    };
+
+    struct Frame {
+        std::vector<GLuint> queries;
+        size_t usedQueries = 0;
+
+        GLuint beginQuery = 0;
+        GLuint endQuery = 0;
+        std::vector<ScopeRecord> scopes;
+        bool pending = false;
+    };
+
+    struct Pass {
+        std::string name;
+        int depth;
+
+        /** GPU time per frame (ms, ring buffer), NaN if the pass did not run */
+        std::vector<float> history;
+    };
+
+    Frame frames[FRAME_LATENCY];
+    int currentFrame = 0;
+    bool inFrame = false;
+
+    /** Indices (into the scopes of the current frame) of the open scopes, -1 for ignored ones */
+    std::vector<int> openScopes;
+
+    std::vector<Pass> passes;
+    std::map<std::string, int> passIndices;
+
+    /** GPU time from beginFrame() to endFrame() (ms, ring buffer) */
+    std::vector<float> frameHistory = std::vector<float>(HISTORY_FRAMES, std::numeric_limits<float>::quiet_NaN());
+
+    /** Frames written into the history (the next one is written at collectedFrames % HISTORY_FRAMES) */
+    size_t collectedFrames = 0;
+    size_t droppedFrames = 0;
+
+    GLuint allocateQuery(Frame& frame){
+        if(frame.usedQueries == frame.queries.size()){
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            frame.queries.push_back(query);
+        }
+        return frame.queries[frame.usedQueries++];
+    }
+
+    int getPassIndex(const std::string& name, int depth){
+        auto it = passIndices.find(name);
+        if(it != passIndices.end())
+            return it->second;
+
+        passes.push_back(Pass{name, depth, std::vector<float>(HISTORY_FRAMES, std::numeric_limits<float>::quiet_NaN())});
+        passIndices[name] = int(passes.size()) - 1;
+        return int(passes.size()) - 1;
+    }
+
+    static bool isAvailable(GLuint query){
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available != 0;
+    }
+
+    static float elapsedMs(GLuint beginQuery, GLuint endQuery){
+        GLuint64 beginNs = 0, endNs = 0;
+        glGetQueryObjectui64v(beginQuery, GL_QUERY_RESULT, &beginNs);
+        glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &endNs);
+        return float(double(endNs - beginNs) / 1000000.0);
+    }
+
+    /** Writes the pass times of the frame into the history if all its queries are available */
+    bool collect(Frame& frame){
+        for(size_t i = 0; i < frame.usedQueries; ++i){
+            if(!isAvailable(frame.queries[i]))
+                return false;
+        }
+
+        size_t slot = collectedFrames % HISTORY_FRAMES;
+        for(Pass& pass : passes)
+            pass.history[slot] = std::numeric_limits<float>::quiet_NaN();
+
+        for(const ScopeRecord& scope : frame.scopes){
+            float& time = passes[scope.pass].history[slot];
+            time = (std::isnan(time) ? 0.f : time) + elapsedMs(scope.beginQuery, scope.endQuery);
+        }
+        frameHistory[slot] = elapsedMs(frame.beginQuery, frame.endQuery);
+
+        ++collectedFrames;
+        frame.pending = false;
+        return true;
+    }
+
+    std::vector<float> orderedHistory(const std::vector<float>& ring) const {
+        std::vector<float> history;
+        size_t count = std::min<size_t>(collectedFrames, HISTORY_FRAMES);
+        for(size_t i = 0; i < count; ++i)
+            history.push_back(ring[(collectedFrames - count + i) % HISTORY_FRAMES]);
+        return history;
+    }
+
+    static PassStatistics computeStatistics(const std::vector<float>& history){
+        std::vector<float> times;
+        for(float time : history){
+            if(!std::isnan(time))
+                times.push_back(time);
+        }
+
+        PassStatistics statistics;
+        statistics.samples = times.size();
+        if(times.empty())
+            return statistics;
+
+        std::sort(times.begin(), times.end());
+        double sum = 0.0;
+        for(float time : times)
+            sum += time;
+
+        statistics.meanMs = float(sum / times.size());
+        statistics.p50Ms = times[times.size() / 2];
+        statistics.p95Ms = times[std::min(times.size() - 1, times.size() * 95 / 100)];
+        statistics.maxMs = times.back();
+        return statistics;
+    }
+
+public:
+    bool enabled = true;
+
+    static GPUProfiler& getInstance(){
+        static GPUProfiler profiler;
+        return profiler;
+    }
+
+    /** Collects the finished frames and starts measuring a new one */
+    void beginFrame(){
+        // The previous frame was not ended:
+        if(inFrame)
+            endFrame();
+
+        // Oldest frames first, so that the history stays in order:
+        for(int i = 0; i < FRAME_LATENCY; ++i){
+            Frame& frame = frames[(currentFrame + i) % FRAME_LATENCY];
+            if(frame.pending && !collect(frame))
+                break;
+        }
+
+        if(!enabled)
+            return;
+
+        Frame& frame = frames[currentFrame];
+        if(frame.pending){
+            frame.pending = false;
+            ++droppedFrames;
+        }
+
+        frame.usedQueries = 0;
+        frame.scopes.clear();
+        frame.beginQuery = allocateQuery(frame);
+        glQueryCounter(frame.beginQuery, GL_TIMESTAMP);
+
+        openScopes.clear();
+        inFrame = true;
+    }
+
+    /** Ends the frame (closing scopes which were not ended) */
+    void endFrame(){
+        if(!inFrame)
+            return;
+
+        while(!openScopes.empty())
+            end();
+
+        Frame& frame = frames[currentFrame];
+        frame.endQuery = allocateQuery(frame);
+        glQueryCounter(frame.endQuery, GL_TIMESTAMP);
+        frame.pending = true;
+
+        currentFrame = (currentFrame + 1) % FRAME_LATENCY;
+        inFrame = false;
+    }
+
+    /** Starts measuring the pass (the name identifies it over the frames) */
+    void begin(const std::string& name){
+        if(!inFrame){
+            openScopes.push_back(-1);
+            return;
+        }
+
+        Frame& frame = frames[currentFrame];
+        ScopeRecord scope{getPassIndex(name, int(openScopes.size())), allocateQuery(frame)};
+        glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+
+        frame.scopes.push_back(scope);
+        openScopes.push_back(int(frame.scopes.size()) - 1);
+    }
+
+    void end(){
+        if(openScopes.empty())
+            return;
+
+        int scopeIndex = openScopes.back();
+        openScopes.pop_back();
+        if(scopeIndex < 0 || !inFrame)
+            return;
+
+        Frame& frame = frames[currentFrame];
+        ScopeRecord& scope = frame.scopes[scopeIndex];
+        scope.endQuery = allocateQuery(frame);
+        glQueryCounter(scope.endQuery, GL_TIMESTAMP);
+    }
+
+    /** Passes in the order of their first measurement (nested passes follow their parents) */
+    std::vector<std::string> getPassNames() const {
+        std::vector<std::string> names;
+        for(const Pass& pass : passes)
+            names.push_back(pass.name);
+        return names;
+    }
+
+    int getPassDepth(const std::string& name) const {
+        auto it = passIndices.find(name);
+        return it != passIndices.end() ? passes[it->second].depth : -1;
+    }
+
+    /** GPU times of the pass in the last frames (oldest first, ms), NaN in frames without the pass */
+    std::vector<float> getHistory(const std::string& name) const {
+        auto it = passIndices.find(name);
+        return it != passIndices.end() ? orderedHistory(passes[it->second].history) : std::vector<float>();
+    }
+
+    /** GPU time of the whole frames (oldest first, ms) */
+    std::vector<float> getFrameHistory() const {
+        return orderedHistory(frameHistory);
+    }
+
+    PassStatistics getStatistics(const std::string& name) const {
+        auto it = passIndices.find(name);
+        if(it == passIndices.end())
+            return PassStatistics();
+
+        PassStatistics statistics = computeStatistics(passes[it->second].history);
+        statistics.name = name;
+        statistics.depth = passes[it->second].depth;
+        return statistics;
+    }
+
+    /** Mean GPU time of the pass over the history (ms, 0 if it was not measured) */
+    float getMeanMs(const std::string& name) const {
+        return getStatistics(name).meanMs;
+    }
+
+    PassStatistics getFrameStatistics() const {
+        PassStatistics statistics = computeStatistics(frameHistory);
+        statistics.name = "Frame";
+        return statistics;
+    }
+
+    size_t getDroppedFrames() const {
+        return droppedFrames;
+    }
+
+    /** Clears the history (the passes stay known) */
+    void clear(){
+        for(Pass& pass : passes)
+            std::fill(pass.history.begin(), pass.history.end(), std::numeric_limits<float>::quiet_NaN());
+        std::fill(frameHistory.begin(), frameHistory.end(), std::numeric_limits<float>::quiet_NaN());
+        collectedFrames = 0;
+        droppedFrames = 0;
+    }
+
+    /** Writes the statistics of the whole frame and of every pass */
+    bool writeCSV(const std::string& filename) const {
+        std::ofstream file(filename);
+        if(!file){
+            std::cerr << "Could not write GPU profile CSV " << filename << std::endl;
+            return false;
+        }
+
+        file << "pass,depth,samples,meanMs,p50Ms,p95Ms,maxMs\n";
+
+        std::vector<PassStatistics> statistics = { getFrameStatistics() };
+        statistics.front().depth = -1;
+        for(const Pass& pass : passes)
+            statistics.push_back(getStatistics(pass.name));
+
+        for(const PassStatistics& pass : statistics){
+            file << "\"" << pass.name << "\"," << pass.depth << "," << pass.samples << "," << pass.meanMs << ","
+                 << pass.p50Ms << "," << pass.p95Ms << "," << pass.maxMs << "\n";
+        }
+
+        std::cout << "Wrote GPU statistics of " << passes.size() << " passes to " << filename << std::endl;
+        return true;
+    }
+
+    /** Deletes the queries (before the context is destroyed) */
+    void release(){
+        for(Frame& frame : frames){
+            if(!frame.queries.empty())
+                glDeleteQueries(GLsizei(frame.queries.size()), frame.queries.data());
+            frame = Frame();
+        }
+
+        openScopes.clear();
+        inFrame = false;
+    }
+};
@@ -0,0 +1,205 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// Not part of the OpenGL 3.3 core profile loaded by glad (ARB_buffer_storage / OpenGL 4.4):
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+/**
+ * Uploads textures through a ring of pixel unpack buffers, so that
+ * glTexSubImage2D does not copy from client memory on the render thread.
+ *
+ * map() returns the memory of the next buffer, the caller writes the pixels
+ * into it, bind()s the buffer and issues the texture uploads with offsets into
+ * the buffer, which the driver then copies asynchronously. commit() fences the
+ * buffer; it is only written again once the fence has signaled, so the CPU
+ * never overwrites data the GPU still reads.
+ *
+ * If ARB_buffer_storage is available, the buffers are mapped persistently
+ * (and coherently) once. Otherwise they are mapped unsynchronized in every
+ * frame, which is safe for the same reason. Must only be used from the
+ * OpenGL thread.
+ */
+class PixelUploadRing {
+public:
+    /** Number of buffers: one is written while up to two are still read by the GPU */
+    static constexpr int SLOT_COUNT = 3;
+
+    struct Statistics {
+        size_t uploads = 0;
+
+        /** Uploads for which map() had to wait for the GPU */
+        size_t fenceWaits = 0;
+    };
+
+private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+
+        /** Mapped memory if the buffer is mapped persistently */
+        uint8_t* persistentData = nullptr;
+    };
+
+    typedef void (APIENTRYP BufferStorageFunction)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+    Slot slots[SLOT_COUNT];
+    size_t slotSize = 0;
+    int currentSlot = 0;
+    uint8_t* mappedData = nullptr;
+
+    size_t uploads = 0;
+    size_t fenceWaits = 0;
+
+    /** Returns glBufferStorage if the context supports it (otherwise nullptr) */
+    static BufferStorageFunction getBufferStorage(){
+        static BufferStorageFunction bufferStorage = [](){
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+            for(GLint i = 0; i < extensionCount; ++i){
+                const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, GLuint(i)));
+                if(extension != nullptr && std::strcmp(extension, "GL_ARB_buffer_storage") == 0)
+                    return reinterpret_cast<BufferStorageFunction>(glfwGetProcAddress("glBufferStorage"));
+            }
+            return BufferStorageFunction(nullptr);
+        }();
+        return bufferStorage;
+    }
+
+public:
+    /** Whether the buffers are mapped persistently (requires ARB_buffer_storage) */
+    static bool isPersistentMappingSupported(){
+        return getBufferStorage() != nullptr;
+    }
+
+    /** (Re)creates the buffers, each with the given size in bytes */
+    void init(size_t size){
+        release();
+
+        BufferStorageFunction bufferStorage = getBufferStorage();
+        for(Slot& slot : slots){
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+
+            if(bufferStorage != nullptr){
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                bufferStorage(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(size), nullptr, flags);
+                slot.persistentData = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(size), flags));
+
+                if(slot.persistentData == nullptr)
+                    std::cerr << "PixelUploadRing: Could not map unpack buffer persistently." << std::endl;
+            } else {
+                glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(size), nullptr, GL_STREAM_DRAW);
+            }
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slotSize = size;
+        currentSlot = 0;
+    }
+
+    bool isInitialized() const {
+        return slotSize > 0;
+    }
+
+    size_t size() const {
+        return slotSize;
+    }
+
+    /**
+     * Returns the memory of the next buffer (size() bytes, write only), after
+     * waiting until the GPU has read its previous content. Returns nullptr if
+     * the buffer could not be mapped.
+     */
+    uint8_t* map(){
+        if(!isInitialized())
+            return nullptr;
+
+        Slot& slot = slots[currentSlot];
+        if(slot.fence != nullptr){
+            GLenum state = glClientWaitSync(slot.fence, 0, 0);
+            if(state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED){
+                ++fenceWaits;
+                state = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+                if(state == GL_TIMEOUT_EXPIRED || state == GL_WAIT_FAILED){
+                    std::cerr << "PixelUploadRing: Upload did not finish in time." << std::endl;
+                    return nullptr;
+                }
+            }
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+
+        if(slot.persistentData != nullptr){
+            mappedData = slot.persistentData;
+        } else {
+            // The fence guarantees that the GPU is done with the buffer, so no implicit synchronization is needed:
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+            mappedData = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(slotSize),
+                                                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        return mappedData;
+    }
+
+    /**
+     * Binds the mapped buffer as GL_PIXEL_UNPACK_BUFFER (the pointers passed to
+     * glTexSubImage2D become offsets into it). Returns false if its content
+     * was lost while it was mapped.
+     */
+    bool bind(){
+        Slot& slot = slots[currentSlot];
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+
+        bool valid = true;
+        if(slot.persistentData == nullptr && mappedData != nullptr)
+            valid = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+
+        mappedData = nullptr;
+        return valid;
+    }
+
+    /** Fences the buffer after the texture uploads reading it were issued and moves on to the next one */
+    void commit(){
+        Slot& slot = slots[currentSlot];
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        currentSlot = (currentSlot + 1) % SLOT_COUNT;
+        ++uploads;
+    }
+
+    Statistics getStatistics() const {
+        Statistics statistics;
+        statistics.uploads = uploads;
+        statistics.fenceWaits = fenceWaits;
+        return statistics;
+    }
+
+    /** Deletes the buffers (before the context is destroyed) */
+    void release(){
+        for(Slot& slot : slots){
+            if(slot.fence != nullptr)
+                glDeleteSync(slot.fence);
+            if(slot.buffer != 0)
+                glDeleteBuffers(1, &slot.buffer);
+
+            slot = Slot();
+        }
+
+        slotSize = 0;
+        mappedData = nullptr;
+    }
+};
@@ -10,8 +10,9 @@
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
 
-Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShaderPath)
-    : numOfCopies(new int(1)){
+Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShaderPath, std::map<std::string, std::string> defines)
+    : defines(defines)
+    , numOfCopies(new int(1)){
 
     createShaderProgram(vertexShaderPath, fragmentShaderPath, geometryShaderPath);
 }
@@ -27,6 +28,8 @@ Shader::Shader(const Shader& shader){
     shaderProgram = shader.shaderProgram;
     numOfCopies = shader.numOfCopies;
     initialized = shader.initialized;
+    defines = shader.defines;
+    uniformBlockBindings = shader.uniformBlockBindings;
     uniformLocationMap = shader.uniformLocationMap;
     ++(*numOfCopies);
 }
@@ -59,6 +62,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
     std::ifstream ifs(vertexShaderPath);
     std::string vertexShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
     processIncludes(vertexShaderSourceString);
+    processDefines(vertexShaderSourceString);
     const char* vertexShaderSource = vertexShaderSourceString.c_str();
     ifs.close();
 
@@ -68,6 +72,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
     ifs = std::ifstream(fragmentShaderPath);
     std::string fragmentShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
     processIncludes(fragmentShaderSourceString);
+    processDefines(fragmentShaderSourceString);
     const char* fragmentShaderSource = fragmentShaderSourceString.c_str();
     ifs.close();
 
@@ -115,6 +120,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
         ifs = std::ifstream(geometryShaderPath);
         std::string geometryShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
         processIncludes(geometryShaderSourceString);
+        processDefines(geometryShaderSourceString);
         const char* geometryShaderSource = geometryShaderSourceString.c_str();
         ifs.close();
 
@@ -166,6 +172,10 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
 
     if (success)
         initialized = true;
+
+    // Blocks of a reloaded program have to be connected again:
+    for(const auto& [blockName, bindingPoint] : uniformBlockBindings)
+        applyUniformBlockBinding(blockName, bindingPoint);
 }
 
 void Shader::processIncludes(std::string& sourceCode) {
@@ -192,6 +202,28 @@ void Shader::processIncludes(std::string& sourceCode) {
     }
 }
 
+void Shader::processDefines(std::string& sourceCode) {
+    if(defines.empty())
+        return;
+
+    std::string defineLines;
+    for(const auto& [name, value] : defines)
+        defineLines += "#define " + name + " " + value + "\n";
+
+    // The #version directive has to stay the first statement:
+    size_t versionPosition = sourceCode.find("#version");
+    size_t insertPosition = 0;
+    if(versionPosition != std::string::npos){
+        size_t lineEnd = sourceCode.find('\n', versionPosition);
+        insertPosition = lineEnd == std::string::npos ? sourceCode.length() : lineEnd + 1;
+    }
+
+    if(insertPosition > 0 && sourceCode[insertPosition - 1] != '\n')
+        defineLines = "\n" + defineLines;
+
+    sourceCode.insert(insertPosition, defineLines);
+}
+
 void Shader::hotReloadCheck() {
     // Check all shader files for changes:
     for (ShaderFile& shaderFile : shaderFiles) {
@@ -272,3 +304,23 @@ void Shader::setUniform(std::string name, int value){
     if(loc != -1)
         glUniform1i(loc, value);
 }
+
+void Shader::applyUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint){
+    if(!initialized)
+        return;
+
+    unsigned int blockIndex = glGetUniformBlockIndex(shaderProgram, blockName.c_str());
+
+    // If the uniform block exists, connect it to the binding point:
+    if(blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(shaderProgram, blockIndex, bindingPoint);
+}
+
+void Shader::setUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint){
+    auto it = uniformBlockBindings.find(blockName);
+    if(it != uniformBlockBindings.end() && it->second == bindingPoint)
+        return;
+
+    uniformBlockBindings[blockName] = bindingPoint;
+    applyUniformBlockBinding(blockName, bindingPoint);
+}
@@ -11,6 +11,7 @@
 
 // Include string:
 #include <string>
+#include <map>
 #include <unordered_map>
 
 // Include Mat4f (and Vec4f):
@@ -34,6 +35,18 @@ private:
 
     std::vector<ShaderFile> shaderFiles;
 
+    /** Defines injected after the #version line of every stage (kept for hot reloading) */
+    std::map<std::string, std::string> defines;
+
+    /** Binding points of the uniform blocks (applied again after hot reloading) */
+    std::map<std::string, unsigned int> uniformBlockBindings;
+
+    /**
+     * Connects the uniform block to the binding point in the current program
+     * (if the program uses the block).
+     */
+    void applyUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint);
+
     /**
      * Checks if any of the files have been changed and should be reloaded.
      */
@@ -49,6 +62,12 @@ private:
      */
     void processIncludes(std::string& sourceCode);
 
+    /**
+     * Inserts a '#define NAME VALUE' line for each define after the #version line,
+     * so that shaders can be specialized (e.g. for the number of cameras).
+     */
+    void processDefines(std::string& sourceCode);
+
 public:
     /** Stores the ID of the shader program on the GPU */
     unsigned int shaderProgram;
@@ -86,8 +105,11 @@ public:
      * In recent OpenGL versions, it is also possible to compile shaders
      * before hand (so they don't have to be compiled every time you
      * start a game, but that's another topic ;-)).
+     *
+     * The defines are added to every stage and take precedence over
+     * defaults in the shader which are guarded with #ifndef.
      */
-    Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShader = "");
+    Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShader = "", std::map<std::string, std::string> defines = {});
 
     /**
      * Explicit copy constructor for reference counting (for correct
@@ -125,4 +147,10 @@ public:
      * Sets a uniform variable of type int.
      */
     void setUniform(std::string name, int value);
+
+    /**
+     * Connects the uniform block to the binding point of a uniform buffer
+     * (only queried once per block, so it can be called on every use).
+     */
+    void setUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint);
 };
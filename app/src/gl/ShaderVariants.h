@@ -0,0 +1,40 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "src/gl/Shader.h"
+
+/**
+ * Variants of one shader program which differ in the value of a single
+ * define (e.g. CAMERA_NUM), so that arrays and loops in the shader are sized
+ * for the value currently in use. Each variant is compiled on first use and
+ * kept afterwards.
+ *
+ * Must only be used from the OpenGL thread.
+ */
+class ShaderVariants {
+    std::string vertexShaderPath;
+    std::string fragmentShaderPath;
+    std::string define;
+
+    std::map<int, std::shared_ptr<Shader>> variants;
+
+public:
+    ShaderVariants(std::string vertexShaderPath, std::string fragmentShaderPath, std::string define)
+        : vertexShaderPath(vertexShaderPath)
+        , fragmentShaderPath(fragmentShaderPath)
+        , define(define)
+    {}
+
+    /** Returns the shader compiled with '#define <define> <value>' */
+    Shader& get(int value){
+        std::shared_ptr<Shader>& shader = variants[value];
+        if(shader == nullptr)
+            shader = std::make_shared<Shader>(vertexShaderPath, fragmentShaderPath, "", std::map<std::string, std::string>{{define, std::to_string(value)}});
+        return *shader;
+    }
+};
@@ -0,0 +1,61 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstring>
+
+// Include OpenGL3.3 Core functions:
+#include <glad/glad.h>
+
+/**
+ * A persistent uniform buffer object holding one block of type T, whose
+ * memory layout has to match the std140 layout of the uniform block in the
+ * shaders (padding members included).
+ *
+ * The buffer is created on the first upload and afterwards only updated with
+ * glBufferSubData, and only if the content changed since the last upload.
+ * It is bound to a fixed binding point, to which the shaders connect their
+ * block with Shader::setUniformBlockBinding.
+ */
+template<typename T>
+class UniformBuffer {
+    unsigned int ubo = 0;
+    unsigned int bindingPoint = 0;
+
+    /** Content of the buffer on the GPU */
+    T uploaded;
+
+public:
+    UniformBuffer(unsigned int bindingPoint)
+        : bindingPoint(bindingPoint){}
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    /** Copies the block into the buffer (if it changed) and binds the buffer to its binding point */
+    void upload(const T& block){
+        if(ubo == 0){
+            glGenBuffers(1, &ubo);
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(T), &block, GL_DYNAMIC_DRAW);
+        } else if(std::memcmp(&uploaded, &block, sizeof(T)) != 0){
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &block);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        std::memcpy(&uploaded, &block, sizeof(T));
+        glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ubo);
+    }
+
+    unsigned int getBindingPoint() const {
+        return bindingPoint;
+    }
+
+    /** Deletes the buffer (before the context is destroyed) */
+    void release(){
+        if(ubo != 0)
+            glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+};
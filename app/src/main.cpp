@@ -29,6 +29,13 @@
 #include "src/simulation/util/PostProcessing.h"
 
 #include "src/processing/blendpcr/BlendPCRRenderer.h"
+#include "src/processing/LatencyTracer.h"
+#include "src/simulation/raycast/RaycastRGBDSimulator.h"
+#include "src/gl/AsyncReadback.h"
+#include "src/gl/GPUProfiler.h"
+#include "src/simulation/scene/SceneUniforms.h"
+#include "src/simulation/util/CameraScalingBenchmark.h"
+#include "src/processing/devices/sharedmemory/SharedMemoryCaptureDaemon.h"
 
 #include <implot.h>
 
@@ -42,6 +49,9 @@
 // Function declaration. This function will handle calculating the frame time and passing it to data:
 void calculateTime(const double& startTime, const double& prevTime);
 
+// Function declaration. This function will upload the projector parameters to their uniform block:
+void uploadProjectorUniforms();
+
 /*
 void glErrorDebugCallback(const char *name, void *funcptr, int len_args, ...) {
     GLenum error_code;
@@ -55,8 +65,15 @@ void glErrorDebugCallback(const char *name, void *funcptr, int len_args, ...) {
 /**
  * Initializes the application including the GUI.
  */
-int main(int, char**)
+int main(int argc, char** argv)
 {
+    // Capture only, without a window (the renderer receives the point clouds with --shared-memory):
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--capture-daemon") {
+            return SharedMemoryCaptureDaemon().run();
+        }
+    }
+
     // Initialize the context manager and thus also the main window, OpenGL, ImGui, and related resources.
     GLFWwindow* mainWindow = ContextManager::initialize();
     if (!mainWindow) {
@@ -77,6 +94,9 @@ int main(int, char**)
 
     ImGuiContext* mainImGuiContext = ImGui::GetCurrentContext();
 
+    // ImPlot context of the main GUI (e.g. latency histograms):
+    ImPlotContext* mainImPlotContext = ImPlot::CreateContext();
+
     ImGuiContext* uiRendererImGuiContext = ImGui::CreateContext();
     ImPlotContext* uiRendererImPlotContext = ImPlot::CreateContext();
     ImGui::SetCurrentContext(uiRendererImGuiContext);
@@ -101,17 +121,10 @@ int main(int, char**)
     // Post-processing:
     PostProcessing pProcessing;
 
-    // Ensure PCTextureProcessor is instanciated (this must be instanciated in the OpenGL thread,
-    // since shaders are loaded. This function is also called NOT within the OpenGL thread
-    // when new point clouds are available, so by calling it here, we ensure early correct instanciation:
+    // Ensure CameraPasses is instanciated in the OpenGL thread (since shaders are loaded). It takes
+    // the latest point clouds from the camera manager in every glTick:
     CameraPasses::getInstance();
 
-
-    // Register CameraPasses as Callback, so that it can manage the point clouds:
-    Data::instance.cameraManager.registerCallback([](int deviceIndex, std::shared_ptr<OrganizedPointCloud> pc){
-        CameraPasses::getInstance().insertNewPointCloud(deviceIndex, pc);
-    });
-
     BlendPCRRenderer blendPCRRenderer;
 
 #ifdef USE_CUDA
@@ -127,28 +140,97 @@ int main(int, char**)
     double startTime = glfwGetTime();
 
     ImGuiIO& io = ImGui::GetIO(); (void)io;
+
+    // Runs the simulated cameras from 1 to 8 and reports the frame times (see --benchmark-cameras):
+    CameraScalingBenchmark cameraScalingBenchmark;
+    int cameraScalingBenchmarkFrames = 0;
+
+    // Command line: --replay <file.rgbdrec> [--replay-fast] [--record <file.rgbdrec>] [--benchmark-cameras [frames]] [--shared-memory]
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            bool fast = false;
+            for (int j = 1; j < argc; ++j)
+                fast |= std::string(argv[j]) == "--replay-fast";
+
+            Data::instance.cameraManager.openRecording(argv[++i], fast ? RecordedCamera::PACING_AS_FAST_AS_POSSIBLE : RecordedCamera::PACING_REALTIME);
+        } else if (arg == "--shared-memory") {
+            Data::instance.cameraManager.openSharedMemory();
+        } else if (arg == "--record" && i + 1 < argc) {
+            Data::instance.cameraManager.startRecording(argv[++i]);
+        } else if (arg == "--benchmark-cameras") {
+            cameraScalingBenchmarkFrames = 200;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+                cameraScalingBenchmarkFrames = std::atoi(argv[++i]);
+        }
+    }
+
     Data::instance.cameraManager.load();
 
+    if (cameraScalingBenchmarkFrames > 0 && !cameraScalingBenchmark.start(cameraScalingBenchmarkFrames))
+        return EXIT_FAILURE;
+
+    // CPU raycasting alternative to VirtualRGBDCamera::renderRGBD (scene is loaded on first use):
+    RaycastRGBDSimulator raycastSimulator;
+    RaycastRGBDSimulator::Settings raycastSettings;
+    int raycastProjectionPlane = -1;
+
     // Main loop which is executed every frame until the window is closed:
     while (!glfwWindowShouldClose(mainWindow)) {
         double prevTime = glfwGetTime();
 
+        // Collects the GPU times of earlier frames (never waits for the GPU):
+        GPUProfiler::getInstance().beginFrame();
+
+        // The projector parameters of all passes of this frame (only uploaded if they changed):
+        uploadProjectorUniforms();
+
         auto start = high_resolution_clock::now();
 
-        if(Data::instance.cameraManager.requiresSimulatedRGBDData()){
-            std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+        bool raycastRGBDData = Data::instance.cameraManager.requiresSimulatedRGBDData() && Data::instance.raycastRGBDSimulation;
+
+        // Stop the raycasting thread first, so that only one thread delivers the simulated data:
+        if(!raycastRGBDData)
+            raycastSimulator.stop();
+
+        if(raycastRGBDData){
+            if(raycastProjectionPlane < 0)
+                raycastProjectionPlane = raycastSettings.scene.addObj(CMAKE_SOURCE_DIR "/models/projection-plane/ProjectionPlane.obj");
+
+            if(raycastProjectionPlane >= 0){
+                Vec4f posOffset = Data::instance.projectionPlanePositionOffset;
+                raycastSettings.scene.setModelMatrix(raycastProjectionPlane, Mat4f::translation(posOffset.x, posOffset.y, posOffset.z));
+                raycastSettings.scene.instances[raycastProjectionPlane].visible = Data::instance.isProjectionPlaneInScene;
+            }
+
+            raycastSettings.cameraPoses.clear();
+            for (const std::shared_ptr<VirtualRGBDCamera>& rgbdCam : Data::instance.rgbdCameras) {
+                if (rgbdCam->active)
+                    raycastSettings.cameraPoses.push_back(rgbdCam->transformation);
+            }
+            raycastSettings.simulateNoise = Data::instance.simulateRGBDNoise;
+
+            raycastSimulator.update(raycastSettings);
+            raycastSimulator.start([](int cameraIndex, std::shared_ptr<OrganizedPointCloud> pc){
+                Data::instance.cameraManager.simulatedPointCloudCallback(cameraIndex, pc);
+            });
+            Data::instance.raycastRGBDFrameMs = raycastSimulator.getLastFrameMs();
+        } else if(Data::instance.cameraManager.requiresSimulatedRGBDData()){
+            // The point clouds arrive via AsyncReadback in one of the next frames:
+            int cameraIndex = 0;
             for (const std::shared_ptr<VirtualRGBDCamera>& rgbdCam : Data::instance.rgbdCameras) {
                 if (!rgbdCam->active)
                     continue;
 
-                rgbdCam->renderRGBD(scene);
-                pointClouds.push_back(rgbdCam->getOrganizedPointCloud());
-            }
-
-            for(int i=0; i < pointClouds.size(); ++i){
-                Data::instance.cameraManager.pointCloudCallback(i, pointClouds[i]);
+                rgbdCam->renderRGBD(scene, [cameraIndex](std::shared_ptr<OrganizedPointCloud> pc){
+                    Data::instance.cameraManager.simulatedPointCloudCallback(cameraIndex, pc);
+                });
+                ++cameraIndex;
             }
         }
+
+        // Deliver finished GPU readbacks (simulated point clouds, auto exposure):
+        AsyncReadback::getInstance().poll();
         //glFlush();
 
         // Render UI:
@@ -156,6 +238,7 @@ int main(int, char**)
         ImPlot::SetCurrentContext(uiRendererImPlotContext);
         uiRenderer->render(0.f, 0.f, false);
         ImGui::SetCurrentContext(mainImGuiContext);
+        ImPlot::SetCurrentContext(mainImPlotContext);
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         // Set up the GL viewport:
@@ -208,17 +291,34 @@ int main(int, char**)
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             // GL Tick (e.g. uploading new point clouds, etc.):
-            CameraPasses::getInstance().glTick();
-            rectifiedProjection->shadowAvoidance->glTick();
+            cameraScalingBenchmark.beginSection(CameraScalingBenchmark::SECTION_CAMERA_PASSES);
+            {
+                GPUProfiler::Scope profilerScope("Camera Passes");
+                CameraPasses::getInstance().glTick();
+            }
+            {
+                GPUProfiler::Scope profilerScope("Shadow Avoidance");
+                rectifiedProjection->shadowAvoidance->glTick();
+            }
+            cameraScalingBenchmark.endSection(CameraScalingBenchmark::SECTION_CAMERA_PASSES);
 
-            // Prepare scene data:
-            scene.prepare(sceneData, Mat4f());
+            // Prepare scene data (renders the projector images):
+            {
+                GPUProfiler::Scope profilerScope("Scene Prepare");
+                scene.prepare(sceneData, Mat4f());
+            }
 
             // Render the scene:
-            scene.render(sceneData, Mat4f());
+            {
+                GPUProfiler::Scope profilerScope("Scene");
+                scene.render(sceneData, Mat4f());
+            }
 
             if(Data::instance.renderRawPointCloud){
+                GPUProfiler::Scope profilerScope("Raw Point Cloud");
+                cameraScalingBenchmark.beginSection(CameraScalingBenchmark::SECTION_SCREEN_PASSES);
                 blendPCRRenderer.render(sceneData.projection, sceneData.view);
+                cameraScalingBenchmark.endSection(CameraScalingBenchmark::SECTION_SCREEN_PASSES);
             }
 
             Vec4f targetPos = Data::instance.virtualDisplaySpectator;
@@ -256,7 +356,10 @@ int main(int, char**)
 
         // Render the GUI and draw it to the screen:
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            GPUProfiler::Scope profilerScope("GUI");
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows.
         // Platform functions may change the current OpenGL context, so we save/restore it to make it easier to paste this code elsewhere:
@@ -267,12 +370,23 @@ int main(int, char**)
             glfwMakeContextCurrent(backupCurrentContext);
         }
 
+        GPUProfiler::getInstance().endFrame();
         calculateTime(startTime, prevTime);
 
         // Swap Buffers:
         glfwSwapBuffers(mainWindow);
+        LatencyTracer::getInstance().frameSwapped();
+
+        // Quit after the camera scaling benchmark:
+        if (cameraScalingBenchmark.endFrame())
+            glfwSetWindowShouldClose(mainWindow, GLFW_TRUE);
     }
 
+    raycastSimulator.stop();
+    AsyncReadback::getInstance().release();
+    GPUProfiler::getInstance().release();
+    SceneUniforms::getInstance().release();
+
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -295,3 +409,23 @@ void calculateTime(const double& startTime, const double& prevTime) {
     Data::instance.timingFrame = Data::instance.timingFrame * 0.9f + frameDuration * 0.1f;
     Data::instance.runtime = static_cast<float>(nowTime - startTime);
 }
+
+void uploadProjectorUniforms() {
+    ProjectorBlock block;
+    block.projectorCount = std::min(static_cast<int>(Data::instance.projectors.size()), UNIFORM_BLOCK_MAX_PROJECTORS);
+
+    for (int i = 0; i < block.projectorCount; ++i) {
+        const std::shared_ptr<Projector>& projector = Data::instance.projectors[i];
+        ProjectorParameters& parameters = block.projectors[i];
+
+        // Assumes that projector parentModel is identity!
+        parameters.model = projector->transformation;
+        parameters.view = projector->transformation.inverse();
+        parameters.projection = projector->projectionMatrix;
+        parameters.position = projector->transformation.getPosition();
+        parameters.direction = projector->transformation * Vec4f(0, 0, 1, 0);
+        parameters.isActive = projector->active ? 1 : 0;
+    }
+
+    SceneUniforms::getInstance().uploadProjectors(block);
+}
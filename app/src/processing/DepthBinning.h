@@ -0,0 +1,271 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "src/processing/OrganizedPointCloud.h"
+#include "src/WorkerPool.h"
+
+enum DepthBinningMode {
+    DEPTH_BINNING_OFF = 0,
+
+    /** Lower median of the valid depths of each 2x2 block (at least two valid) */
+    DEPTH_BINNING_MEDIAN = 1,
+
+    /** Nearest valid depth of each 2x2 block */
+    DEPTH_BINNING_MIN = 2
+};
+
+/**
+ * Bins the depth image of a camera 2x2 in software (e.g. 640x576 -> 320x288),
+ * so that all per-camera passes (CameraPasses, ShadowAvoidance, Rectification)
+ * run on a quarter of the pixels.
+ *
+ * Invalid depth (0) is ignored when binning. For an even number of valid
+ * depths the median takes the nearer one, so that no depth between two
+ * surfaces is invented at edges. The color of a block is the average of the
+ * pixels on the binned surface.
+ *
+ * The decimated lookup tables are created once per source table (one instance
+ * per device, see RGBDCameraManager). A new source table gets new decimated
+ * tables, the binned point clouds keep the ones they were created with.
+ */
+class DepthBinning {
+    std::mutex mutex;
+
+    const float* sourceLookupImageTo3D = nullptr;
+    const float* sourceLookup3DToImage = nullptr;
+    const ColorToDepthMapper* sourceColorToDepthMapper = nullptr;
+
+    /** Camera of the source tables (a reconnected camera may get its tables at the same addresses) */
+    std::weak_ptr<RGBDCamera> sourceCamera;
+
+    std::shared_ptr<const std::vector<float>> lookupImageTo3D;
+    std::shared_ptr<const std::vector<float>> lookup3DToImage;
+    std::shared_ptr<ColorToDepthMapper> colorToDepthMapper;
+
+    static inline uint16_t binDepth(uint16_t a, uint16_t b, uint16_t c, uint16_t d, DepthBinningMode mode, int& validMask){
+        uint16_t values[4] = {a, b, c, d};
+        uint16_t valid[4];
+        int count = 0;
+        validMask = 0;
+        for(int i = 0; i < 4; ++i){
+            if(values[i] != 0){
+                valid[count++] = values[i];
+                validMask |= 1 << i;
+            }
+        }
+
+        if(count == 0)
+            return 0;
+
+        if(mode == DEPTH_BINNING_MIN)
+            return *std::min_element(valid, valid + count);
+
+        // Insertion sort (at most four values):
+        for(int i = 1; i < count; ++i){
+            uint16_t value = valid[i];
+            int j = i - 1;
+            for(; j >= 0 && valid[j] > value; --j)
+                valid[j + 1] = valid[j];
+            valid[j + 1] = value;
+        }
+
+        // A single valid depth in a block is mostly noise at the border of holes:
+        if(count == 1){
+            validMask = 0;
+            return 0;
+        }
+
+        return valid[(count - 1) / 2];
+    }
+
+public:
+    /** Bins depth (width x height) into binnedDepth ((width/2) x (height/2)) */
+    static void binDepthImage(const uint16_t* depth, int width, int height, DepthBinningMode mode, uint16_t* binnedDepth){
+        const int binnedWidth = width / 2;
+        const int binnedHeight = height / 2;
+
+        for(int y = 0; y < binnedHeight; ++y){
+            const uint16_t* row0 = depth + size_t(y * 2) * width;
+            const uint16_t* row1 = row0 + width;
+            for(int x = 0; x < binnedWidth; ++x){
+                int validMask;
+                binnedDepth[y * binnedWidth + x] = binDepth(row0[x*2], row0[x*2+1], row1[x*2], row1[x*2+1], mode, validMask);
+            }
+        }
+    }
+
+    /**
+     * Bins depth and colors (rows in parallel on the WorkerPool); the color of
+     * a block is averaged over the pixels which contributed valid depth (all
+     * four if the block is invalid).
+     */
+    static void binImages(const uint16_t* depth, const Vec4b* colors, int width, int height, DepthBinningMode mode, uint16_t* binnedDepth, Vec4b* binnedColors){
+        const int binnedWidth = width / 2;
+        const int binnedHeight = height / 2;
+
+        WorkerPool::getInstance().parallelForChunks(0, binnedHeight, 16, [&](int rowBegin, int rowEnd){
+            for(int y = rowBegin; y < rowEnd; ++y){
+                const size_t i0 = size_t(y * 2) * width;
+                const size_t i1 = i0 + width;
+                for(int x = 0; x < binnedWidth; ++x){
+                    const size_t indices[4] = {i0 + x*2, i0 + x*2 + 1, i1 + x*2, i1 + x*2 + 1};
+
+                    int validMask;
+                    uint16_t binned = binDepth(depth[indices[0]], depth[indices[1]], depth[indices[2]], depth[indices[3]], mode, validMask);
+                    binnedDepth[y * binnedWidth + x] = binned;
+
+                    if(binnedColors == nullptr || colors == nullptr)
+                        continue;
+
+                    // Only average the colors of the pixels on the binned surface:
+                    int sum[4] = {0, 0, 0, 0};
+                    int count = 0;
+                    for(int i = 0; i < 4; ++i){
+                        bool used = validMask == 0 || ((validMask >> i & 1) && (mode != DEPTH_BINNING_MIN || depth[indices[i]] == binned));
+                        if(!used)
+                            continue;
+
+                        const uint8_t* c = &colors[indices[i]].x;
+                        for(int channel = 0; channel < 4; ++channel)
+                            sum[channel] += c[channel];
+                        ++count;
+                    }
+
+                    binnedColors[y * binnedWidth + x] = Vec4b(uint8_t(sum[0] / count), uint8_t(sum[1] / count), uint8_t(sum[2] / count), uint8_t(sum[3] / count));
+                }
+            }
+        });
+    }
+
+    /** Averages the rays of each 2x2 block of lookupImageTo3D (x/z, y/z per pixel) */
+    static void binLookupImageTo3D(const float* lookup, int width, int height, float* binnedLookup){
+        const int binnedWidth = width / 2;
+        const int binnedHeight = height / 2;
+
+        for(int y = 0; y < binnedHeight; ++y){
+            for(int x = 0; x < binnedWidth; ++x){
+                const float* r00 = lookup + (size_t(y * 2) * width + x * 2) * 2;
+                const float* r01 = r00 + size_t(width) * 2;
+                float* target = binnedLookup + (size_t(y) * binnedWidth + x) * 2;
+                target[0] = (r00[0] + r00[2] + r01[0] + r01[2]) * 0.25f;
+                target[1] = (r00[1] + r00[3] + r01[1] + r01[3]) * 0.25f;
+            }
+        }
+    }
+
+    /**
+     * Scales the image coordinates of lookup3DToImage (size x size) to the
+     * binned image. Entries outside the image (negative) are kept.
+     */
+    static void binLookup3DToImage(const float* lookup, unsigned int size, float* binnedLookup){
+        for(size_t i = 0; i < size_t(size) * size * 2; ++i)
+            binnedLookup[i] = lookup[i] < 0.f ? lookup[i] : lookup[i] * 0.5f;
+    }
+
+    /**
+     * Returns a new point cloud with the 2x2 binned depth and colors of source
+     * (the high res color image is copied). Returns source if the mode is
+     * off or the point cloud cannot be binned.
+     */
+    std::shared_ptr<OrganizedPointCloud> bin(std::shared_ptr<OrganizedPointCloud> source, DepthBinningMode mode){
+        if(mode == DEPTH_BINNING_OFF || source == nullptr || source->depth == nullptr || source->gpu)
+            return source;
+
+        const int width = int(source->width);
+        const int height = int(source->height);
+        const int binnedWidth = width / 2;
+        const int binnedHeight = height / 2;
+        const size_t binnedSize = size_t(binnedWidth) * binnedHeight;
+
+        std::unique_lock lock(mutex);
+
+        // Another camera (e.g. reconnected) gets new tables, even if the addresses of its tables are the same:
+        bool sameCamera = !sourceCamera.owner_before(source->cameraOwner) && !source->cameraOwner.owner_before(sourceCamera);
+        if(!sameCamera){
+            sourceLookupImageTo3D = nullptr;
+            sourceLookup3DToImage = nullptr;
+            sourceColorToDepthMapper = nullptr;
+            sourceCamera = source->cameraOwner;
+        }
+
+        // Decimated tables (only rebuilt when the camera delivers new ones; new vectors, since
+        // point clouds which are still in use keep pointers into the previous ones):
+        if(source->lookupImageTo3D != nullptr && source->lookupImageTo3D != sourceLookupImageTo3D){
+            std::shared_ptr<std::vector<float>> table = std::make_shared<std::vector<float>>(binnedSize * 2);
+            binLookupImageTo3D(source->lookupImageTo3D, width, height, table->data());
+            lookupImageTo3D = table;
+            sourceLookupImageTo3D = source->lookupImageTo3D;
+            sourceColorToDepthMapper = nullptr;
+        }
+        if(source->lookup3DToImage != nullptr && source->lookup3DToImage != sourceLookup3DToImage){
+            std::shared_ptr<std::vector<float>> table = std::make_shared<std::vector<float>>(size_t(source->lookup3DToImageSize) * source->lookup3DToImageSize * 2);
+            binLookup3DToImage(source->lookup3DToImage, source->lookup3DToImageSize, table->data());
+            lookup3DToImage = table;
+            sourceLookup3DToImage = source->lookup3DToImage;
+        }
+        if(source->colorToDepthMapper != nullptr && source->colorToDepthMapper.get() != sourceColorToDepthMapper && source->lookupImageTo3D != nullptr){
+            colorToDepthMapper = source->colorToDepthMapper->forDepthImage(binnedWidth, binnedHeight, lookupImageTo3D->data());
+            sourceColorToDepthMapper = source->colorToDepthMapper.get();
+        }
+
+        std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(binnedWidth, binnedHeight);
+        std::shared_ptr<FramePool> framePool = source->framePool;
+        pc->framePool = framePool;
+        pc->depth = framePool ? framePool->acquire<uint16_t>(binnedSize) : new uint16_t[binnedSize];
+        if(source->colors != nullptr)
+            pc->colors = framePool ? framePool->acquire<Vec4b>(binnedSize) : new Vec4b[binnedSize];
+
+        binImages(source->depth, source->colors, width, height, mode, pc->depth, pc->colors);
+
+        if(source->lookupImageTo3D != nullptr){
+            pc->lookupImageTo3D = const_cast<float*>(lookupImageTo3D->data());
+            pc->lookupImageTo3DStorage = lookupImageTo3D;
+        }
+        if(source->lookup3DToImage != nullptr){
+            pc->lookup3DToImage = const_cast<float*>(lookup3DToImage->data());
+            pc->lookup3DToImageStorage = lookup3DToImage;
+        }
+        pc->lookup3DToImageSize = source->lookup3DToImageSize;
+        pc->modelMatrix = source->modelMatrix;
+        pc->camAcceleration = source->camAcceleration;
+        pc->camera = source->camera;
+        pc->cameraOwner = source->cameraOwner;
+        pc->usageFlags = source->usageFlags;
+        pc->frameID = source->frameID;
+        pc->timestamp = source->timestamp;
+        pc->trace = source->trace;
+        pc->colorToDepth = source->colorToDepth;
+
+        // The high res color image and its rays do not depend on the depth resolution
+        // (copied, since the source may still be in use, e.g. by the recorder):
+        if(source->highResColors != nullptr){
+            size_t highResSize = size_t(source->highResWidth) * source->highResHeight * 3;
+            pc->highResColors = framePool ? framePool->acquire<uint8_t>(highResSize) : new uint8_t[highResSize];
+            std::memcpy(pc->highResColors, source->highResColors, highResSize);
+            pc->highResWidth = source->highResWidth;
+            pc->highResHeight = source->highResHeight;
+        }
+        pc->lookupHighResTo3D = source->lookupHighResTo3D;
+
+        if(source->colorToDepthMapper != nullptr && pc->lookupImageTo3D != nullptr){
+            pc->colorToDepthMapper = colorToDepthMapper;
+
+            std::weak_ptr<OrganizedPointCloud> weakPc = pc;
+            pc->highResColorToDepthTransformer = [weakPc](float x, float y){
+                if (auto pcLocked = weakPc.lock())
+                    return pcLocked->mapHighResColorToDepth(x, y);
+                return std::pair<float,float>(-1.f, -1.f);
+            };
+        }
+
+        return pc;
+    }
+};
@@ -0,0 +1,164 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Recycles the large per-frame arrays of a single camera (depth, colors, high
+ * res colors, ...), so that in steady state no new[] / delete[] is performed
+ * per frame anymore.
+ *
+ * Buffers are keyed by their size in bytes. An OrganizedPointCloud which holds
+ * a pointer to the pool returns its arrays here when it gets destroyed, which
+ * usually happens on the render thread while the camera thread acquires them.
+ */
+class FramePool {
+public:
+    struct Statistics {
+        /** Number of acquisitions which could reuse an unused buffer */
+        size_t hits = 0;
+
+        /** Number of acquisitions which required a new allocation */
+        size_t misses = 0;
+
+        /** Buffers currently handed out */
+        size_t outstandingBuffers = 0;
+
+        /** Maximum number of buffers that were handed out at the same time */
+        size_t highWaterBuffers = 0;
+
+        /** Maximum number of bytes that were handed out at the same time */
+        size_t highWaterBytes = 0;
+
+        /** Buffers currently kept for reuse */
+        size_t pooledBuffers = 0;
+    };
+
+private:
+    /** A buffer owned by the pool, either handed out or kept for reuse */
+    struct Slot {
+        uint8_t* buffer = nullptr;
+        size_t size = 0;
+        bool outstanding = false;
+    };
+
+    std::mutex mutex;
+
+    /**
+     * All buffers of the pool. A camera only uses a handful of buffers, so a
+     * linear search is cheaper than a map and (unlike map nodes) does not
+     * allocate per acquisition. The vector only grows when a new buffer is
+     * allocated anyway.
+     */
+    std::vector<Slot> slots;
+
+    size_t outstandingBytes = 0;
+
+    Statistics statistics;
+
+    /**
+     * Upper bound of unused buffers per size, so that a temporary congestion
+     * (e.g. a stalled render thread) does not keep its memory forever.
+     */
+    size_t maxUnusedBuffersPerSize;
+
+    void updateStatistics(){
+        statistics.outstandingBuffers = 0;
+        for(const Slot& slot : slots)
+            statistics.outstandingBuffers += slot.outstanding ? 1 : 0;
+
+        statistics.pooledBuffers = slots.size() - statistics.outstandingBuffers;
+        statistics.highWaterBuffers = std::max(statistics.highWaterBuffers, statistics.outstandingBuffers);
+        statistics.highWaterBytes = std::max(statistics.highWaterBytes, outstandingBytes);
+    }
+
+public:
+    FramePool(size_t maxUnusedBuffersPerSize = 8)
+        : maxUnusedBuffersPerSize(maxUnusedBuffersPerSize)
+    {
+        slots.reserve(64);
+    }
+
+    ~FramePool(){
+        // Point clouds keep the pool alive, so no buffer should be outstanding here:
+        for(Slot& slot : slots)
+            delete[] slot.buffer;
+    }
+
+    /** Returns an (uninitialized) array with count elements of type T. */
+    template<typename T>
+    T* acquire(size_t count){
+        return reinterpret_cast<T*>(acquireBytes(count * sizeof(T)));
+    }
+
+    /** Returns an (uninitialized) buffer of the given size in bytes. */
+    uint8_t* acquireBytes(size_t size){
+        std::unique_lock l(mutex);
+
+        Slot* reused = nullptr;
+        for(Slot& slot : slots){
+            if(!slot.outstanding && slot.size == size){
+                reused = &slot;
+                break;
+            }
+        }
+
+        if(reused != nullptr){
+            ++statistics.hits;
+        } else {
+            slots.push_back(Slot{new uint8_t[size], size, false});
+            reused = &slots.back();
+            ++statistics.misses;
+        }
+
+        reused->outstanding = true;
+        outstandingBytes += size;
+
+        updateStatistics();
+        return reused->buffer;
+    }
+
+    /**
+     * Gives a buffer back to the pool. Returns false if the buffer was not
+     * acquired from this pool (then the caller is still responsible for it).
+     */
+    bool release(void* pointer){
+        if(pointer == nullptr)
+            return false;
+
+        std::unique_lock l(mutex);
+
+        size_t index = 0;
+        while(index < slots.size() && !(slots[index].outstanding && slots[index].buffer == pointer))
+            ++index;
+
+        if(index == slots.size())
+            return false;
+
+        size_t size = slots[index].size;
+        slots[index].outstanding = false;
+        outstandingBytes -= size;
+
+        size_t unusedOfSize = 0;
+        for(const Slot& slot : slots)
+            unusedOfSize += (!slot.outstanding && slot.size == size) ? 1 : 0;
+
+        if(unusedOfSize > maxUnusedBuffersPerSize){
+            delete[] slots[index].buffer;
+            slots[index] = slots.back();
+            slots.pop_back();
+        }
+
+        updateStatistics();
+        return true;
+    }
+
+    Statistics getStatistics(){
+        std::unique_lock l(mutex);
+        return statistics;
+    }
+};
@@ -0,0 +1,214 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Points in the pipeline at which a point cloud is stamped */
+enum LatencyStage {
+    /** Frame set arrived from the SDK (start of the camera callback) */
+    LATENCY_SDK_ARRIVAL = 0,
+
+    /** Camera callback finished, point cloud handed to the camera manager */
+    LATENCY_CALLBACK_DONE,
+
+    /** Depth / color uploaded in CameraPasses::glTick */
+    LATENCY_GL_UPLOAD,
+
+    /** End of ShadowAvoidance::glTick */
+    LATENCY_SHADOW_AVOIDANCE,
+
+    /** First projector image rendered (Projector::renderRectifiedImage) */
+    LATENCY_PROJECTOR_RENDER,
+
+    /** Buffers swapped */
+    LATENCY_BUFFER_SWAP,
+
+    LATENCY_STAGE_COUNT
+};
+
+/**
+ * Host timestamps (steady clock, in microseconds) of one point cloud at each
+ * LatencyStage. Zero means "not reached (yet)".
+ */
+struct FrameTrace {
+    int64_t stageUs[LATENCY_STAGE_COUNT] = {};
+
+    static int64_t nowUs(){
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** Stamps the stage with the current time (if not already stamped) */
+    void stamp(LatencyStage stage){
+        if(stageUs[stage] == 0)
+            stageUs[stage] = nowUs();
+    }
+
+    /** Milliseconds from SDK arrival to the given stage (negative if unknown) */
+    float latencyMs(LatencyStage stage) const {
+        if(stageUs[LATENCY_SDK_ARRIVAL] == 0 || stageUs[stage] == 0)
+            return -1.f;
+        return float(stageUs[stage] - stageUs[LATENCY_SDK_ARRIVAL]) / 1000.f;
+    }
+};
+
+/**
+ * Collects the FrameTraces of the point clouds from SDK arrival until the
+ * buffer swap of the frame in which they were rendered the first time, and
+ * provides per-camera percentiles and a CSV dump of the last frames.
+ *
+ * The stamps in the OpenGL thread are host submission times (no glFinish is
+ * issued), so they are the latency the application adds until the driver
+ * takes over. All functions must be called from the OpenGL thread; the camera
+ * threads only stamp the FrameTrace of their own point clouds.
+ */
+class LatencyTracer {
+public:
+    struct Record {
+        int cameraID;
+        int frameID;
+        double deviceTimestamp;
+        FrameTrace trace;
+    };
+
+    struct Percentiles {
+        float p50 = -1.f;
+        float p95 = -1.f;
+        float p99 = -1.f;
+        size_t samples = 0;
+    };
+
+private:
+    /** Point clouds uploaded in the current frame (not swapped yet) */
+    std::vector<Record> inFlight;
+
+    /** Ring buffer of the last maxRecords finished frames */
+    std::vector<Record> records;
+    size_t nextRecord = 0;
+    size_t maxRecords = 4096;
+
+    static inline const char* const stageNames[LATENCY_STAGE_COUNT] = {
+        "sdkArrival", "callbackDone", "glUpload", "shadowAvoidance", "projectorRender", "bufferSwap"
+    };
+
+public:
+    bool enabled = true;
+
+    static LatencyTracer& getInstance(){
+        static LatencyTracer tracer;
+        return tracer;
+    }
+
+    static const char* getStageName(LatencyStage stage){
+        return stageNames[stage];
+    }
+
+    /** The point cloud of the camera was uploaded to the GPU in this frame */
+    void uploaded(int cameraID, int frameID, double deviceTimestamp, const FrameTrace& trace){
+        if(!enabled)
+            return;
+
+        Record record{cameraID, frameID, deviceTimestamp, trace};
+        record.trace.stamp(LATENCY_GL_UPLOAD);
+        inFlight.push_back(record);
+    }
+
+    /** Stamps all point clouds uploaded in this frame */
+    void stamp(LatencyStage stage){
+        for(Record& record : inFlight)
+            record.trace.stamp(stage);
+    }
+
+    /** Stamps the buffer swap and finishes the point clouds of this frame */
+    void frameSwapped(){
+        stamp(LATENCY_BUFFER_SWAP);
+
+        for(Record& record : inFlight){
+            if(records.size() < maxRecords){
+                records.push_back(record);
+            } else {
+                records[nextRecord] = record;
+            }
+            nextRecord = (nextRecord + 1) % maxRecords;
+        }
+        inFlight.clear();
+    }
+
+    /** Cameras with at least one record */
+    std::vector<int> getCameraIDs() const {
+        std::vector<int> cameraIDs;
+        for(const Record& record : records){
+            if(std::find(cameraIDs.begin(), cameraIDs.end(), record.cameraID) == cameraIDs.end())
+                cameraIDs.push_back(record.cameraID);
+        }
+        std::sort(cameraIDs.begin(), cameraIDs.end());
+        return cameraIDs;
+    }
+
+    /** Latencies (SDK arrival to stage, in ms) of the recorded frames of a camera */
+    std::vector<float> getLatencies(int cameraID, LatencyStage stage) const {
+        std::vector<float> latencies;
+        for(const Record& record : records){
+            float latency = record.trace.latencyMs(stage);
+            if(record.cameraID == cameraID && latency >= 0.f)
+                latencies.push_back(latency);
+        }
+        return latencies;
+    }
+
+    Percentiles getPercentiles(int cameraID, LatencyStage stage) const {
+        std::vector<float> latencies = getLatencies(cameraID, stage);
+
+        Percentiles result;
+        result.samples = latencies.size();
+        if(latencies.empty())
+            return result;
+
+        auto percentile = [&latencies](float p){
+            size_t index = std::min(latencies.size() - 1, size_t(p * latencies.size()));
+            std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+            return latencies[index];
+        };
+        result.p50 = percentile(0.50f);
+        result.p95 = percentile(0.95f);
+        result.p99 = percentile(0.99f);
+        return result;
+    }
+
+    void clear(){
+        records.clear();
+        nextRecord = 0;
+    }
+
+    /** Writes the recorded frames (oldest first) with the latency of each stage */
+    bool writeCSV(const std::string& filename) const {
+        std::ofstream file(filename);
+        if(!file){
+            std::cerr << "Could not write latency CSV " << filename << std::endl;
+            return false;
+        }
+
+        file << "camera,frameID,deviceTimestamp,sdkArrivalUs";
+        for(int stage = LATENCY_CALLBACK_DONE; stage < LATENCY_STAGE_COUNT; ++stage)
+            file << "," << stageNames[stage] << "Ms";
+        file << "\n";
+
+        size_t first = records.size() < maxRecords ? 0 : nextRecord;
+        for(size_t i = 0; i < records.size(); ++i){
+            const Record& record = records[(first + i) % records.size()];
+            file << record.cameraID << "," << record.frameID << "," << record.deviceTimestamp << "," << record.trace.stageUs[LATENCY_SDK_ARRIVAL];
+            for(int stage = LATENCY_CALLBACK_DONE; stage < LATENCY_STAGE_COUNT; ++stage)
+                file << "," << record.trace.latencyMs(LatencyStage(stage));
+            file << "\n";
+        }
+
+        std::cout << "Wrote " << records.size() << " latency records to " << filename << std::endl;
+        return true;
+    }
+};
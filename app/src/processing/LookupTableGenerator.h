@@ -0,0 +1,225 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "src/WorkerPool.h"
+
+/**
+ * Generates the 3D-to-image lookup table (see OrganizedPointCloud::lookup3DToImage)
+ * from the image-to-3D lookup table of an arbitrary depth resolution.
+ *
+ * Cell (i, j) of the size x size table belongs to the ray
+ * (i / (size - 1) * 2 - 1, j / (size - 1) * 2 - 1, 1) and stores the sub-pixel
+ * image coordinate which sees this ray, or (-1, -1) outside of the image.
+ * Every quad of neighboring image pixels is mapped into the table and the
+ * cells inside are filled by inverse bilinear interpolation, so the table
+ * exactly reproduces the (bilinearly interpolated) image-to-3D table.
+ */
+class LookupTableGenerator {
+public:
+    struct Statistics {
+        /** Max. / mean distance (in image pixels) of pixel -> ray -> table lookup -> pixel */
+        float maxReprojectionError = 0.f;
+        float meanReprojectionError = 0.f;
+
+        /** Number of pixels used for the error (all four surrounding cells valid) */
+        size_t checkedPixels = 0;
+
+        /** Number of table cells inside the image */
+        size_t validCells = 0;
+    };
+
+private:
+    struct Vec2 {
+        double x, y;
+    };
+
+    static inline double cross(Vec2 a, Vec2 b){
+        return a.x * b.y - a.y * b.x;
+    }
+
+    /**
+     * Finds (u, v) in [0, 1]^2 with bilinear(a, b, c, d, u, v) = p, where a = (0, 0),
+     * b = (1, 0), c = (1, 1), d = (0, 1). Returns false if p is outside of the quad.
+     */
+    static bool inverseBilinear(Vec2 p, Vec2 a, Vec2 b, Vec2 c, Vec2 d, double& u, double& v){
+        const double epsilon = 1e-6;
+        Vec2 e{b.x - a.x, b.y - a.y};
+        Vec2 f{d.x - a.x, d.y - a.y};
+        Vec2 g{a.x - b.x + c.x - d.x, a.y - b.y + c.y - d.y};
+        Vec2 h{p.x - a.x, p.y - a.y};
+
+        double k2 = cross(g, f);
+        double k1 = cross(e, f) + cross(h, g);
+        double k0 = cross(h, e);
+
+        auto solveU = [&](double v){
+            double denominatorX = e.x + g.x * v;
+            double denominatorY = e.y + g.y * v;
+            if(std::abs(denominatorX) > std::abs(denominatorY))
+                return (h.x - f.x * v) / denominatorX;
+            return (h.y - f.y * v) / denominatorY;
+        };
+        auto inside = [epsilon](double u, double v){
+            return u >= -epsilon && u <= 1.0 + epsilon && v >= -epsilon && v <= 1.0 + epsilon;
+        };
+
+        // Parallelogram (opposite edges parallel): linear equation:
+        if(std::abs(k2) < 1e-12){
+            if(std::abs(k1) < 1e-12)
+                return false;
+            v = -k0 / k1;
+            u = solveU(v);
+            return inside(u, v);
+        }
+
+        double discriminant = k1 * k1 - 4.0 * k0 * k2;
+        if(discriminant < 0.0)
+            return false;
+
+        // Numerically stable roots (the quads are nearly parallelograms, so k2 is tiny):
+        double q = -0.5 * (k1 + std::copysign(std::sqrt(discriminant), k1));
+        if(q != 0.0){
+            v = k0 / q;
+            u = solveU(v);
+            if(inside(u, v))
+                return true;
+        }
+
+        v = q / k2;
+        u = solveU(v);
+        return inside(u, v);
+    }
+
+    static inline bool validRay(const float* lookupImageTo3D, int index){
+        return std::isfinite(lookupImageTo3D[index * 2]) && std::isfinite(lookupImageTo3D[index * 2 + 1]);
+    }
+
+public:
+    /**
+     * Generates the table (size x size x 2 floats, allocated with new[]) for the
+     * width x height image-to-3D table. Runs in parallel on the worker pool.
+     */
+    static float* generate3DToImage(const float* lookupImageTo3D, int width, int height, int size, Statistics* statistics = nullptr){
+        float* table = new float[size_t(size) * size * 2];
+        std::fill_n(table, size_t(size) * size * 2, -1.f);
+
+        const float scale = 0.5f * (size - 1);
+        auto toTable = [scale](float ray){ return (ray + 1.f) * scale; };
+
+        // Table rows covered by each row of quads (to assign the quads to row bands):
+        std::vector<float> rowMinY(height - 1), rowMaxY(height - 1);
+        for(int y = 0; y < height - 1; ++y){
+            float minY = 1e30f, maxY = -1e30f;
+            for(int x = 0; x < width; ++x){
+                for(int row = y; row <= y + 1; ++row){
+                    int index = row * width + x;
+                    if(!validRay(lookupImageTo3D, index))
+                        continue;
+                    float tableY = toTable(lookupImageTo3D[index * 2 + 1]);
+                    minY = std::min(minY, tableY);
+                    maxY = std::max(maxY, tableY);
+                }
+            }
+            rowMinY[y] = minY;
+            rowMaxY[y] = maxY;
+        }
+
+        // Each chunk owns a band of table rows, so no two chunks write the same cell:
+        WorkerPool::getInstance().parallelForChunks(0, size, 16, [&](int bandBegin, int bandEnd){
+            for(int y = 0; y < height - 1; ++y){
+                if(rowMaxY[y] < bandBegin || rowMinY[y] > bandEnd - 1)
+                    continue;
+
+                for(int x = 0; x < width - 1; ++x){
+                    int i00 = y * width + x;
+                    int i10 = i00 + 1;
+                    int i01 = i00 + width;
+                    int i11 = i01 + 1;
+                    if(!validRay(lookupImageTo3D, i00) || !validRay(lookupImageTo3D, i10) || !validRay(lookupImageTo3D, i01) || !validRay(lookupImageTo3D, i11))
+                        continue;
+
+                    Vec2 a{toTable(lookupImageTo3D[i00 * 2]), toTable(lookupImageTo3D[i00 * 2 + 1])};
+                    Vec2 b{toTable(lookupImageTo3D[i10 * 2]), toTable(lookupImageTo3D[i10 * 2 + 1])};
+                    Vec2 c{toTable(lookupImageTo3D[i11 * 2]), toTable(lookupImageTo3D[i11 * 2 + 1])};
+                    Vec2 d{toTable(lookupImageTo3D[i01 * 2]), toTable(lookupImageTo3D[i01 * 2 + 1])};
+
+                    int minX = std::max(0, int(std::ceil(std::min({a.x, b.x, c.x, d.x}))));
+                    int maxX = std::min(size - 1, int(std::floor(std::max({a.x, b.x, c.x, d.x}))));
+                    int minY = std::max(bandBegin, int(std::ceil(std::min({a.y, b.y, c.y, d.y}))));
+                    int maxY = std::min(bandEnd - 1, int(std::floor(std::max({a.y, b.y, c.y, d.y}))));
+
+                    for(int cellY = minY; cellY <= maxY; ++cellY){
+                        for(int cellX = minX; cellX <= maxX; ++cellX){
+                            double u, v;
+                            if(!inverseBilinear(Vec2{double(cellX), double(cellY)}, a, b, c, d, u, v))
+                                continue;
+
+                            size_t cell = (size_t(cellY) * size + cellX) * 2;
+                            table[cell] = float(x + std::clamp(u, 0.0, 1.0));
+                            table[cell + 1] = float(y + std::clamp(v, 0.0, 1.0));
+                        }
+                    }
+                }
+            }
+        });
+
+        if(statistics != nullptr)
+            *statistics = measureReprojectionError(lookupImageTo3D, width, height, table, size);
+
+        return table;
+    }
+
+    /**
+     * Maps every image pixel to its ray and back through the (bilinearly sampled)
+     * table and measures the distance to the original pixel.
+     */
+    static Statistics measureReprojectionError(const float* lookupImageTo3D, int width, int height, const float* table, int size){
+        Statistics statistics;
+        for(size_t cell = 0; cell < size_t(size) * size; ++cell)
+            statistics.validCells += table[cell * 2] >= 0.f;
+
+        const float scale = 0.5f * (size - 1);
+        double errorSum = 0.0;
+
+        for(int y = 0; y < height; ++y){
+            for(int x = 0; x < width; ++x){
+                int index = y * width + x;
+                if(!validRay(lookupImageTo3D, index))
+                    continue;
+
+                float tableX = (lookupImageTo3D[index * 2] + 1.f) * scale;
+                float tableY = (lookupImageTo3D[index * 2 + 1] + 1.f) * scale;
+                int x0 = int(std::floor(tableX));
+                int y0 = int(std::floor(tableY));
+                if(x0 < 0 || y0 < 0 || x0 + 1 >= size || y0 + 1 >= size)
+                    continue;
+
+                const float* c00 = &table[(size_t(y0) * size + x0) * 2];
+                const float* c10 = c00 + 2;
+                const float* c01 = c00 + size_t(size) * 2;
+                const float* c11 = c01 + 2;
+                if(c00[0] < 0.f || c10[0] < 0.f || c01[0] < 0.f || c11[0] < 0.f)
+                    continue;
+
+                float dx = tableX - x0;
+                float dy = tableY - y0;
+                float imageX = (c00[0] * (1 - dx) + c10[0] * dx) * (1 - dy) + (c01[0] * (1 - dx) + c11[0] * dx) * dy;
+                float imageY = (c00[1] * (1 - dx) + c10[1] * dx) * (1 - dy) + (c01[1] * (1 - dx) + c11[1] * dx) * dy;
+
+                float error = std::sqrt((imageX - x) * (imageX - x) + (imageY - y) * (imageY - y));
+                statistics.maxReprojectionError = std::max(statistics.maxReprojectionError, error);
+                errorSum += error;
+                ++statistics.checkedPixels;
+            }
+        }
+
+        if(statistics.checkedPixels > 0)
+            statistics.meanReprojectionError = float(errorSum / statistics.checkedPixels);
+        return statistics;
+    }
+};
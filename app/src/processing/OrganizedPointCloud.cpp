@@ -3,6 +3,13 @@
 
 #include "src/processing/OrganizedPointCloud.h"
 
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 /** Unused initialized gpu memory */
 std::vector<OrganizedPointCloud::GPUMemory> OrganizedPointCloud::unusedInitializedGPUMemory = std::vector<OrganizedPointCloud::GPUMemory>();
 
@@ -25,3 +32,47 @@ void OrganizedPointCloud::cleanupStaticMemory(){
 #endif
 }
 
+
+void OrganizedPointCloud::projectHighResIn3D(const float* xs, const float* ys, size_t count, Vec4f* rays) const {
+    if(lookupHighResTo3D == nullptr || highResWidth < 2 || highResHeight < 2){
+        for(size_t i = 0; i < count; ++i)
+            rays[i] = Vec4f(0.f, 0.f, 0.f, 0.f);
+        return;
+    }
+
+    const float maxX = float(highResWidth - 1);
+    const float maxY = float(highResHeight - 1);
+
+    for(size_t i = 0; i < count; ++i){
+        float x = std::min(std::max(xs[i], 0.f), maxX);
+        float y = std::min(std::max(ys[i], 0.f), maxY);
+        int x0 = std::min(int(x), highResWidth - 2);
+        int y0 = std::min(int(y), highResHeight - 2);
+        float fx = x - x0;
+        float fy = y - y0;
+
+        const float* r00 = lookupHighResTo3D + (size_t(y0) * highResWidth + x0) * 4;
+        const float* r10 = r00 + 4;
+        const float* r01 = r00 + size_t(highResWidth) * 4;
+        const float* r11 = r01 + 4;
+
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128 top = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r00), _mm_set1_ps(1.f - fx)), _mm_mul_ps(_mm_loadu_ps(r10), _mm_set1_ps(fx)));
+        __m128 bottom = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r01), _mm_set1_ps(1.f - fx)), _mm_mul_ps(_mm_loadu_ps(r11), _mm_set1_ps(fx)));
+        __m128 ray = _mm_add_ps(_mm_mul_ps(top, _mm_set1_ps(1.f - fy)), _mm_mul_ps(bottom, _mm_set1_ps(fy)));
+
+        // Renormalize (w is 0, so it doesn't contribute to the length):
+        __m128 squared = _mm_mul_ps(ray, ray);
+        __m128 sum = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(&rays[i].x, _mm_div_ps(ray, _mm_sqrt_ps(sum)));
+#else
+        float ray[4];
+        for(int c = 0; c < 4; ++c)
+            ray[c] = (r00[c] * (1.f - fx) + r10[c] * fx) * (1.f - fy) + (r01[c] * (1.f - fx) + r11[c] * fx) * fy;
+
+        float length = std::sqrt(ray[0] * ray[0] + ray[1] * ray[1] + ray[2] * ray[2]);
+        rays[i] = Vec4f(ray[0] / length, ray[1] / length, ray[2] / length, 0.f);
+#endif
+    }
+}
@@ -7,7 +7,11 @@
 #define CAMERA_RESPONSIBILITY_OCCLUSION 64
 #define CAMERA_RESPONSIBILITY_GESTURES 128
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #ifdef USE_CUDA
 #include <cuda_runtime.h>
@@ -20,6 +24,9 @@ struct uchar4 {unsigned char x, y, z, w;};
 
 #include "src/math/Mat4.h"
 #include "src/gl/primitive/TexCoord.h"
+#include "src/processing/FramePool.h"
+#include "src/processing/LatencyTracer.h"
+#include "src/processing/devices/ColorToDepthMapper.h"
 
 class RGBDCamera;
 
@@ -76,6 +83,25 @@ private:
     /** Defines initialized GPU memory which is currently not in use */
     static std::vector<GPUMemory> unusedInitializedGPUMemory;
 
+    /** Dense high res color to depth pixel map (built on first use) */
+    int32_t* highResColorToDepthMap = nullptr;
+    std::mutex highResColorToDepthMapMutex;
+
+    /**
+     * Gives the array back to the frame pool of the camera if it was acquired
+     * from there, otherwise deletes it.
+     */
+    template<typename T>
+    void releaseArray(T*& array){
+        if(array == nullptr)
+            return;
+
+        if(framePool == nullptr || !framePool->release(array))
+            delete[] array;
+
+        array = nullptr;
+    }
+
 public:
     OrganizedPointCloud(unsigned int width, unsigned int height)
         : width(width)
@@ -102,7 +128,9 @@ public:
     /** Function that transforms a depth pixel coordinate (e.g. 640 x 576) to a color pixel coordinate (e.g. 1920 x 1080) */
     std::function<std::pair<float,float>(float x, float y, float depth)> depthToHighResTransformer;
 
-    std::function<Vec4f(float x, float y)> projectHighResIn3D;
+
+    /** Builds the high res color to depth map of this camera (nullptr if not available) */
+    std::shared_ptr<ColorToDepthMapper> colorToDepthMapper;
 
     Mat4f colorToDepth;
 
@@ -135,6 +163,13 @@ public:
      */
     float* lookupImageTo3D = nullptr;
 
+    /**
+     * Normalized ray (x, y, z, 0) of every high res color pixel in the color camera
+     * (highResWidth x highResHeight x 4 floats). Memory is managed by the READER like
+     * lookupImageTo3D, since the color intrinsics don't change between images.
+     */
+    float* lookupHighResTo3D = nullptr;
+
     /** Stores the xyzw coordiantes of all points */
     float4* gpuDepth = nullptr;
 
@@ -173,10 +208,13 @@ public:
     Vec4f camAcceleration;
 
     /**
-     * Usually not used / needed for processing, implemented for writing synchronized
-     * training data
+     * Device timestamp of the depth frame in seconds (-1 if unknown). Not needed for
+     * processing, but for writing synchronized data and latency tracing.
      */
-    float timestamp = -1;
+    double timestamp = -1;
+
+    /** Host timestamps of this point cloud in the pipeline (see LatencyTracer) */
+    FrameTrace trace;
 
     /**
      * Indicates whether the last change was performed on GPU (or CPU) and whether
@@ -193,7 +231,27 @@ public:
     /**
      * The origin of this point cloud:
      */
-    RGBDCamera* camera;
+    RGBDCamera* camera = nullptr;
+
+    /**
+     * Keeps the camera (and the lookup tables it owns) alive while this point
+     * cloud is in use, since cameras can be disconnected at runtime (nullptr
+     * if the camera outlives all of its point clouds).
+     */
+    std::shared_ptr<RGBDCamera> cameraOwner;
+
+    /**
+     * Keep lookup tables alive which are not owned by the camera (e.g. the
+     * decimated ones of DepthBinning, nullptr otherwise).
+     */
+    std::shared_ptr<const std::vector<float>> lookupImageTo3DStorage;
+    std::shared_ptr<const std::vector<float>> lookup3DToImageStorage;
+
+    /**
+     * Pool of the camera the arrays were acquired from (nullptr if they were
+     * allocated with new[]). Keeps the pool alive until this point cloud is gone.
+     */
+    std::shared_ptr<FramePool> framePool;
 
     /**
      * Initializes the gpu... variables (if necessary) and copies the content from the
@@ -308,35 +366,70 @@ public:
             gpuTexCoords = nullptr;
         }
 
-        if(depth != nullptr){
-            delete[] depth;
-            depth = nullptr;
-        }
+        releaseArray(depth);
+        releaseArray(colors);
+        releaseArray(highResColors);
+        releaseArray(highResColorToDepthMap);
+        releaseArray(ir);
+        releaseArray(normals);
+        releaseArray(texCoords);
+    }
 
-        if(colors != nullptr){
-            delete[] colors;
-            colors = nullptr;
+    /**
+     * Returns the dense map (highResWidth x highResHeight) of depth pixel indices
+     * (y * width + x, -1 where no depth pixel is visible). It is built once per
+     * point cloud on first use; thread safe. Returns nullptr if no colorToDepthMapper
+     * is available.
+     */
+    const int32_t* getHighResColorToDepthMap(){
+        std::unique_lock lock(highResColorToDepthMapMutex);
+        if(highResColorToDepthMap == nullptr && colorToDepthMapper != nullptr && depth != nullptr){
+            size_t size = size_t(colorToDepthMapper->getColorWidth()) * colorToDepthMapper->getColorHeight();
+            highResColorToDepthMap = framePool ? framePool->acquire<int32_t>(size) : new int32_t[size];
+            colorToDepthMapper->build(depth, highResColorToDepthMap);
         }
+        return highResColorToDepthMap;
+    }
 
-        if(highResColors != nullptr){
-            delete[] highResColors;
-            highResColors = nullptr;
-        }
+    /**
+     * Maps a high res color pixel coordinate to the depth pixel coordinate visible
+     * there, (-1, -1) if there is none.
+     */
+    std::pair<float,float> mapHighResColorToDepth(float x, float y){
+        const int32_t* map = getHighResColorToDepthMap();
+        int colorX = int(std::lround(x));
+        int colorY = int(std::lround(y));
+        if(map == nullptr || colorX < 0 || colorY < 0 || colorX >= colorToDepthMapper->getColorWidth() || colorY >= colorToDepthMapper->getColorHeight())
+            return std::pair<float,float>(-1.f, -1.f);
+
+        int32_t depthIndex = map[colorY * colorToDepthMapper->getColorWidth() + colorX];
+        if(depthIndex < 0)
+            return std::pair<float,float>(-1.f, -1.f);
+
+        return std::pair<float,float>(float(depthIndex % int(width)), float(depthIndex / int(width)));
+    }
 
-        if(ir != nullptr){
-            delete[] ir;
-            ir = nullptr;
-        }
+    /**
+     * Returns the normalized ray of the (sub-)pixel of the high res color image
+     * (bilinear interpolation of lookupHighResTo3D, zero vector if not available).
+     */
+    Vec4f projectHighResIn3D(float x, float y) const {
+        Vec4f ray;
+        projectHighResIn3D(&x, &y, 1, &ray);
+        return ray;
+    }
 
-        if(normals != nullptr){
-            delete[] normals;
-            normals = nullptr;
-        }
+    /**
+     * Batch version of projectHighResIn3D for count pixel coordinates (SSE if
+     * available).
+     */
+    void projectHighResIn3D(const float* xs, const float* ys, size_t count, Vec4f* rays) const;
 
-        if(texCoords != nullptr){
-            delete[] texCoords;
-            texCoords = nullptr;
-        }
+    /** Returns the normalized rays of a row of the high res color image (nullptr if not available) */
+    const Vec4f* getHighResRayRow(int y) const {
+        if(lookupHighResTo3D == nullptr || y < 0 || y >= highResHeight)
+            return nullptr;
+        return reinterpret_cast<const Vec4f*>(lookupHighResTo3D) + size_t(y) * highResWidth;
     }
 
     Vec4f getPosition(int x, int y){
@@ -366,6 +459,9 @@ public:
     }
 
     std::pair<float, float> getImageCoord(Vec4f v){
+        if(lookup3DToImage == nullptr)
+            return std::make_pair(-1.f, -1.f);
+
         float x = v.x / v.z;
         float y = v.y / v.z;
 
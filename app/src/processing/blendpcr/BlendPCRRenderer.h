@@ -5,8 +5,11 @@
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
 #include "src/gl/Shader.h"
+#include "src/gl/ShaderVariants.h"
 
 #include "src/processing/blendpcr/CameraPasses.h"
+#include "src/processing/blendpcr/ScreenPassTargets.h"
+#include "src/simulation/scene/SceneUniforms.h"
 #include "src/Data.h"
 
 using namespace std::chrono;
@@ -14,146 +17,20 @@ using namespace std::chrono;
 // Uncomment if you want to print timings:
 // #define PRINT_TIMINGS
 
-#define CAMERA_COUNT 7
 #define LOOKUP_IMAGE_SIZE 1024
 
 class BlendPCRRenderer {
-    bool isInitialized = false;
-
-    // The fbo and textures for the separate screen rendering passes:
-    unsigned int fbo_screen[CAMERA_COUNT];
-    unsigned int texture2D_screenColor[CAMERA_COUNT];
-    unsigned int texture2D_screenVertices[CAMERA_COUNT];
-    unsigned int texture2D_screenNormals[CAMERA_COUNT];
-    unsigned int texture2D_screenDepth[CAMERA_COUNT];
-
-    // The fbo and texture for the major cam pass:
-    unsigned int fbo_majorCam;
-    unsigned int texture2D_majorCam;
-
-    // The fbo and texture for the camera weights:
-    unsigned int fbo_cameraWeights;
-    unsigned int texture2D_cameraWeightsA; // Camera 0-3
-    unsigned int texture2D_cameraWeightsB; // Camera 4-7
-
-    int fbo_screen_width = -1;
-    int fbo_screen_height = -1;
-
-    int fbo_mini_screen_width = -1;
-    int fbo_mini_screen_height = -1;
+    // The render targets of the screen passes (one layer per camera):
+    ScreenPassTargets targets;
 
     /**
-     * Define all the shaders for the screen passes:
+     * Define all the shaders for the screen passes (the merging shaders are
+     * specialized for the camera count):
      */
     Shader renderShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/separateRendering.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/separateRendering.frag");
-    Shader majorCamShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.frag");
-    Shader cameraWeightsShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.frag");
-    Shader blendingShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.frag");
-
-
-    void generateAndBind2DTexture(
-        unsigned int& texture,
-        unsigned int width,
-        unsigned int height,
-        unsigned int internalFormat, // eg. GL_RED, GL_RG, GL_RGB, GL_RGBA, GL_R32F,...
-        unsigned int format, // e.g. only GL_RED, GL_RG, GL_RGB, GL_BGR, GL_RGBA, GL_BGRA without Sizes!
-        unsigned int type, // egl. GL_UNSIGNED_BYTE, GL_FLOAT
-        unsigned int filter // GL_LINEAR or GL_NEAREST
-        ){
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
-
-        if(filter != GL_NONE){
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-        }
-
-        if(format == GL_DEPTH_COMPONENT){
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
-        }
-    };
-
-    void init(){
-        int mainViewport[4];
-        glGetIntegerv(GL_VIEWPORT, mainViewport);
-
-        int originalFramebuffer;
-        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &originalFramebuffer);
-
-        // If screen size changed:
-        if(mainViewport[2] != fbo_screen_width || mainViewport[3] != fbo_screen_height){
-            for(unsigned int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
-                // Delete old frame buffer + texture:
-                if(fbo_screen_width != -1){
-                    glDeleteFramebuffers(1, &fbo_screen[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenColor[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenVertices[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenNormals[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenDepth[cameraID]);
-                }
-
-                // Generate resources for SCREEN SPACE PASS:
-                {
-                    std::cout << "Generate FBO Screen" << std::endl;
-
-                    glGenFramebuffers(1, &fbo_screen[cameraID]);
-                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_screen[cameraID]);
-
-                    generateAndBind2DTexture(texture2D_screenColor[cameraID], mainViewport[2], mainViewport[3], GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_screenColor[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenVertices[cameraID], mainViewport[2], mainViewport[3], GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture2D_screenVertices[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenNormals[cameraID], mainViewport[2], mainViewport[3], GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, texture2D_screenNormals[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenDepth[cameraID], mainViewport[2], mainViewport[3], GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture2D_screenDepth[cameraID], 0);
-
-                }
-            }
-
-            fbo_screen_width = mainViewport[2];
-            fbo_screen_height = mainViewport[3];
-
-            // Delete old frame buffer + texture:
-            if(fbo_mini_screen_width != -1){
-                glDeleteFramebuffers(1, &fbo_majorCam);
-                glDeleteTextures(1, &texture2D_majorCam);
-
-                glDeleteFramebuffers(1, &fbo_cameraWeights);
-                glDeleteTextures(1, &texture2D_cameraWeightsA);
-                glDeleteTextures(1, &texture2D_cameraWeightsB);
-            }
-
-            int requestedMiniScreenWidth = mainViewport[2] / 4;
-            int requestedMiniScreenHeight = mainViewport[3] / 4;
-
-
-            glGenFramebuffers(1, &fbo_majorCam);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
-
-            generateAndBind2DTexture(texture2D_majorCam, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_majorCam, 0);
-
-            glGenFramebuffers(1, &fbo_cameraWeights);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
-
-            generateAndBind2DTexture(texture2D_cameraWeightsA, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_cameraWeightsA, 0);
-
-            generateAndBind2DTexture(texture2D_cameraWeightsB, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture2D_cameraWeightsB, 0);
-
-            fbo_mini_screen_width = requestedMiniScreenWidth;
-            fbo_mini_screen_height = requestedMiniScreenHeight;
-        }
-
-        glBindFramebuffer(GL_FRAMEBUFFER, originalFramebuffer);
-        isInitialized = true;
-    }
+    ShaderVariants majorCamShaders = ShaderVariants(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.frag", "CAMERA_NUM");
+    ShaderVariants cameraWeightsShaders = ShaderVariants(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.frag", "CAMERA_NUM");
+    ShaderVariants blendingShaders = ShaderVariants(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.frag", "CAMERA_NUM");
 
 public:
     float implicitH = 0.01f;
@@ -167,26 +44,6 @@ public:
     BlendPCRRenderer(){
     }
 
-    ~BlendPCRRenderer(){
-        if(fbo_mini_screen_width != -1){
-            glDeleteFramebuffers(1, &fbo_majorCam);
-            glDeleteTextures(1, &texture2D_majorCam);
-
-            glDeleteFramebuffers(1, &fbo_cameraWeights);
-            glDeleteTextures(1, &texture2D_cameraWeightsA);
-            glDeleteTextures(1, &texture2D_cameraWeightsB);
-        }
-
-        for(int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
-            if(fbo_screen_width != -1){
-                glDeleteFramebuffers(1, &fbo_screen[cameraID]);
-                glDeleteTextures(1, &texture2D_screenColor[cameraID]);
-                glDeleteTextures(1, &texture2D_screenVertices[cameraID]);
-                glDeleteTextures(1, &texture2D_screenDepth[cameraID]);
-            }
-        }
-    }
-
     /**
      * Renders the point cloud
      */
@@ -195,22 +52,22 @@ public:
 
         glDisable(GL_BLEND);
 
-        // If opengl resources are not initialized yet, do it:
-        init();
-
         // Check if cameras for rendering are available:
         if(pctextures.usedCameraIDs.size() == 0){
             //std::cout << "ExperimentalPCPreprocessor: NO CAMERAS FOR RENDERING AVAILABLE!" << std::endl;
             return;
         }
 
-        bool isCameraActive[CAMERA_COUNT];
-        std::fill_n(isCameraActive, CAMERA_COUNT, false);
+        // (Re)allocate the render targets if the screen size or camera count changed:
+        int mainViewport[4];
+        glGetIntegerv(GL_VIEWPORT, mainViewport);
 
-        // Iterate over all cameras:
-        for(unsigned int i = 0; i < pctextures.currentPointClouds.size(); ++i){
-            isCameraActive[i] = true;
-        }
+        const int cameraCount = pctextures.cameraCount;
+        targets.ensure(mainViewport[2], mainViewport[3], cameraCount);
+
+        Shader& majorCamShader = majorCamShaders.get(cameraCount);
+        Shader& cameraWeightsShader = cameraWeightsShaders.get(cameraCount);
+        Shader& blendingShader = blendingShaders.get(cameraCount);
 
         glDisable(GL_CULL_FACE);
         glCullFace(GL_BACK);
@@ -220,7 +77,7 @@ public:
 
         // Now we render all meshes of each depth camera to a framebuffer:
         for(unsigned int cameraID : pctextures.usedCameraIDs){
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_screen[cameraID]);
+            glBindFramebuffer(GL_FRAMEBUFFER, targets.fbo_screen[cameraID]);
 
             // Draw out point cloud and color texture:
             unsigned int attachments[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
@@ -284,36 +141,15 @@ public:
 
         // MiniScreen:
         {
-            glViewport(0, 0, fbo_mini_screen_width, fbo_mini_screen_height);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
+            glViewport(0, 0, targets.miniWidth, targets.miniHeight);
+            glBindFramebuffer(GL_FRAMEBUFFER, targets.fbo_majorCam);
             majorCamShader.bind();
 
             unsigned int currentTexture = 1;
-            for(unsigned int cameraIDOfTexture : pctextures.usedCameraIDs){
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenColor[cameraIDOfTexture]);
-                majorCamShader.setUniform("color["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenVertices[cameraIDOfTexture]);
-                majorCamShader.setUniform("vertices["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenNormals[cameraIDOfTexture]);
-                majorCamShader.setUniform("normals["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenDepth[cameraIDOfTexture]);
-                majorCamShader.setUniform("depth["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-            }
+            targets.bindScreenTextures(majorCamShader, currentTexture);
 
-            for(int i=0; i < CAMERA_COUNT; ++i){
-                majorCamShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
-            }
+            // The active cameras are in the camera block (see SceneUniforms):
+            SceneUniforms::bindBlocks(majorCamShader);
 
             majorCamShader.setUniform("view", view);
             majorCamShader.setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
@@ -323,21 +159,16 @@ public:
         }
 
         {
-            glViewport(0, 0, fbo_mini_screen_width, fbo_mini_screen_height);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
+            glViewport(0, 0, targets.miniWidth, targets.miniHeight);
+            glBindFramebuffer(GL_FRAMEBUFFER, targets.fbo_cameraWeights);
             cameraWeightsShader.bind();
 
-            unsigned int attachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
-            glDrawBuffers(2, attachments);
+            targets.setCameraWeightsDrawBuffers();
 
             glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, texture2D_majorCam);
+            glBindTexture(GL_TEXTURE_2D, targets.texture2D_majorCam);
             cameraWeightsShader.setUniform("dominanceTexture", 1);
 
-            for(int i=0; i < CAMERA_COUNT; ++i){
-                cameraWeightsShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
-            }
-
             glBindVertexArray(pctextures.VAO_quad);
             glDrawArrays(GL_TRIANGLES, 0, 6);
         }
@@ -359,54 +190,14 @@ public:
             blendingShader.bind();
 
             unsigned int currentTexture = 1;
-            for(unsigned int cameraIDOfTexture : pctextures.usedCameraIDs){
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenColor[cameraIDOfTexture]);
-                blendingShader.setUniform("color["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenVertices[cameraIDOfTexture]);
-                blendingShader.setUniform("vertices["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenNormals[cameraIDOfTexture]);
-                blendingShader.setUniform("normals["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_screenDepth[cameraIDOfTexture]);
-                blendingShader.setUniform("depth["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                ++currentTexture;
-            }
+            targets.bindScreenTextures(blendingShader, currentTexture);
 
-            glActiveTexture(GL_TEXTURE0 + currentTexture);
-            glBindTexture(GL_TEXTURE_2D, texture2D_cameraWeightsA);
-            blendingShader.setUniform("miniWeightsA", int(currentTexture));
-            ++currentTexture;
+            targets.bindCameraWeights(blendingShader, currentTexture);
 
-            glActiveTexture(GL_TEXTURE0 + currentTexture);
-            glBindTexture(GL_TEXTURE_2D, texture2D_cameraWeightsB);
-            blendingShader.setUniform("miniWeightsB", int(currentTexture));
-            ++currentTexture;
-
-            for(int i=0; i < CAMERA_COUNT; ++i){
-                blendingShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
-            }
+            SceneUniforms::bindBlocks(blendingShader);
 
             blendingShader.setUniform("view", view);
 
-            // Lighting
-            Vec4f lightPos[4] = {Vec4f(1.5f, 1.5f, 1.5f), Vec4f(-1.5f, 1.5f, 1.5f), Vec4f(-1.5f, 1.5f, -1.5f), Vec4f(1.5f, 1.5f, -1.5f)};
-            Vec4f lightColors[4] = {Vec4f(0.5f, 0.75f, 1.0f), Vec4f(1.0f, 0.75f, 0.5f), Vec4f(0.5f, 0.75f, 1.0f), Vec4f(1.0f, 0.75f, 0.5f)};
-
-            for(int i=0; i < 4; ++i){
-                blendingShader.setUniform("lights["+std::to_string(i)+"].position", view * lightPos[i]);
-                blendingShader.setUniform("lights["+std::to_string(i)+"].intensity", lightColors[i]);
-                blendingShader.setUniform("lights["+std::to_string(i)+"].range", 10.f);
-            }
-
             blendingShader.setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
 
             glBindVertexArray(pctextures.VAO_quad);
@@ -9,17 +9,30 @@
 
 #include "src/Data.h"
 
+#include "src/gl/PixelUploadRing.h"
+#include "src/gl/ComputeShader.h"
+#include "src/gl/AsyncReadback.h"
+#include "src/gl/GPUProfiler.h"
+
 #include "src/processing/OrganizedPointCloud.h"
-#include "src/Semaphore.h"
+#include "src/processing/blendpcr/DirtyTileMask.h"
+#include "src/simulation/scene/SceneUniforms.h"
+#include "src/WorkerPool.h"
 
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
 
 using namespace std::chrono;
 
-#define CAMERA_COUNT 3
+// Capacity of the per camera resources (GL resources are only created for cameras in use):
+#define MAX_CAMERA_COUNT MAX_RGBD_DEVICES
 #define LOOKUP_IMAGE_SIZE 1024
 
+static_assert(MAX_CAMERA_COUNT <= UNIFORM_BLOCK_MAX_CAMERAS, "The camera block is too small for MAX_CAMERA_COUNT");
+
+// Work group size of the fused compute filters:
+#define FILTER_TILE_SIZE 16
+
 #define SEGMENTATION_DOWNSCALE_WIDTH 256
 #define SEGMENTATION_DOWNSCALE_HEIGHT 256
 
@@ -32,6 +45,42 @@ using namespace std::chrono;
  */
 class CameraPasses {
 public:
+    /** Implementation of the MLS smoothing */
+    enum MLSMode {
+        /** Full 21 x 21 window (441 taps) */
+        MLS_EXACT = 0,
+
+        /** Every second row and column of the window (121 taps) */
+        MLS_STRIDED,
+
+        /** Two 1D passes along the rows and the columns (2 x 21 taps) */
+        MLS_SEPARABLE,
+
+        MLS_MODE_COUNT
+    };
+
+    /** Implementation of the normal estimation */
+    enum NormalsMode {
+        /** Gaussian weighted covariance of the window, iterative eigen solver (cost grows with the window) */
+        NORMALS_EIGEN_SOLVER = 0,
+
+        /** Covariance from summed-area tables (four lookups), closed-form eigenvector (requires compute shaders) */
+        NORMALS_SUMMED_AREA,
+
+        NORMALS_MODE_COUNT
+    };
+
+    /** Per camera passes whose GPU time is measured */
+    enum Pass {
+        PASS_FILTERS = 0,
+        PASS_REJECTION,
+        PASS_EDGE_PROXIMITY,
+        PASS_MLS,
+        PASS_NORMALS,
+        PASS_QUALITY_ESTIMATE,
+        PASS_COUNT
+    };
+
     static CameraPasses& getInstance(){
         if(globalCameraPasses == nullptr){
             globalCameraPasses = new CameraPasses();
@@ -42,80 +91,93 @@ public:
 
     CameraPasses(){
         // Ensure that camera are correctly recognizable as uninitialized:
-        for(int i=0; i < CAMERA_COUNT; ++i){
+        for(int i=0; i < MAX_CAMERA_COUNT; ++i){
             cameraWidth[i] = -1;
             cameraHeight[i] = -1;
-            lookupInitialized[i] = false;
+            uploadedLookupImageTo3D[i] = nullptr;
+            uploadedLookup3DToImage[i] = nullptr;
         }
     }
 
-    // Current Point Clouds:
-    std::mutex pointCloudsMutex;
+    // Current Point Clouds (snapshot of the camera manager, taken in glTick):
     std::vector<std::shared_ptr<OrganizedPointCloud>> currentPointClouds;
 
-    Mat4f pointCloudMatrix[CAMERA_COUNT];
+    Mat4f pointCloudMatrix[MAX_CAMERA_COUNT];
+
+    int cameraWidth[MAX_CAMERA_COUNT];
+    int cameraHeight[MAX_CAMERA_COUNT];
 
-    int cameraWidth[CAMERA_COUNT];
-    int cameraHeight[CAMERA_COUNT];
-    bool lookupInitialized[CAMERA_COUNT];
-    bool cameraIsUpdatedThisFrame[CAMERA_COUNT];
+    // Lookup tables currently in the textures (uploaded again if the camera provides new ones):
+    const float* uploadedLookupImageTo3D[MAX_CAMERA_COUNT];
+    const float* uploadedLookup3DToImage[MAX_CAMERA_COUNT];
+    bool cameraIsUpdatedThisFrame[MAX_CAMERA_COUNT];
 
     // Reimplemented point cloud filter (Hole Filling):
-    unsigned int fbo_pcf_holeFilling[CAMERA_COUNT];
-    unsigned int texture2D_pcf_holeFilledVertices[CAMERA_COUNT];
-    unsigned int texture2D_pcf_holeFilledRGB[CAMERA_COUNT];
+    unsigned int fbo_pcf_holeFilling[MAX_CAMERA_COUNT];
+    unsigned int texture2D_pcf_holeFilledVertices[MAX_CAMERA_COUNT];
+    unsigned int texture2D_pcf_holeFilledRGB[MAX_CAMERA_COUNT];
 
-    unsigned int texture2D_pcf_temporalNoiseFilter[CAMERA_COUNT];
+    unsigned int texture2D_pcf_temporalNoiseFilter[MAX_CAMERA_COUNT];
 
     // Reimplemented point cloud filter (Erosion):
-    unsigned int fbo_pcf_erosion[CAMERA_COUNT];
-    unsigned int texture2D_pcf_erosion[CAMERA_COUNT];
+    unsigned int fbo_pcf_erosion[MAX_CAMERA_COUNT];
+    unsigned int texture2D_pcf_erosion[MAX_CAMERA_COUNT];
 
     // Using Flip Flop approach to insert old texture for
     // noise removal:
-    unsigned int fbo_pcf_temporalFilterA[CAMERA_COUNT];
-    unsigned int texture2D_pcf_temporalFilterA[CAMERA_COUNT];
-    unsigned int fbo_pcf_temporalFilterB[CAMERA_COUNT];
-    unsigned int texture2D_pcf_temporalFilterB[CAMERA_COUNT];
-    bool temporalFilterFlipFlop[CAMERA_COUNT];
+    unsigned int fbo_pcf_temporalFilterA[MAX_CAMERA_COUNT];
+    unsigned int texture2D_pcf_temporalFilterA[MAX_CAMERA_COUNT];
+    unsigned int fbo_pcf_temporalFilterB[MAX_CAMERA_COUNT];
+    unsigned int texture2D_pcf_temporalFilterB[MAX_CAMERA_COUNT];
+    bool temporalFilterFlipFlop[MAX_CAMERA_COUNT];
 
     // NOT A CREATED RESOURCE, ONLY FOR PASSING THROUGH THE CORRECT TEXTURES
     // TO BE ABLE TO DYNAMICALLY ACTIVATE AND DEACTIVATE FILTERS:
-    unsigned int currentProcessedVertices[CAMERA_COUNT];
+    unsigned int currentProcessedVertices[MAX_CAMERA_COUNT];
 
     // FBO for generating 3D vertices from depth image:
-    unsigned int fbo_genVertices[CAMERA_COUNT];
+    unsigned int fbo_genVertices[MAX_CAMERA_COUNT];
 
     // The textures for the input point clouds:
-    unsigned int texture2D_inputGenVertices[CAMERA_COUNT];
-    unsigned int texture2D_inputDepth[CAMERA_COUNT];
-    unsigned int texture2D_inputRGB[CAMERA_COUNT];
-    unsigned int texture2D_inputLookupImageTo3D[CAMERA_COUNT];
-    unsigned int texture2D_inputLookup3DToImage[CAMERA_COUNT];
+    unsigned int texture2D_inputGenVertices[MAX_CAMERA_COUNT];
+    unsigned int texture2D_inputDepth[MAX_CAMERA_COUNT];
+    unsigned int texture2D_inputRGB[MAX_CAMERA_COUNT];
+    unsigned int texture2D_inputLookupImageTo3D[MAX_CAMERA_COUNT];
+    unsigned int texture2D_inputLookup3DToImage[MAX_CAMERA_COUNT];
 
     // The fbo and texture for the rejection pass:
-    unsigned int fbo_rejection[CAMERA_COUNT];
-    unsigned int texture2D_rejection[CAMERA_COUNT];
+    unsigned int fbo_rejection[MAX_CAMERA_COUNT];
+    unsigned int texture2D_rejection[MAX_CAMERA_COUNT];
 
     // The fbo and texture for the edge proximity pass:
-    unsigned int fbo_edgeProximity[CAMERA_COUNT];
-    unsigned int texture2D_edgeProximity[CAMERA_COUNT];
+    unsigned int fbo_edgeProximity[MAX_CAMERA_COUNT];
+    unsigned int texture2D_edgeProximity[MAX_CAMERA_COUNT];
+
+    // Ping pong seed maps of the jump flooding of the edge proximity (shared by all cameras):
+    unsigned int fbo_edgeSeeds[2] = {};
+    unsigned int texture2D_edgeSeeds[2] = {};
+    int edgeSeedsWidth = 0;
+    int edgeSeedsHeight = 0;
 
     // The fbo and texture for the mls pass:
-    unsigned int fbo_mls[CAMERA_COUNT];
-    unsigned int texture2D_mlsVertices[CAMERA_COUNT];
+    unsigned int fbo_mls[MAX_CAMERA_COUNT];
+    unsigned int texture2D_mlsVertices[MAX_CAMERA_COUNT];
+
+    // Result of the first (horizontal) pass of the separable mls:
+    unsigned int fbo_mlsHorizontal[MAX_CAMERA_COUNT];
+    unsigned int texture2D_mlsHorizontal[MAX_CAMERA_COUNT];
 
     // The fbo and texture for the normal estimation pass:
-    unsigned int fbo_normals[CAMERA_COUNT];
-    unsigned int texture2D_normals[CAMERA_COUNT];
+    unsigned int fbo_normals[MAX_CAMERA_COUNT];
+    unsigned int texture2D_normals[MAX_CAMERA_COUNT];
 
     // The fbo and texture for the quality estimation pass:
-    unsigned int fbo_qualityEstimate[CAMERA_COUNT];
-    unsigned int texture2D_qualityEstimate[CAMERA_COUNT];
+    unsigned int fbo_qualityEstimate[MAX_CAMERA_COUNT];
+    unsigned int texture2D_qualityEstimate[MAX_CAMERA_COUNT];
 
     // Vertex shadow map (2. Pass):
-    unsigned int fbo_vertexShadowMap[CAMERA_COUNT];
-    unsigned int texture2D_vertexShadowMap[CAMERA_COUNT];
+    unsigned int fbo_vertexShadowMap[MAX_CAMERA_COUNT];
+    unsigned int texture2D_vertexShadowMap[MAX_CAMERA_COUNT];
 
     // Ping Pong maps using the Jump Flooding algorithm:
     unsigned int fbo_jumpFloodingPing;
@@ -125,30 +187,30 @@ public:
     unsigned int texture2D_jumpFloodingPong;
 
     // Vertex distance map (3. Pass):
-    unsigned int fbo_vertexDistanceMap[CAMERA_COUNT];
-    unsigned int texture2D_vertexDistanceMap[CAMERA_COUNT];
+    unsigned int fbo_vertexDistanceMap[MAX_CAMERA_COUNT];
+    unsigned int texture2D_vertexDistanceMap[MAX_CAMERA_COUNT];
 
     // Global distance map (4. Pass):
-    unsigned int fbo_globalDistanceMap[CAMERA_COUNT];
-    unsigned int texture2D_globalDistanceMap[CAMERA_COUNT];
+    unsigned int fbo_globalDistanceMap[MAX_CAMERA_COUNT];
+    unsigned int texture2D_globalDistanceMap[MAX_CAMERA_COUNT];
 
     // Temporal distance map (5. Pass), flip flop approach:
-    unsigned int fbo_temporalDistanceMapA[CAMERA_COUNT];
-    unsigned int texture2D_temporalDistanceMapA[CAMERA_COUNT];
+    unsigned int fbo_temporalDistanceMapA[MAX_CAMERA_COUNT];
+    unsigned int texture2D_temporalDistanceMapA[MAX_CAMERA_COUNT];
 
-    unsigned int fbo_temporalDistanceMapB[CAMERA_COUNT];
-    unsigned int texture2D_temporalDistanceMapB[CAMERA_COUNT];
+    unsigned int fbo_temporalDistanceMapB[MAX_CAMERA_COUNT];
+    unsigned int texture2D_temporalDistanceMapB[MAX_CAMERA_COUNT];
 
     bool temporalDistanceFlipFlop = false;
 
     // Segmentation Downscaled pass:
-    unsigned int fbo_segmentationDownscale[CAMERA_COUNT];
-    unsigned int texture2D_segmentationID[CAMERA_COUNT];
-    unsigned int texture2D_segmentationShadowDistance[CAMERA_COUNT];
+    unsigned int fbo_segmentationDownscale[MAX_CAMERA_COUNT];
+    unsigned int texture2D_segmentationID[MAX_CAMERA_COUNT];
+    unsigned int texture2D_segmentationShadowDistance[MAX_CAMERA_COUNT];
 
     // Vertex Projector Assignment (6. Pass):
-    unsigned int fbo_vertexProjectorAssignment[CAMERA_COUNT];
-    unsigned int texture2D_vertexProjectorAssignment[CAMERA_COUNT];
+    unsigned int fbo_vertexProjectorAssignment[MAX_CAMERA_COUNT];
+    unsigned int texture2D_vertexProjectorAssignment[MAX_CAMERA_COUNT];
 
     /**
      * Defines the mesh
@@ -170,28 +232,189 @@ public:
 
     std::vector<unsigned int> usedCameraIDs;
 
+    /**
+     * Number of camera slots used by the screen passes this frame (highest used
+     * camera ID + 1, 0 if no camera is available).
+     */
+    int cameraCount = 0;
+
     bool useReimplementedFilters = true;
+
+    /** Uploads depth and colors through the pixel buffer rings (otherwise directly from the point clouds) */
+    bool usePixelBufferUpload = true;
+
+    /**
+     * Runs vertex generation and the reimplemented filters as two fused
+     * compute dispatches (if supported, see isComputeFilteringSupported)
+     * instead of four fragment passes.
+     */
+    bool useComputeFilters = true;
+
+    MLSMode mlsMode = MLS_EXACT;
+
+    NormalsMode normalsMode = NORMALS_EIGEN_SOLVER;
+
+    /** Distance to rejected pixels (in pixels) at which the edge proximity falls to 0 */
+    int edgeProximityRadius = 5;
+
+    /** Radius of the window the normals are estimated from (in pixels) */
+    int normalRadius = 2;
+
     bool shouldClip = false;
 
     Vec4f clipMin = Vec4f(-1.0f, 0.05f, -1.0, 0.0);
     Vec4f clipMax = Vec4f(1.0f, 2.0f, 1.0, 0.0);
 
+    /**
+     * Recomputes MLS, normals and quality estimate only in the tiles in which
+     * the depth changed (see DirtyTileMask), the previous results are kept in
+     * the other tiles.
+     */
+    bool useDirtyTiles = false;
+
+    DirtyTileMask::Settings dirtyTileSettings;
+
 
 private:
     // Global PCTextureProcessor:
     static CameraPasses* globalCameraPasses;
 
-    // Semaphore which checks if a switch of the current PBO is
-    // allowed (this is the case as long as PBOs are not getting
-    // copied into the textures):
-    Semaphore switchCurrentPBOSemaphore = Semaphore(1);
+    // Unpack buffers for depth and colors of each camera (depth at offset 0, colors behind it):
+    PixelUploadRing uploadRings[MAX_CAMERA_COUNT];
 
     float implicitH = 0.01f;
     float kernelRadius = 10.f;
     float kernelSpread = 1.f;
 
+    /** Time of the depth and color uploads on the render thread (ms, smoothed) */
     float uploadTime = 0;
 
+    /** Tiles of each camera whose results have to be recomputed this frame */
+    DirtyTileMask dirtyTileMasks[MAX_CAMERA_COUNT];
+
+    /** Compute variants of vertex generation + hole filling + noise removal and of the erosion (nullptr if unsupported) */
+    std::unique_ptr<ComputeShader> fusedFilterShader;
+    std::unique_ptr<ComputeShader> erosionComputeShader;
+    bool computeFiltersChecked = false;
+
+    /**
+     * Textures and readbacks of a comparison between the fragment and the
+     * compute filters (both run on the same input in one frame).
+     */
+    struct FilterComparison {
+        int cameraID = -1;
+        int width = 0;
+        int height = 0;
+
+        unsigned int texture2D_temporal = 0;
+        unsigned int texture2D_colors = 0;
+        unsigned int texture2D_eroded = 0;
+
+        int pendingReadbacks = 0;
+        std::vector<uint8_t> fragmentVertices;
+        std::vector<uint8_t> computeVertices;
+        std::vector<uint8_t> fragmentColors;
+        std::vector<uint8_t> computeColors;
+    };
+
+    FilterComparison filterComparison;
+    bool filterComparisonRequested = false;
+    std::string filterComparisonResult;
+
+    /**
+     * Measurement of the error of the fast MLS modes: the exact MLS is
+     * rendered into a reference texture in the same frame.
+     */
+    struct MLSQualityMeasurement {
+        int cameraID = -1;
+        MLSMode mode = MLS_EXACT;
+        int width = 0;
+        int height = 0;
+
+        unsigned int fbo_reference = 0;
+        unsigned int texture2D_reference = 0;
+
+        int pendingReadbacks = 0;
+        std::vector<uint8_t> referenceVertices;
+        std::vector<uint8_t> vertices;
+    };
+
+    MLSQualityMeasurement mlsQualityMeasurement;
+    bool mlsQualityRequested = false;
+    std::string mlsQualityResult;
+
+    /**
+     * Comparison of the results kept by the dirty tiles with a full
+     * recomputation: the MLS of one camera is additionally rendered for the
+     * whole image over DIRTY_TILE_COMPARISON_FRAMES frames (e.g. while the
+     * temporal filter settles after a step change) and read back each frame.
+     */
+    struct DirtyTileComparison {
+        int cameraID = -1;
+        int width = 0;
+        int height = 0;
+        float noiseAtOneMeter = 0.f;
+
+        unsigned int fbo_reference = 0;
+        unsigned int texture2D_reference = 0;
+
+        int framesLeft = 0;
+        int pendingReadbacks = 0;
+
+        int comparedFrames = 0;
+        size_t comparedVertices = 0;
+        size_t verticesAboveNoise = 0;
+        double squaredErrorSum = 0.0;
+        float maxError = 0.f;
+    };
+
+    static constexpr int DIRTY_TILE_COMPARISON_FRAMES = 120;
+
+    DirtyTileComparison dirtyTileComparison;
+    bool dirtyTileComparisonRequested = false;
+    std::string dirtyTileComparisonResult;
+
+    /** Threads per row / column of the summed-area tables, which can be up to 4 times as long */
+    static constexpr int NORMAL_SUMS_SCAN_THREADS = 256;
+
+    /** Summed-area table passes of the normals (nullptr if compute shaders are unsupported) */
+    std::unique_ptr<ComputeShader> normalSumsRowShader;
+    std::unique_ptr<ComputeShader> normalSumsColumnShader;
+    bool summedAreaNormalsChecked = false;
+
+    /**
+     * Summed-area tables of the normals, shared by all cameras (they are built
+     * and used by one camera after the other): (count, x, y, z), (xx, xy, xz, yy)
+     * and (yz, zz) of the quantized vertices.
+     */
+    unsigned int texture2D_normalSumsA = 0;
+    unsigned int texture2D_normalSumsB = 0;
+    unsigned int texture2D_normalSumsC = 0;
+    int normalSumsWidth = 0;
+    int normalSumsHeight = 0;
+
+    /**
+     * Comparison of the normal modes: both are rendered for one camera into
+     * own textures in the same frame, timed and read back.
+     */
+    struct NormalsComparison {
+        int cameraID = -1;
+        int width = 0;
+        int height = 0;
+        int radius = 0;
+
+        unsigned int fbo[NORMALS_MODE_COUNT] = {};
+        unsigned int texture2D_normals[NORMALS_MODE_COUNT] = {};
+
+        int pendingReadbacks = 0;
+        std::vector<uint8_t> normals[NORMALS_MODE_COUNT];
+        std::vector<uint8_t> mlsVertices;
+    };
+
+    NormalsComparison normalsComparison;
+    bool normalsComparisonRequested = false;
+    std::string normalsComparisonResult;
+
     /**
      * Define all the shaders for the reimplemented point cloud filters
      * (originally CUDA implemented):
@@ -208,8 +431,12 @@ private:
      */
     Shader rejectionShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/rejection.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/rejection.frag");
     Shader edgeProximityShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeProximity.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeProximity.frag");
+    Shader edgeSeedsShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeProximity.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeSeeds.frag");
+    Shader edgeJumpFloodShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeProximity.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/edgeJumpFlood.frag");
     Shader mlsShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/mls.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/mls.frag");
+    Shader mlsSeparableShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/mls.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/mlsSeparable.frag");
     Shader normalsShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normals.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normals.frag");
+    Shader normalsSummedAreaShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normals.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normalsSummedArea.frag");
     Shader qualityEstimateShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/qualityEstimate.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/qualityEstimate.frag");
 
     bool isInitialized = false;
@@ -292,6 +519,9 @@ private:
             // Input lookup table
             generateAndBind2DTexture(texture2D_inputLookupImageTo3D[deviceIndex], imageWidth, imageHeight, GL_RG32F, GL_RG, GL_FLOAT, GL_LINEAR);
             generateAndBind2DTexture(texture2D_inputLookup3DToImage[deviceIndex], LOOKUP_IMAGE_SIZE, LOOKUP_IMAGE_SIZE, GL_RG32F, GL_RG, GL_FLOAT, GL_LINEAR);
+
+            // Unpack buffers for depth and colors:
+            uploadRings[deviceIndex].init(uploadColorOffset(imageWidth, imageHeight) + size_t(imageWidth) * imageHeight * sizeof(Vec4b));
         }
 
         /**
@@ -376,9 +606,9 @@ private:
              *
              * A red-value of 0 means far away from edge, 1 means on edge.
              *
-             * The kernelRadius (uniform var) defines the search radius.
-             * Vertices which are more than [kernelRadius] units away from
-             * invalid pixels get the value 0.
+             * The edgeProximityRadius defines the search radius.
+             * Vertices which are more than [edgeProximityRadius] pixels away
+             * from invalid pixels get the value 0.
              */
         {
             glGenFramebuffers(1, &fbo_edgeProximity[deviceIndex]);
@@ -416,6 +646,13 @@ private:
 
             generateAndBind2DTexture(texture2D_mlsVertices[deviceIndex], imageWidth, imageHeight, GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_mlsVertices[deviceIndex], 0);
+
+            // Intermediate result of the separable mls:
+            glGenFramebuffers(1, &fbo_mlsHorizontal[deviceIndex]);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_mlsHorizontal[deviceIndex]);
+
+            generateAndBind2DTexture(texture2D_mlsHorizontal[deviceIndex], imageWidth, imageHeight, GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_mlsHorizontal[deviceIndex], 0);
         }
 
         /**
@@ -512,6 +749,10 @@ private:
         cameraWidth[deviceIndex] = -1;
         cameraHeight[deviceIndex] = -1;
 
+        // The lookup textures are recreated, so upload the tables again:
+        uploadedLookupImageTo3D[deviceIndex] = nullptr;
+        uploadedLookup3DToImage[deviceIndex] = nullptr;
+
         glDeleteFramebuffers(1, &fbo_pcf_holeFilling[deviceIndex]);
         glDeleteTextures(1, &texture2D_pcf_holeFilledVertices[deviceIndex]);
         glDeleteTextures(1, &texture2D_pcf_holeFilledRGB[deviceIndex]);
@@ -524,10 +765,13 @@ private:
         glDeleteFramebuffers(1, &fbo_pcf_temporalFilterB[deviceIndex]);
         glDeleteTextures(1, &texture2D_pcf_temporalFilterB[deviceIndex]);
 
+        glDeleteFramebuffers(1, &fbo_genVertices[deviceIndex]);
         glDeleteTextures(1, &texture2D_inputGenVertices[deviceIndex]);
         glDeleteTextures(1, &texture2D_inputDepth[deviceIndex]);
         glDeleteTextures(1, &texture2D_inputRGB[deviceIndex]);
         glDeleteTextures(1, &texture2D_inputLookupImageTo3D[deviceIndex]);
+        glDeleteTextures(1, &texture2D_inputLookup3DToImage[deviceIndex]);
+        uploadRings[deviceIndex].release();
 
         glDeleteFramebuffers(1, &fbo_rejection[deviceIndex]);
         glDeleteTextures(1, &texture2D_rejection[deviceIndex]);
@@ -538,11 +782,38 @@ private:
         glDeleteFramebuffers(1, &fbo_mls[deviceIndex]);
         glDeleteTextures(1, &texture2D_mlsVertices[deviceIndex]);
 
+        glDeleteFramebuffers(1, &fbo_mlsHorizontal[deviceIndex]);
+        glDeleteTextures(1, &texture2D_mlsHorizontal[deviceIndex]);
+
         glDeleteFramebuffers(1, &fbo_normals[deviceIndex]);
         glDeleteTextures(1, &texture2D_normals[deviceIndex]);
 
         glDeleteFramebuffers(1, &fbo_qualityEstimate[deviceIndex]);
         glDeleteTextures(1, &texture2D_qualityEstimate[deviceIndex]);
+
+        // Shadow avoidance maps:
+        glDeleteFramebuffers(1, &fbo_vertexShadowMap[deviceIndex]);
+        glDeleteTextures(1, &texture2D_vertexShadowMap[deviceIndex]);
+
+        glDeleteFramebuffers(1, &fbo_vertexDistanceMap[deviceIndex]);
+        glDeleteTextures(1, &texture2D_vertexDistanceMap[deviceIndex]);
+
+        glDeleteFramebuffers(1, &fbo_globalDistanceMap[deviceIndex]);
+        glDeleteTextures(1, &texture2D_globalDistanceMap[deviceIndex]);
+
+        glDeleteFramebuffers(1, &fbo_temporalDistanceMapA[deviceIndex]);
+        glDeleteTextures(1, &texture2D_temporalDistanceMapA[deviceIndex]);
+        glDeleteFramebuffers(1, &fbo_temporalDistanceMapB[deviceIndex]);
+        glDeleteTextures(1, &texture2D_temporalDistanceMapB[deviceIndex]);
+
+        glDeleteFramebuffers(1, &fbo_segmentationDownscale[deviceIndex]);
+        glDeleteTextures(1, &texture2D_segmentationID[deviceIndex]);
+        glDeleteTextures(1, &texture2D_segmentationShadowDistance[deviceIndex]);
+
+        glDeleteFramebuffers(1, &fbo_vertexProjectorAssignment[deviceIndex]);
+        glDeleteTextures(1, &texture2D_vertexProjectorAssignment[deviceIndex]);
+
+        dirtyTileMasks[deviceIndex].release();
     }
 
     void init(){
@@ -571,12 +842,971 @@ private:
         isInitialized = true;
     }
 
+    /** Offset of the colors in the unpack buffers (behind the depth image) */
+    static size_t uploadColorOffset(unsigned int width, unsigned int height){
+        size_t depthSize = size_t(width) * height * sizeof(uint16_t);
+        return (depthSize + 255) / 256 * 256;
+    }
+
+    /** Uploads depth and colors with glTexSubImage2D from the memory of the point clouds */
+    void uploadDirectly(const std::vector<unsigned int>& cameraIDs){
+        for(unsigned int cameraID : cameraIDs){
+            std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+
+            if(currentPC->depth != nullptr){
+                glBindTexture(GL_TEXTURE_2D, texture2D_inputDepth[cameraID]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RED_INTEGER, GL_UNSIGNED_SHORT, currentPC->depth);
+            }
+
+            if(currentPC->colors != nullptr){
+                glBindTexture(GL_TEXTURE_2D, texture2D_inputRGB[cameraID]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA, GL_UNSIGNED_BYTE, currentPC->colors);
+            }
+        }
+    }
+
+    /**
+     * Copies depth and colors of all cameras into their unpack buffers (in
+     * parallel on the worker pool) and lets the driver copy them into the
+     * textures asynchronously.
+     */
+    void uploadThroughPixelBuffers(const std::vector<unsigned int>& cameraIDs){
+        struct Copy {
+            uint8_t* destination;
+            const uint8_t* source;
+            size_t size;
+        };
+
+        // Copies are split, so that a single camera is copied by several workers:
+        const size_t COPY_CHUNK_SIZE = 256 * 1024;
+
+        std::vector<Copy> copies;
+        std::vector<unsigned int> mappedCameraIDs;
+        std::vector<unsigned int> directCameraIDs;
+
+        auto addCopy = [&copies, COPY_CHUNK_SIZE](uint8_t* destination, const void* source, size_t size){
+            for(size_t offset = 0; offset < size; offset += COPY_CHUNK_SIZE)
+                copies.push_back({destination + offset, static_cast<const uint8_t*>(source) + offset, std::min(COPY_CHUNK_SIZE, size - offset)});
+        };
+
+        for(unsigned int cameraID : cameraIDs){
+            std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+
+            uint8_t* mapped = uploadRings[cameraID].map();
+            if(mapped == nullptr){
+                directCameraIDs.push_back(cameraID);
+                continue;
+            }
+            mappedCameraIDs.push_back(cameraID);
+
+            size_t pixelCount = size_t(cameraWidth[cameraID]) * cameraHeight[cameraID];
+            if(currentPC->depth != nullptr)
+                addCopy(mapped, currentPC->depth, pixelCount * sizeof(uint16_t));
+            if(currentPC->colors != nullptr)
+                addCopy(mapped + uploadColorOffset(cameraWidth[cameraID], cameraHeight[cameraID]), currentPC->colors, pixelCount * sizeof(Vec4b));
+        }
+
+        WorkerPool::getInstance().parallelFor(0, int(copies.size()), [&copies](int i){
+            std::memcpy(copies[i].destination, copies[i].source, copies[i].size);
+        });
+
+        for(unsigned int cameraID : mappedCameraIDs){
+            std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+
+            if(!uploadRings[cameraID].bind()){
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                directCameraIDs.push_back(cameraID);
+                continue;
+            }
+
+            if(currentPC->depth != nullptr){
+                glBindTexture(GL_TEXTURE_2D, texture2D_inputDepth[cameraID]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+            }
+
+            if(currentPC->colors != nullptr){
+                glBindTexture(GL_TEXTURE_2D, texture2D_inputRGB[cameraID]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA, GL_UNSIGNED_BYTE,
+                                reinterpret_cast<const void*>(uploadColorOffset(cameraWidth[cameraID], cameraHeight[cameraID])));
+            }
+
+            uploadRings[cameraID].commit();
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        // Buffers which could not be mapped (or lost their content):
+        uploadDirectly(directCameraIDs);
+    }
+
+    /** Binds the inputs of the camera and runs vertex generation, hole filling and noise removal in one dispatch */
+    void dispatchFusedFilters(unsigned int cameraID, unsigned int previousTexture, unsigned int temporalTexture, unsigned int colorTexture){
+        fusedFilterShader->bind();
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2D_inputDepth[cameraID]);
+        fusedFilterShader->setUniform("depthTexture", 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
+        fusedFilterShader->setUniform("lookupTexture", 2);
+
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, texture2D_inputRGB[cameraID]);
+        fusedFilterShader->setUniform("colorTexture", 3);
+
+        ComputeShader::bindImage(0, previousTexture, GL_READ_ONLY, GL_RGBA32F);
+        ComputeShader::bindImage(1, temporalTexture, GL_WRITE_ONLY, GL_RGBA32F);
+        ComputeShader::bindImage(2, colorTexture, GL_WRITE_ONLY, GL_RGBA8);
+
+        ComputeShader::dispatch((cameraWidth[cameraID] + FILTER_TILE_SIZE - 1) / FILTER_TILE_SIZE, (cameraHeight[cameraID] + FILTER_TILE_SIZE - 1) / FILTER_TILE_SIZE);
+    }
+
+    void dispatchErosion(unsigned int cameraID, unsigned int inputTexture, unsigned int erodedTexture){
+        erosionComputeShader->bind();
+
+        ComputeShader::bindImage(0, inputTexture, GL_READ_ONLY, GL_RGBA32F);
+        ComputeShader::bindImage(1, erodedTexture, GL_WRITE_ONLY, GL_RGBA32F);
+
+        ComputeShader::dispatch((cameraWidth[cameraID] + FILTER_TILE_SIZE - 1) / FILTER_TILE_SIZE, (cameraHeight[cameraID] + FILTER_TILE_SIZE - 1) / FILTER_TILE_SIZE);
+    }
+
+    /**
+     * Compute path of vertex generation and the reimplemented filters (same
+     * results as the fragment passes). The intermediate vertices stay in
+     * shared memory, only the temporal filter state, the filled colors and
+     * the eroded vertices are written.
+     */
+    void runComputeFilters(const std::vector<unsigned int>& cameraIDs){
+        for(unsigned int cameraID : cameraIDs){
+            unsigned int previousTexture = temporalFilterFlipFlop[cameraID] ? texture2D_pcf_temporalFilterA[cameraID] : texture2D_pcf_temporalFilterB[cameraID];
+            unsigned int writtenTexture = temporalFilterFlipFlop[cameraID] ? texture2D_pcf_temporalFilterB[cameraID] : texture2D_pcf_temporalFilterA[cameraID];
+
+            dispatchFusedFilters(cameraID, previousTexture, writtenTexture, texture2D_pcf_holeFilledRGB[cameraID]);
+
+            currentProcessedVertices[cameraID] = writtenTexture;
+            temporalFilterFlipFlop[cameraID] = !temporalFilterFlipFlop[cameraID];
+        }
+
+        ComputeShader::memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        for(unsigned int cameraID : cameraIDs){
+            dispatchErosion(cameraID, currentProcessedVertices[cameraID], texture2D_pcf_erosion[cameraID]);
+            currentProcessedVertices[cameraID] = texture2D_pcf_erosion[cameraID];
+        }
+
+        // The following passes sample the results (and the next frame reads the temporal state):
+        ComputeShader::memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    }
+
+    /**
+     * Runs the compute filters for the camera into separate textures, on the
+     * same input (and temporal state) the fragment passes use in this frame.
+     */
+    void startFilterComparison(unsigned int cameraID){
+        filterComparison = FilterComparison();
+        filterComparison.cameraID = int(cameraID);
+        filterComparison.width = cameraWidth[cameraID];
+        filterComparison.height = cameraHeight[cameraID];
+
+        generateAndBind2DTexture(filterComparison.texture2D_temporal, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        generateAndBind2DTexture(filterComparison.texture2D_colors, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_LINEAR);
+        generateAndBind2DTexture(filterComparison.texture2D_eroded, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+
+        unsigned int previousTexture = temporalFilterFlipFlop[cameraID] ? texture2D_pcf_temporalFilterA[cameraID] : texture2D_pcf_temporalFilterB[cameraID];
+        dispatchFusedFilters(cameraID, previousTexture, filterComparison.texture2D_temporal, filterComparison.texture2D_colors);
+        ComputeShader::memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        dispatchErosion(cameraID, filterComparison.texture2D_temporal, filterComparison.texture2D_eroded);
+        ComputeShader::memoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    }
+
+    /** Reads back the results of both paths (after the fragment passes ran) */
+    void readFilterComparison(){
+        int cameraID = filterComparison.cameraID;
+        size_t pixelCount = size_t(filterComparison.width) * filterComparison.height;
+
+        auto readInto = [this](unsigned int texture, GLenum type, size_t size, std::vector<uint8_t> FilterComparison::*target){
+            ++filterComparison.pendingReadbacks;
+            AsyncReadback::getInstance().read(texture, 0, GL_RGBA, type, size, [this, target](const void* data, size_t size){
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                (filterComparison.*target).assign(bytes, bytes + size);
+
+                if(--filterComparison.pendingReadbacks == 0)
+                    finishFilterComparison();
+            });
+        };
+
+        readInto(texture2D_pcf_erosion[cameraID], GL_FLOAT, pixelCount * 4 * sizeof(float), &FilterComparison::fragmentVertices);
+        readInto(filterComparison.texture2D_eroded, GL_FLOAT, pixelCount * 4 * sizeof(float), &FilterComparison::computeVertices);
+        readInto(texture2D_pcf_holeFilledRGB[cameraID], GL_UNSIGNED_BYTE, pixelCount * 4, &FilterComparison::fragmentColors);
+        readInto(filterComparison.texture2D_colors, GL_UNSIGNED_BYTE, pixelCount * 4, &FilterComparison::computeColors);
+    }
+
+    /** Compares the read back results pixel by pixel and releases the comparison textures */
+    void finishFilterComparison(){
+        size_t pixelCount = size_t(filterComparison.width) * filterComparison.height;
+
+        size_t differentVertices = 0;
+        float maxVertexDifference = 0.f;
+        const float* fragmentVertices = reinterpret_cast<const float*>(filterComparison.fragmentVertices.data());
+        const float* computeVertices = reinterpret_cast<const float*>(filterComparison.computeVertices.data());
+
+        for(size_t i = 0; i < pixelCount; ++i){
+            if(std::memcmp(fragmentVertices + i * 4, computeVertices + i * 4, 3 * sizeof(float)) == 0)
+                continue;
+
+            ++differentVertices;
+            for(int c = 0; c < 3; ++c){
+                float difference = std::abs(fragmentVertices[i * 4 + c] - computeVertices[i * 4 + c]);
+                if(!std::isnan(difference))
+                    maxVertexDifference = std::max(maxVertexDifference, difference);
+            }
+        }
+
+        size_t differentColors = 0;
+        int maxColorDifference = 0;
+        for(size_t i = 0; i < pixelCount; ++i){
+            bool different = false;
+            for(int c = 0; c < 4; ++c){
+                int difference = std::abs(int(filterComparison.fragmentColors[i * 4 + c]) - int(filterComparison.computeColors[i * 4 + c]));
+                maxColorDifference = std::max(maxColorDifference, difference);
+                different |= difference != 0;
+            }
+            differentColors += different ? 1 : 0;
+        }
+
+        char result[256];
+        std::snprintf(result, sizeof(result), "Camera %i: %zu of %zu vertices differ (max. %.6f m), %zu colors differ (max. %i)",
+                      filterComparison.cameraID, differentVertices, pixelCount, maxVertexDifference, differentColors, maxColorDifference);
+        filterComparisonResult = result;
+        std::cout << "Filter comparison (fragment vs. compute): " << filterComparisonResult << std::endl;
+
+        glDeleteTextures(1, &filterComparison.texture2D_temporal);
+        glDeleteTextures(1, &filterComparison.texture2D_colors);
+        glDeleteTextures(1, &filterComparison.texture2D_eroded);
+        filterComparison = FilterComparison();
+    }
+
+    /** Everything besides the depth that changes the results of the camera (all tiles are recomputed if one of them changes) */
+    std::vector<float> getDirtyTileDependencies(unsigned int cameraID) const {
+        std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+
+        std::vector<float> dependencies = {
+            implicitH, kernelRadius, kernelSpread, float(mlsMode), float(normalsMode), float(normalRadius), float(edgeProximityRadius),
+            float(useReimplementedFilters), float(useComputeFilters), float(shouldClip),
+            clipMin.x, clipMin.y, clipMin.z, clipMax.x, clipMax.y, clipMax.z,
+            float(currentPC->usageFlags & CAMERA_RESPONSIBILITY_RECTIFICATION)
+        };
+        dependencies.insert(dependencies.end(), currentPC->modelMatrix.data, currentPC->modelMatrix.data + 16);
+        dependencies.insert(dependencies.end(), Data::instance.virtualDisplayTransform.data, Data::instance.virtualDisplayTransform.data + 16);
+        return dependencies;
+    }
+
+    /** Compares the new depth images with the ones of the last recomputation of each tile */
+    void updateDirtyTiles(const std::vector<unsigned int>& cameraIDs){
+        for(unsigned int cameraID : cameraIDs){
+            if(!useDirtyTiles){
+                dirtyTileMasks[cameraID].invalidate();
+                continue;
+            }
+
+            // The temporal filter is part of the reimplemented filters:
+            DirtyTileMask::Settings settings = dirtyTileSettings;
+            if(!useReimplementedFilters)
+                settings.settleFrames = 0;
+
+            std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+            dirtyTileMasks[cameraID].update(currentPC->depth, cameraWidth[cameraID], cameraHeight[cameraID], getDirtyTileRadius(),
+                                            getDirtyTileDependencies(cameraID), settings, false);
+        }
+    }
+
+    /** Whether the results of the camera have to be (partially) recomputed this frame */
+    bool hasDirtyTiles(unsigned int cameraID) const {
+        return !useDirtyTiles || dirtyTileMasks[cameraID].hasDirtyTiles();
+    }
+
+    /** Draws the fullscreen quad, or only the dirty tiles of the camera */
+    void drawCameraQuad(unsigned int cameraID, bool dirtyTilesOnly){
+        if(dirtyTilesOnly && useDirtyTiles && !dirtyTileMasks[cameraID].isFullyDirty()){
+            dirtyTileMasks[cameraID].draw();
+            return;
+        }
+
+        glBindVertexArray(VAO_quad);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+    /** Renders the MLS of the camera into the fbo, sampling every sampleStride-th row and column of the window */
+    void renderMLS(unsigned int cameraID, unsigned int fbo, int sampleStride, bool dirtyTilesOnly = false){
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        mlsShader.bind();
+
+        mlsShader.setUniform("kernelRadius", kernelRadius);
+        mlsShader.setUniform("kernelSpread", kernelSpread);
+        mlsShader.setUniform("p_h", implicitH);
+        mlsShader.setUniform("sampleStride", sampleStride);
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, currentProcessedVertices[cameraID]);
+        mlsShader.setUniform("pointCloud", 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
+        mlsShader.setUniform("edgeProximity", 2);
+
+        drawCameraQuad(cameraID, dirtyTilesOnly);
+    }
+
+    /** Renders the MLS of the camera into the fbo as a horizontal and a vertical 1D pass */
+    void renderSeparableMLS(unsigned int cameraID, unsigned int fbo, bool dirtyTilesOnly = false){
+        unsigned int inputs[2] = { currentProcessedVertices[cameraID], texture2D_mlsHorizontal[cameraID] };
+        unsigned int fbos[2] = { fbo_mlsHorizontal[cameraID], fbo };
+        Vec4f directions[2] = { Vec4f(1.f, 0.f, 0.f, 0.f), Vec4f(0.f, 1.f, 0.f, 0.f) };
+
+        for(int pass = 0; pass < 2; ++pass){
+            glBindFramebuffer(GL_FRAMEBUFFER, fbos[pass]);
+            mlsSeparableShader.bind();
+
+            mlsSeparableShader.setUniform("p_h", implicitH);
+            mlsSeparableShader.setUniform("direction", directions[pass], 2);
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, inputs[pass]);
+            mlsSeparableShader.setUniform("pointCloud", 1);
+
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
+            mlsSeparableShader.setUniform("edgeProximity", 2);
+
+            drawCameraQuad(cameraID, dirtyTilesOnly);
+        }
+    }
+
+    /**
+     * Renders the exact MLS of the camera into a reference texture and reads
+     * it back together with the result of the current mode.
+     */
+    void measureMLSQuality(unsigned int cameraID){
+        mlsQualityMeasurement = MLSQualityMeasurement();
+        mlsQualityMeasurement.cameraID = int(cameraID);
+        mlsQualityMeasurement.mode = mlsMode;
+        mlsQualityMeasurement.width = cameraWidth[cameraID];
+        mlsQualityMeasurement.height = cameraHeight[cameraID];
+
+        glGenFramebuffers(1, &mlsQualityMeasurement.fbo_reference);
+        glBindFramebuffer(GL_FRAMEBUFFER, mlsQualityMeasurement.fbo_reference);
+        generateAndBind2DTexture(mlsQualityMeasurement.texture2D_reference, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mlsQualityMeasurement.texture2D_reference, 0);
+
+        glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
+        renderMLS(cameraID, mlsQualityMeasurement.fbo_reference, 1);
+
+        size_t size = size_t(cameraWidth[cameraID]) * cameraHeight[cameraID] * 3 * sizeof(float);
+        auto readInto = [this, size](unsigned int texture, std::vector<uint8_t> MLSQualityMeasurement::*target){
+            ++mlsQualityMeasurement.pendingReadbacks;
+            AsyncReadback::getInstance().read(texture, 0, GL_RGB, GL_FLOAT, size, [this, target](const void* data, size_t size){
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                (mlsQualityMeasurement.*target).assign(bytes, bytes + size);
+
+                if(--mlsQualityMeasurement.pendingReadbacks == 0)
+                    finishMLSQualityMeasurement();
+            });
+        };
+
+        readInto(mlsQualityMeasurement.texture2D_reference, &MLSQualityMeasurement::referenceVertices);
+        readInto(texture2D_mlsVertices[cameraID], &MLSQualityMeasurement::vertices);
+    }
+
+    /** Computes the error of the fast MLS against the exact one (on vertices the exact MLS keeps) */
+    void finishMLSQualityMeasurement(){
+        size_t pixelCount = size_t(mlsQualityMeasurement.width) * mlsQualityMeasurement.height;
+        const float* reference = reinterpret_cast<const float*>(mlsQualityMeasurement.referenceVertices.data());
+        const float* vertices = reinterpret_cast<const float*>(mlsQualityMeasurement.vertices.data());
+
+        std::vector<float> errors;
+        double squaredErrorSum = 0.0;
+        for(size_t i = 0; i < pixelCount; ++i){
+            const float* r = reference + i * 3;
+            const float* v = vertices + i * 3;
+
+            // Edge vertices (z = -1), failed ones (z = 10) and invalid ones are not smoothed:
+            if(!(r[2] > 0.f && r[2] < 10.f) || std::isnan(r[0]) || std::isnan(v[0]))
+                continue;
+
+            float error = std::sqrt((r[0] - v[0]) * (r[0] - v[0]) + (r[1] - v[1]) * (r[1] - v[1]) + (r[2] - v[2]) * (r[2] - v[2])) * 1000.f;
+            errors.push_back(error);
+            squaredErrorSum += double(error) * error;
+        }
+
+        if(errors.empty()){
+            mlsQualityResult = "No smoothed vertices to compare.";
+        } else {
+            std::sort(errors.begin(), errors.end());
+            float rmse = float(std::sqrt(squaredErrorSum / errors.size()));
+            float p95 = errors[std::min(errors.size() - 1, errors.size() * 95 / 100)];
+
+            char result[256];
+            std::snprintf(result, sizeof(result), "Camera %i, %s vs. exact: RMSE %.3f mm, p95 %.3f mm, max. %.3f mm (%zu vertices)",
+                          mlsQualityMeasurement.cameraID, getMLSModeName(mlsQualityMeasurement.mode), rmse, p95, errors.back(), errors.size());
+            mlsQualityResult = result;
+        }
+        std::cout << "MLS quality: " << mlsQualityResult << std::endl;
+
+        glDeleteFramebuffers(1, &mlsQualityMeasurement.fbo_reference);
+        glDeleteTextures(1, &mlsQualityMeasurement.texture2D_reference);
+        mlsQualityMeasurement = MLSQualityMeasurement();
+    }
+
+    void startDirtyTileComparison(unsigned int cameraID){
+        if(!useDirtyTiles){
+            dirtyTileComparisonResult = "Dirty tiles are not used.";
+            return;
+        }
+
+        dirtyTileComparison = DirtyTileComparison();
+        dirtyTileComparison.cameraID = int(cameraID);
+        dirtyTileComparison.width = cameraWidth[cameraID];
+        dirtyTileComparison.height = cameraHeight[cameraID];
+        dirtyTileComparison.noiseAtOneMeter = dirtyTileSettings.noiseAtOneMeter;
+        dirtyTileComparison.framesLeft = DIRTY_TILE_COMPARISON_FRAMES;
+
+        glGenFramebuffers(1, &dirtyTileComparison.fbo_reference);
+        glBindFramebuffer(GL_FRAMEBUFFER, dirtyTileComparison.fbo_reference);
+        generateAndBind2DTexture(dirtyTileComparison.texture2D_reference, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dirtyTileComparison.texture2D_reference, 0);
+
+        dirtyTileComparisonResult = "Comparing...";
+    }
+
+    /** Renders the MLS of the compared camera for all tiles and reads it back with the kept results */
+    void compareDirtyTiles(){
+        unsigned int cameraID = dirtyTileComparison.cameraID;
+        if(cameraWidth[cameraID] != dirtyTileComparison.width || cameraHeight[cameraID] != dirtyTileComparison.height || !useDirtyTiles){
+            dirtyTileComparison.framesLeft = 0;
+            if(dirtyTileComparison.pendingReadbacks == 0)
+                finishDirtyTileComparison();
+            return;
+        }
+
+        glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
+        if(mlsMode == MLS_SEPARABLE){
+            renderSeparableMLS(cameraID, dirtyTileComparison.fbo_reference);
+        } else {
+            renderMLS(cameraID, dirtyTileComparison.fbo_reference, mlsMode == MLS_STRIDED ? 2 : 1);
+        }
+        --dirtyTileComparison.framesLeft;
+
+        // Both readbacks of this frame are compared once they arrived:
+        struct FrameReadback {
+            std::vector<uint8_t> referenceVertices;
+            std::vector<uint8_t> vertices;
+            int pending = 2;
+        };
+        std::shared_ptr<FrameReadback> frame = std::make_shared<FrameReadback>();
+
+        size_t size = size_t(cameraWidth[cameraID]) * cameraHeight[cameraID] * 3 * sizeof(float);
+        auto readInto = [this, size, frame](unsigned int texture, std::vector<uint8_t> FrameReadback::*target){
+            ++dirtyTileComparison.pendingReadbacks;
+            AsyncReadback::getInstance().read(texture, 0, GL_RGB, GL_FLOAT, size, [this, frame, target](const void* data, size_t size){
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                ((*frame).*target).assign(bytes, bytes + size);
+
+                if(--frame->pending == 0)
+                    accumulateDirtyTileErrors(reinterpret_cast<const float*>(frame->referenceVertices.data()), reinterpret_cast<const float*>(frame->vertices.data()));
+
+                if(--dirtyTileComparison.pendingReadbacks == 0 && dirtyTileComparison.framesLeft == 0)
+                    finishDirtyTileComparison();
+            });
+        };
+
+        readInto(dirtyTileComparison.texture2D_reference, &FrameReadback::referenceVertices);
+        readInto(texture2D_mlsVertices[cameraID], &FrameReadback::vertices);
+    }
+
+    /** Adds the distances between the fully recomputed and the kept vertices of one frame */
+    void accumulateDirtyTileErrors(const float* reference, const float* vertices){
+        size_t pixelCount = size_t(dirtyTileComparison.width) * dirtyTileComparison.height;
+
+        for(size_t i = 0; i < pixelCount; ++i){
+            const float* r = reference + i * 3;
+            const float* v = vertices + i * 3;
+
+            // Edge vertices (z = -1), failed ones (z = 10) and invalid ones are not smoothed:
+            if(!(r[2] > 0.f && r[2] < 10.f) || std::isnan(r[0]) || std::isnan(v[0]))
+                continue;
+
+            float error = std::sqrt((r[0] - v[0]) * (r[0] - v[0]) + (r[1] - v[1]) * (r[1] - v[1]) + (r[2] - v[2]) * (r[2] - v[2])) * 1000.f;
+            float noise = dirtyTileComparison.noiseAtOneMeter * std::max(1.f, r[2] * r[2]);
+
+            dirtyTileComparison.maxError = std::max(dirtyTileComparison.maxError, error);
+            dirtyTileComparison.squaredErrorSum += double(error) * error;
+            dirtyTileComparison.verticesAboveNoise += error > noise ? 1 : 0;
+            ++dirtyTileComparison.comparedVertices;
+        }
+        ++dirtyTileComparison.comparedFrames;
+    }
+
+    void finishDirtyTileComparison(){
+        if(dirtyTileComparison.comparedVertices == 0){
+            dirtyTileComparisonResult = "No smoothed vertices to compare.";
+        } else {
+            float rmse = float(std::sqrt(dirtyTileComparison.squaredErrorSum / dirtyTileComparison.comparedVertices));
+            float aboveNoise = float(dirtyTileComparison.verticesAboveNoise) / dirtyTileComparison.comparedVertices * 100.f;
+
+            char result[256];
+            std::snprintf(result, sizeof(result), "Camera %i, dirty tiles vs. full MLS over %i frames: RMSE %.3f mm, max. %.3f mm, %.3f %% above tile noise",
+                          dirtyTileComparison.cameraID, dirtyTileComparison.comparedFrames, rmse, dirtyTileComparison.maxError, aboveNoise);
+            dirtyTileComparisonResult = result;
+        }
+        std::cout << "Dirty tile comparison: " << dirtyTileComparisonResult << std::endl;
+
+        glDeleteFramebuffers(1, &dirtyTileComparison.fbo_reference);
+        glDeleteTextures(1, &dirtyTileComparison.texture2D_reference);
+        dirtyTileComparison = DirtyTileComparison();
+    }
+
+    /** (Re)creates the shared seed maps of the edge proximity if they are smaller than the camera image */
+    void ensureEdgeSeeds(int width, int height){
+        if(width <= edgeSeedsWidth && height <= edgeSeedsHeight)
+            return;
+
+        glDeleteFramebuffers(2, fbo_edgeSeeds);
+        glDeleteTextures(2, texture2D_edgeSeeds);
+
+        edgeSeedsWidth = std::max(width, edgeSeedsWidth);
+        edgeSeedsHeight = std::max(height, edgeSeedsHeight);
+
+        for(int i = 0; i < 2; ++i){
+            glGenFramebuffers(1, &fbo_edgeSeeds[i]);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_edgeSeeds[i]);
+            generateAndBind2DTexture(texture2D_edgeSeeds[i], edgeSeedsWidth, edgeSeedsHeight, GL_RG16UI, GL_RG_INTEGER, GL_UNSIGNED_SHORT, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_edgeSeeds[i], 0);
+            checkFramebufferComplete("Edge Seeds");
+        }
+    }
+
+    /**
+     * Renders the edge proximity of the camera: jump flooding finds the nearest
+     * rejected pixel of every pixel (steps from the smallest power of two that
+     * covers the radius down to 1, and one more step of 1 to fix most of the
+     * errors of jump flooding), then its distance is mapped to the proximity.
+     * The number of passes only grows with the logarithm of the radius.
+     */
+    void renderEdgeProximity(unsigned int cameraID){
+        int width = cameraWidth[cameraID];
+        int height = cameraHeight[cameraID];
+        ensureEdgeSeeds(width, height);
+
+        glBindVertexArray(VAO_quad);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_edgeSeeds[0]);
+        edgeSeedsShader.bind();
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2D_rejection[cameraID]);
+        edgeSeedsShader.setUniform("rejectedTexture", 1);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        std::vector<int> stepSizes;
+        int firstStep = 1;
+        while(firstStep < edgeProximityRadius)
+            firstStep *= 2;
+        for(int stepSize = firstStep; stepSize >= 1; stepSize /= 2)
+            stepSizes.push_back(stepSize);
+        stepSizes.push_back(1);
+
+        int current = 0;
+        edgeJumpFloodShader.bind();
+        edgeJumpFloodShader.setUniform("width", width);
+        edgeJumpFloodShader.setUniform("height", height);
+        edgeJumpFloodShader.setUniform("seeds", 1);
+        for(int stepSize : stepSizes){
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_edgeSeeds[1 - current]);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, texture2D_edgeSeeds[current]);
+            edgeJumpFloodShader.setUniform("stepSize", stepSize);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+
+            current = 1 - current;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_edgeProximity[cameraID]);
+        edgeProximityShader.bind();
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2D_rejection[cameraID]);
+        edgeProximityShader.setUniform("rejectedTexture", 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texture2D_edgeSeeds[current]);
+        edgeProximityShader.setUniform("seeds", 2);
+        edgeProximityShader.setUniform("edgeRadius", float(edgeProximityRadius));
+
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+    /** (Re)creates the shared summed-area tables if they are smaller than the camera image */
+    void ensureNormalSums(int width, int height){
+        if(width <= normalSumsWidth && height <= normalSumsHeight)
+            return;
+
+        glDeleteTextures(1, &texture2D_normalSumsA);
+        glDeleteTextures(1, &texture2D_normalSumsB);
+        glDeleteTextures(1, &texture2D_normalSumsC);
+
+        normalSumsWidth = std::max(width, normalSumsWidth);
+        normalSumsHeight = std::max(height, normalSumsHeight);
+
+        generateAndBind2DTexture(texture2D_normalSumsA, normalSumsWidth, normalSumsHeight, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT, GL_NEAREST);
+        generateAndBind2DTexture(texture2D_normalSumsB, normalSumsWidth, normalSumsHeight, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT, GL_NEAREST);
+        generateAndBind2DTexture(texture2D_normalSumsC, normalSumsWidth, normalSumsHeight, GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT, GL_NEAREST);
+    }
+
+    /** Renders the normals of the camera with the Gaussian weighted covariance and the iterative eigen solver */
+    void renderEigenSolverNormals(unsigned int cameraID, unsigned int fbo, bool dirtyTilesOnly){
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        normalsShader.bind();
+
+        normalsShader.setUniform("kernelRadius", kernelRadius);
+        normalsShader.setUniform("kernelSpread", kernelSpread);
+        normalsShader.setUniform("normalRadius", normalRadius);
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2D_mlsVertices[cameraID]);
+        normalsShader.setUniform("texture2D_mlsVertices", 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
+        normalsShader.setUniform("texture2D_edgeProximity", 2);
+
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, currentProcessedVertices[cameraID]);
+        normalsShader.setUniform("texture2D_inputVertices", 3);
+
+        drawCameraQuad(cameraID, dirtyTilesOnly);
+    }
+
+    /**
+     * Builds the summed-area tables of the camera (one dispatch along the rows,
+     * one along the columns) and renders the normals from them.
+     */
+    void renderSummedAreaNormals(unsigned int cameraID, unsigned int fbo, bool dirtyTilesOnly){
+        ensureNormalSums(cameraWidth[cameraID], cameraHeight[cameraID]);
+
+        ComputeShader::bindImage(0, texture2D_normalSumsA, GL_READ_WRITE, GL_RGBA32UI);
+        ComputeShader::bindImage(1, texture2D_normalSumsB, GL_READ_WRITE, GL_RGBA32UI);
+        ComputeShader::bindImage(2, texture2D_normalSumsC, GL_READ_WRITE, GL_RG32UI);
+
+        normalSumsRowShader->bind();
+        normalSumsRowShader->setUniform("width", cameraWidth[cameraID]);
+        normalSumsRowShader->setUniform("height", cameraHeight[cameraID]);
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, currentProcessedVertices[cameraID]);
+        normalSumsRowShader->setUniform("inputVertices", 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
+        normalSumsRowShader->setUniform("edgeProximity", 2);
+
+        ComputeShader::dispatch(cameraHeight[cameraID], 1);
+        ComputeShader::memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        normalSumsColumnShader->bind();
+        normalSumsColumnShader->setUniform("width", cameraWidth[cameraID]);
+        normalSumsColumnShader->setUniform("height", cameraHeight[cameraID]);
+
+        ComputeShader::dispatch(cameraWidth[cameraID], 1);
+        ComputeShader::memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        normalsSummedAreaShader.bind();
+
+        normalsSummedAreaShader.setUniform("normalRadius", normalRadius);
+        normalsSummedAreaShader.setUniform("width", cameraWidth[cameraID]);
+        normalsSummedAreaShader.setUniform("height", cameraHeight[cameraID]);
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2D_mlsVertices[cameraID]);
+        normalsSummedAreaShader.setUniform("texture2D_mlsVertices", 1);
+
+        unsigned int sums[3] = { texture2D_normalSumsA, texture2D_normalSumsB, texture2D_normalSumsC };
+        const char* sumNames[3] = { "sumsA", "sumsB", "sumsC" };
+        for(int i = 0; i < 3; ++i){
+            glActiveTexture(GL_TEXTURE2 + i);
+            glBindTexture(GL_TEXTURE_2D, sums[i]);
+            normalsSummedAreaShader.setUniform(sumNames[i], 2 + i);
+        }
+
+        drawCameraQuad(cameraID, dirtyTilesOnly);
+    }
+
+    /** Renders the normals of the camera into the fbo (falls back to the eigen solver if the summed-area tables are unavailable) */
+    void renderNormals(unsigned int cameraID, unsigned int fbo, NormalsMode mode, bool dirtyTilesOnly = false){
+        bool fitsIntoScan = std::max(cameraWidth[cameraID], cameraHeight[cameraID]) <= NORMAL_SUMS_SCAN_THREADS * 4;
+
+        if(mode == NORMALS_SUMMED_AREA && fitsIntoScan && isSummedAreaNormalsSupported())
+            renderSummedAreaNormals(cameraID, fbo, dirtyTilesOnly);
+        else
+            renderEigenSolverNormals(cameraID, fbo, dirtyTilesOnly);
+    }
+
+    /** Renders and times both normal modes of the camera into own textures and reads them back */
+    void compareNormals(unsigned int cameraID){
+        if(!isSummedAreaNormalsSupported() || std::max(cameraWidth[cameraID], cameraHeight[cameraID]) > NORMAL_SUMS_SCAN_THREADS * 4){
+            normalsComparisonResult = "Summed-area normals are not available for this camera.";
+            return;
+        }
+
+        normalsComparison = NormalsComparison();
+        normalsComparison.cameraID = int(cameraID);
+        normalsComparison.width = cameraWidth[cameraID];
+        normalsComparison.height = cameraHeight[cameraID];
+        normalsComparison.radius = normalRadius;
+
+        glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
+
+        for(int mode = 0; mode < NORMALS_MODE_COUNT; ++mode){
+            glGenFramebuffers(1, &normalsComparison.fbo[mode]);
+            glBindFramebuffer(GL_FRAMEBUFFER, normalsComparison.fbo[mode]);
+            generateAndBind2DTexture(normalsComparison.texture2D_normals[mode], cameraWidth[cameraID], cameraHeight[cameraID], GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, normalsComparison.texture2D_normals[mode], 0);
+
+            GPUProfiler::getInstance().begin(getNormalsComparisonPassName(NormalsMode(mode)));
+            renderNormals(cameraID, normalsComparison.fbo[mode], NormalsMode(mode));
+            GPUProfiler::getInstance().end();
+        }
+
+        size_t size = size_t(cameraWidth[cameraID]) * cameraHeight[cameraID] * 3 * sizeof(float);
+        auto readInto = [this, size](unsigned int texture, std::vector<uint8_t>* target){
+            ++normalsComparison.pendingReadbacks;
+            AsyncReadback::getInstance().read(texture, 0, GL_RGB, GL_FLOAT, size, [this, target](const void* data, size_t size){
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                target->assign(bytes, bytes + size);
+
+                if(--normalsComparison.pendingReadbacks == 0)
+                    finishNormalsComparison();
+            });
+        };
+
+        for(int mode = 0; mode < NORMALS_MODE_COUNT; ++mode)
+            readInto(normalsComparison.texture2D_normals[mode], &normalsComparison.normals[mode]);
+        readInto(texture2D_mlsVertices[cameraID], &normalsComparison.mlsVertices);
+    }
+
+    /** Computes the angle between the normals of both modes (on the pixels that get a normal) */
+    void finishNormalsComparison(){
+        int width = normalsComparison.width;
+        size_t pixelCount = size_t(width) * normalsComparison.height;
+        const float* reference = reinterpret_cast<const float*>(normalsComparison.normals[NORMALS_EIGEN_SOLVER].data());
+        const float* normals = reinterpret_cast<const float*>(normalsComparison.normals[NORMALS_SUMMED_AREA].data());
+        const float* mlsVertices = reinterpret_cast<const float*>(normalsComparison.mlsVertices.data());
+
+        std::vector<float> errors;
+        double errorSum = 0.0;
+        for(size_t i = 0; i < pixelCount; ++i){
+            const float* r = reference + i * 3;
+            const float* n = normals + i * 3;
+
+            // No normal is written for these (the last column is marked white by both shaders):
+            if(!(mlsVertices[i * 3 + 2] >= 0.1f) || int(i % width) == width - 1)
+                continue;
+
+            float referenceLength = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+            float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if(!(referenceLength > 0.5f) || !(length > 0.5f))
+                continue;
+
+            // Unoriented angle (normals almost parallel to the image plane may be flipped differently):
+            float cosine = std::abs(r[0] * n[0] + r[1] * n[1] + r[2] * n[2]) / (referenceLength * length);
+            float error = std::acos(std::min(cosine, 1.f)) * 180.f / 3.14159265f;
+            errors.push_back(error);
+            errorSum += error;
+        }
+
+        if(errors.empty()){
+            normalsComparisonResult = "No normals to compare.";
+        } else {
+            std::sort(errors.begin(), errors.end());
+            float mean = float(errorSum / errors.size());
+            float p95 = errors[std::min(errors.size() - 1, errors.size() * 95 / 100)];
+
+            char result[256];
+            std::snprintf(result, sizeof(result), "Camera %i, radius %i, summed-area vs. eigen solver: mean %.2f deg, p95 %.2f deg, max. %.2f deg (%zu normals)",
+                          normalsComparison.cameraID, normalsComparison.radius, mean, p95, errors.back(), errors.size());
+            normalsComparisonResult = result;
+        }
+        std::cout << "Normals comparison: " << normalsComparisonResult << std::endl;
+
+        for(int mode = 0; mode < NORMALS_MODE_COUNT; ++mode){
+            glDeleteFramebuffers(1, &normalsComparison.fbo[mode]);
+            glDeleteTextures(1, &normalsComparison.texture2D_normals[mode]);
+        }
+        normalsComparison = NormalsComparison();
+    }
+
 public:
+    static const char* getMLSModeName(MLSMode mode){
+        static const char* names[MLS_MODE_COUNT] = { "Exact", "Strided", "Separable" };
+        return mode >= 0 && mode < MLS_MODE_COUNT ? names[mode] : "Unknown";
+    }
+
+    static const char* getNormalsModeName(NormalsMode mode){
+        static const char* names[NORMALS_MODE_COUNT] = { "Eigen Solver", "Summed-Area Tables" };
+        return mode >= 0 && mode < NORMALS_MODE_COUNT ? names[mode] : "Unknown";
+    }
+
+    static const char* getPassName(Pass pass){
+        static const char* names[PASS_COUNT] = { "Filters", "Rejection", "Edge Proximity", "MLS", "Normals", "Quality Estimate" };
+        return pass >= 0 && pass < PASS_COUNT ? names[pass] : "Unknown";
+    }
+
+    /** GPU time of the pass for all cameras (ms, mean over the frames kept by the GPUProfiler) */
+    float getPassTime(Pass pass) const {
+        return GPUProfiler::getInstance().getMeanMs(getPassName(pass));
+    }
+
+    /** Measures the error of the current MLS mode against the exact MLS in the next frame */
+    void requestMLSQualityMeasurement(){
+        mlsQualityRequested = true;
+    }
+
+    /** Result of the last MLS quality measurement (empty if none finished yet) */
+    const std::string& getMLSQualityResult() const {
+        return mlsQualityResult;
+    }
+
+    /**
+     * Renders the MLS of one camera additionally for all tiles over the next
+     * frames and compares it with the results of the dirty tiles (e.g. right
+     * after a step change in front of the camera).
+     */
+    void requestDirtyTileComparison(){
+        dirtyTileComparisonRequested = true;
+    }
+
+    /** Result of the last dirty tile comparison (empty if none finished yet) */
+    const std::string& getDirtyTileComparisonResult() const {
+        return dirtyTileComparisonResult;
+    }
+
+    /** Renders both normal modes for one camera in the next frame and compares them (angle and GPU time) */
+    void requestNormalsComparison(){
+        normalsComparisonRequested = true;
+    }
+
+    /** Result of the last normals comparison (empty if none finished yet) */
+    const std::string& getNormalsComparisonResult() const {
+        return normalsComparisonResult;
+    }
+
+    /** Name of the profiled pass of the normal mode in a comparison (see GPUProfiler) */
+    static std::string getNormalsComparisonPassName(NormalsMode mode){
+        return std::string("Normals Comparison: ") + getNormalsModeName(mode);
+    }
+
+    /** GPU time of the normal mode for one camera in the comparisons (ms, profiler mean, 0 if not measured yet) */
+    float getNormalsComparisonTime(NormalsMode mode) const {
+        return GPUProfiler::getInstance().getMeanMs(getNormalsComparisonPassName(mode));
+    }
+
+    /** Whether the summed-area normals are available (compiles their compute shaders on the first call, OpenGL thread only) */
+    bool isSummedAreaNormalsSupported(){
+        if(!summedAreaNormalsChecked){
+            summedAreaNormalsChecked = true;
+
+            if(ComputeShader::isSupported()){
+                std::map<std::string, std::string> defines = {{"SCAN_THREADS", std::to_string(NORMAL_SUMS_SCAN_THREADS)}};
+                normalSumsRowShader = std::make_unique<ComputeShader>(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normalSums.comp", defines);
+
+                defines["SAT_COLUMNS"] = "1";
+                normalSumsColumnShader = std::make_unique<ComputeShader>(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/normalSums.comp", defines);
+
+                if(!normalSumsRowShader->initialized || !normalSumsColumnShader->initialized){
+                    normalSumsRowShader.reset();
+                    normalSumsColumnShader.reset();
+                }
+            }
+
+            if(normalSumsRowShader == nullptr)
+                std::cout << "Compute shaders not available (OpenGL 4.3), the normals use the eigen solver." << std::endl;
+        }
+        return normalSumsRowShader != nullptr;
+    }
+
+    /** Whether the fused compute filters are available (compiles them on the first call, OpenGL thread only) */
+    bool isComputeFilteringSupported(){
+        if(!computeFiltersChecked){
+            computeFiltersChecked = true;
+
+            if(ComputeShader::isSupported()){
+                std::map<std::string, std::string> defines = {{"TILE_SIZE", std::to_string(FILTER_TILE_SIZE)}};
+                fusedFilterShader = std::make_unique<ComputeShader>(CMAKE_SOURCE_DIR "/shader/blendpcr/filter/fusedFilters.comp", defines);
+                erosionComputeShader = std::make_unique<ComputeShader>(CMAKE_SOURCE_DIR "/shader/blendpcr/filter/erosion.comp", defines);
+
+                if(!fusedFilterShader->initialized || !erosionComputeShader->initialized){
+                    fusedFilterShader.reset();
+                    erosionComputeShader.reset();
+                }
+            }
+
+            if(fusedFilterShader == nullptr)
+                std::cout << "Compute shaders not available (OpenGL 4.3), the point cloud filters use the fragment passes." << std::endl;
+        }
+        return fusedFilterShader != nullptr;
+    }
+
+    /** Runs the fragment and the compute filters in the next frame and compares their results pixel by pixel */
+    void requestFilterComparison(){
+        filterComparisonRequested = true;
+    }
+
+    /** Result of the last comparison (empty if none finished yet) */
+    const std::string& getFilterComparisonResult() const {
+        return filterComparisonResult;
+    }
+
+    /**
+     * Distance (in pixels) over which a changed depth pixel influences the
+     * results: radii of hole filling (5) and erosion (10), of the edge
+     * proximity, of the MLS window (10) and of the normal estimation.
+     */
+    int getDirtyTileRadius() const {
+        int filterRadius = useReimplementedFilters ? 5 + 10 : 0;
+        return filterRadius + edgeProximityRadius + 10 + normalRadius;
+    }
+
+    /** Fraction of the tiles of the camera whose results were kept (smoothed, 0 if dirty tiles are not used) */
+    float getSkippedTileRatio(unsigned int cameraID) const {
+        return useDirtyTiles ? dirtyTileMasks[cameraID].getSkippedRatio() : 0.f;
+    }
+
+    /** Mean fraction of skipped tiles over the cameras in use */
+    float getSkippedTileRatio() const {
+        if(usedCameraIDs.empty())
+            return 0.f;
+
+        float sum = 0.f;
+        for(unsigned int cameraID : usedCameraIDs)
+            sum += getSkippedTileRatio(cameraID);
+        return sum / usedCameraIDs.size();
+    }
+
+    /** Render thread time of the depth and color uploads (ms, smoothed) */
+    float getUploadTime() const {
+        return uploadTime;
+    }
+
+    /** Upload statistics of the pixel buffer ring of the camera */
+    PixelUploadRing::Statistics getUploadStatistics(int cameraID) const {
+        return uploadRings[cameraID].getStatistics();
+    }
+
     ~CameraPasses(){
         if(!isInitialized)
             return;
 
-        for(int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
+        for(int cameraID = 0; cameraID < MAX_CAMERA_COUNT; ++cameraID){
             if(cameraWidth[cameraID] > 0){
                 deinitializeCamera(cameraID);
             }
@@ -590,60 +1820,52 @@ public:
 
         glDeleteVertexArrays(1, &VAO_quad);
         glDeleteBuffers(1, &VBO_quad);
-    }
 
-    /**
-     * Integrate new RGB XYZ images.
-     */
-    virtual void insertNewPointCloud(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud) {
-        std::unique_lock lock(pointCloudsMutex);
+        glDeleteTextures(1, &texture2D_normalSumsA);
+        glDeleteTextures(1, &texture2D_normalSumsB);
+        glDeleteTextures(1, &texture2D_normalSumsC);
 
-        if(currentPointClouds.size() <= deviceIndex){
-            // Fill point clouds:
-            for(int i=currentPointClouds.size(); i < deviceIndex; ++i){
-                currentPointClouds.push_back(nullptr);
-            }
-
-            // Insert point clouds:
-            currentPointClouds.push_back(pointCloud);
-        } else {
-            // Just update point cloud:
-            currentPointClouds[deviceIndex] = pointCloud;
-        }
-    };
+        glDeleteFramebuffers(2, fbo_edgeSeeds);
+        glDeleteTextures(2, texture2D_edgeSeeds);
+    }
 
     std::chrono::time_point<std::chrono::steady_clock> lastTime;
 
     virtual void glTick(){
-        // Ensure that currentPointClouds is a temporal copy to ensure that during upload it's not actualized
-        // to ensure setting the right flags:
-        std::vector<std::shared_ptr<OrganizedPointCloud>> syncCurrentPointClouds;
-        {
-            std::unique_lock lock(pointCloudsMutex);
-            syncCurrentPointClouds = currentPointClouds;
-        }
-        auto& currentPointClouds = syncCurrentPointClouds;
+        // Take a timestamp-synchronized frameset of all devices (lock-free, the camera
+        // threads are never blocked by this):
+        currentPointClouds = Data::instance.cameraManager.getSynchronizedPointClouds();
 
         glDisable(GL_BLEND);
         // If opengl resources are not initialized yet, do it:
         init();
 
+        // Devices can be disconnected at any time, so the removals are read once per tick. Their
+        // resources are released first (initialized again when they deliver) and they are not rendered:
+        bool isCameraRemoved[MAX_CAMERA_COUNT];
+        for(int i = 0; i < MAX_CAMERA_COUNT; ++i){
+            isCameraRemoved[i] = Data::instance.cameraManager.isDeviceRemoved(i);
+            if(isCameraRemoved[i] && cameraWidth[i] > 0)
+                deinitializeCamera(i);
+        }
+
         // Stores camera ids of cameras which should be rendered:
         std::vector<unsigned int> cameraIDsThatCanBeRendered;
 
         // Stores if the camera with the respective ID is active:
-        bool isCameraActive[CAMERA_COUNT];
-        std::fill_n(isCameraActive, CAMERA_COUNT, false);
+        bool isCameraActive[MAX_CAMERA_COUNT];
+        std::fill_n(isCameraActive, MAX_CAMERA_COUNT, false);
 
         // Iterate over all cameras:
-        for(unsigned int i = 0; i < currentPointClouds.size(); ++i){
+        for(unsigned int i = 0; i < std::min<size_t>(currentPointClouds.size(), MAX_CAMERA_COUNT); ++i){
             cameraIsUpdatedThisFrame[i] = false;
             // Check if point cloud is zero. If that's the case,
-            if(currentPointClouds[i] != nullptr){
+            if(currentPointClouds[i] != nullptr && !isCameraRemoved[i]){
                 unsigned int width = currentPointClouds[i]->width;
                 unsigned int height = currentPointClouds[i]->height;
 
-                if(!((width == 640 && height == 576) || (width == 968 && height == 608))){
+                // Native resolutions and their 2x2 binned counterparts (see DepthBinning):
+                if(!((width == 640 && height == 576) || (width == 968 && height == 608) || (width == 320 && height == 288) || (width == 484 && height == 304))){
                     std::cout << "WARNING: GL Camera Passes PC Size is: " << width << " x " << height << std::endl;
                 }
 
@@ -661,6 +1883,16 @@ public:
 
         // Used camera ids:
         usedCameraIDs = cameraIDsThatCanBeRendered;
+        cameraCount = usedCameraIDs.empty() ? 0 : int(usedCameraIDs.back()) + 1;
+
+        // Camera parameters of the later passes (camera block, see SceneUniforms):
+        CameraBlock cameraBlock;
+        for(unsigned int cameraID : usedCameraIDs){
+            cameraBlock.cameras[cameraID].model = currentPointClouds[cameraID]->modelMatrix;
+            cameraBlock.cameras[cameraID].view = currentPointClouds[cameraID]->modelMatrix.inverse();
+            cameraBlock.cameras[cameraID].isActive = 1;
+        }
+        SceneUniforms::getInstance().uploadCameras(cameraBlock);
 
         // Check if cameras for rendering are available:
         if(cameraIDsThatCanBeRendered.size() == 0){
@@ -679,16 +1911,24 @@ public:
         glDisable(GL_CULL_FACE);
 
         {
+            auto uploadStart = steady_clock::now();
+
+            std::vector<unsigned int> updatedCameraIDs;
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
-                if(!cameraIsUpdatedThisFrame[cameraID])
-                    continue;
+                if(cameraIsUpdatedThisFrame[cameraID])
+                    updatedCameraIDs.push_back(cameraID);
+            }
 
-                std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+            GPUProfiler::getInstance().begin("Upload");
+            if(usePixelBufferUpload)
+                uploadThroughPixelBuffers(updatedCameraIDs);
+            else
+                uploadDirectly(updatedCameraIDs);
+            GPUProfiler::getInstance().end();
 
-                if(currentPC->depth != nullptr){
-                    glBindTexture(GL_TEXTURE_2D, texture2D_inputDepth[cameraID]);
-                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RED_INTEGER, GL_UNSIGNED_SHORT, currentPC->depth);
-                }
+            if(!updatedCameraIDs.empty()){
+                float uploadMs = duration_cast<microseconds>(steady_clock::now() - uploadStart).count() / 1000.f;
+                uploadTime = uploadTime * 0.95f + uploadMs * 0.05f;
             }
 
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
@@ -696,12 +1936,8 @@ public:
                     continue;
 
                 std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
-                if(currentPC->colors != nullptr){
-                    glBindTexture(GL_TEXTURE_2D, texture2D_inputRGB[cameraID]);
-                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cameraWidth[cameraID], cameraHeight[cameraID], GL_RGBA, GL_UNSIGNED_BYTE, currentPC->colors);
-                }
+                LatencyTracer::getInstance().uploaded(cameraID, currentPC->frameID, currentPC->timestamp, currentPC->trace);
             }
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // Unbind PBO
 
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                 if(!cameraIsUpdatedThisFrame[cameraID])
@@ -709,23 +1945,46 @@ public:
 
                 std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
 
-                if(!lookupInitialized[cameraID]){
-                    if(currentPC->lookupImageTo3D != nullptr){
-                        glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
-                        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, currentPointClouds[cameraID]->width, currentPointClouds[cameraID]->height, GL_RG, GL_FLOAT, currentPC->lookupImageTo3D);
-                    }
-                    if(currentPC->lookup3DToImage != nullptr){
+                if(currentPC->lookupImageTo3D != nullptr && currentPC->lookupImageTo3D != uploadedLookupImageTo3D[cameraID]){
+                    glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, currentPointClouds[cameraID]->width, currentPointClouds[cameraID]->height, GL_RG, GL_FLOAT, currentPC->lookupImageTo3D);
+                    uploadedLookupImageTo3D[cameraID] = currentPC->lookupImageTo3D;
+                    std::cout << "Initialized Image-To-3D Lookup! " << cameraID << std::endl;
+                }
+
+                // The 3D-to-image lookup may be generated asynchronously and arrive later:
+                if(currentPC->lookup3DToImage != nullptr && currentPC->lookup3DToImage != uploadedLookup3DToImage[cameraID]){
+                    if(currentPC->lookup3DToImageSize == LOOKUP_IMAGE_SIZE){
                         glBindTexture(GL_TEXTURE_2D, texture2D_inputLookup3DToImage[cameraID]);
                         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LOOKUP_IMAGE_SIZE, LOOKUP_IMAGE_SIZE, GL_RG, GL_FLOAT, currentPC->lookup3DToImage);
+                        std::cout << "Initialized 3D-To-Image Lookup! " << cameraID << std::endl;
+                    } else {
+                        std::cout << "WARNING: 3D-To-Image Lookup of camera " << cameraID << " has size " << currentPC->lookup3DToImageSize << " instead of " << LOOKUP_IMAGE_SIZE << std::endl;
                     }
-                    lookupInitialized[cameraID] = true;
-                    std::cout << "Initialized Lookup! " << cameraID << std::endl;
+                    uploadedLookup3DToImage[cameraID] = currentPC->lookup3DToImage;
                 }
             }
 
+            // Change detection against the depth of the last recomputation of each tile:
+            updateDirtyTiles(updatedCameraIDs);
+
+            GPUProfiler::getInstance().begin(getPassName(PASS_FILTERS));
+
+            // Vertex generation and the filters as fused compute dispatches:
+            bool useComputePath = useReimplementedFilters && useComputeFilters && isComputeFilteringSupported();
+
+            // A comparison runs the compute filters next to the fragment passes:
+            if(useReimplementedFilters && filterComparisonRequested && filterComparison.cameraID < 0 && !updatedCameraIDs.empty() && isComputeFilteringSupported()){
+                startFilterComparison(updatedCameraIDs.front());
+                useComputePath = false;
+            }
+            filterComparisonRequested = false;
+
+            if(useComputePath)
+                runComputeFilters(updatedCameraIDs);
 
             // Generate vertices from depth images:
-            {
+            if(!useComputePath){
                 for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                     if(!cameraIsUpdatedThisFrame[cameraID])
                         continue;
@@ -750,7 +2009,7 @@ public:
                 }
             }
 
-            if(useReimplementedFilters){
+            if(useReimplementedFilters && !useComputePath){
                 for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                     if(!cameraIsUpdatedThisFrame[cameraID])
                         continue;
@@ -840,8 +2099,14 @@ public:
 
                     currentProcessedVertices[cameraID] = texture2D_pcf_erosion[cameraID];
                 }
+
+                if(filterComparison.cameraID >= 0 && filterComparison.pendingReadbacks == 0)
+                    readFilterComparison();
             }
 
+            GPUProfiler::getInstance().end();
+
+            GPUProfiler::getInstance().begin(getPassName(PASS_REJECTION));
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                 if(!cameraIsUpdatedThisFrame[cameraID])
                     continue;
@@ -872,87 +2137,66 @@ public:
                     glDrawArrays(GL_TRIANGLES, 0, 6);
                 }
             }
+            GPUProfiler::getInstance().end();
 
+            GPUProfiler::getInstance().begin(getPassName(PASS_EDGE_PROXIMITY));
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                 if(!cameraIsUpdatedThisFrame[cameraID])
                     continue;
 
                 glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
                 // Edge Distance PASS:
-                {
-                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_edgeProximity[cameraID]);
-                    edgeProximityShader.bind();
-
-                    glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_rejection[cameraID]);
-                    edgeProximityShader.setUniform("rejectedTexture", 1);
-                    edgeProximityShader.setUniform("kernelRadius", 10);
-
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
-                }
+                renderEdgeProximity(cameraID);
             }
+            GPUProfiler::getInstance().end();
 
+            // MLS, normals and quality estimate keep their previous results outside of the dirty tiles:
+            GPUProfiler::getInstance().begin(getPassName(PASS_MLS));
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
-                if(!cameraIsUpdatedThisFrame[cameraID])
+                if(!cameraIsUpdatedThisFrame[cameraID] || !hasDirtyTiles(cameraID))
                     continue;
 
                 glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
                 // Texture a(x) PASS:
-                {
-                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_mls[cameraID]);
-                    mlsShader.bind();
-
-                    mlsShader.setUniform("kernelRadius", kernelRadius);
-                    mlsShader.setUniform("kernelSpread", kernelSpread);
-                    mlsShader.setUniform("p_h", implicitH);
-
-                    glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, currentProcessedVertices[cameraID]);
-                    mlsShader.setUniform("pointCloud", 1);
-
-                    glActiveTexture(GL_TEXTURE2);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
-                    mlsShader.setUniform("edgeProximity", 2);
-
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                if(mlsMode == MLS_SEPARABLE){
+                    renderSeparableMLS(cameraID, fbo_mls[cameraID], true);
+                } else {
+                    renderMLS(cameraID, fbo_mls[cameraID], mlsMode == MLS_STRIDED ? 2 : 1, true);
                 }
             }
+            GPUProfiler::getInstance().end();
 
+            // Render the exact MLS as reference for the error of the fast modes:
+            if(mlsQualityRequested && mlsQualityMeasurement.cameraID < 0 && !updatedCameraIDs.empty())
+                measureMLSQuality(updatedCameraIDs.front());
+            mlsQualityRequested = false;
+
+            // Compare the kept tiles with a full recomputation of the MLS over the next frames:
+            if(dirtyTileComparisonRequested && dirtyTileComparison.cameraID < 0 && !updatedCameraIDs.empty())
+                startDirtyTileComparison(updatedCameraIDs.front());
+            dirtyTileComparisonRequested = false;
+            if(dirtyTileComparison.framesLeft > 0 && (cameraIsUpdatedThisFrame[dirtyTileComparison.cameraID] || cameraWidth[dirtyTileComparison.cameraID] <= 0))
+                compareDirtyTiles();
+
+            GPUProfiler::getInstance().begin(getPassName(PASS_NORMALS));
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
-                if(!cameraIsUpdatedThisFrame[cameraID])
+                if(!cameraIsUpdatedThisFrame[cameraID] || !hasDirtyTiles(cameraID))
                     continue;
 
                 glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
                 // Texture n(x) PASS:
-                {
-                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_normals[cameraID]);
-                    //gl.glDisable(GL_DEPTH_TEST);
-                    normalsShader.bind();
-
-                    normalsShader.setUniform("kernelRadius", kernelRadius);
-                    normalsShader.setUniform("kernelSpread", kernelSpread);
-
-                    glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_mlsVertices[cameraID]);
-                    normalsShader.setUniform("texture2D_mlsVertices", 1);
-
-                    glActiveTexture(GL_TEXTURE2);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
-                    normalsShader.setUniform("texture2D_edgeProximity", 2);
-
-                    glActiveTexture(GL_TEXTURE3);
-                    glBindTexture(GL_TEXTURE_2D, currentProcessedVertices[cameraID]);
-                    normalsShader.setUniform("texture2D_inputVertices", 3);
-
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
-                }
+                renderNormals(cameraID, fbo_normals[cameraID], normalsMode, true);
             }
+            GPUProfiler::getInstance().end();
+
+            // Render both normal modes for one camera to compare them:
+            if(normalsComparisonRequested && normalsComparison.cameraID < 0 && !updatedCameraIDs.empty())
+                compareNormals(updatedCameraIDs.front());
+            normalsComparisonRequested = false;
 
+            GPUProfiler::getInstance().begin(getPassName(PASS_QUALITY_ESTIMATE));
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
-                if(!cameraIsUpdatedThisFrame[cameraID])
+                if(!cameraIsUpdatedThisFrame[cameraID] || !hasDirtyTiles(cameraID))
                     continue;
 
                 glViewport(0, 0, cameraWidth[cameraID], cameraHeight[cameraID]);
@@ -973,10 +2217,10 @@ public:
                     glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
                     qualityEstimateShader.setUniform("edgeDistances", 2);
 
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawCameraQuad(cameraID, true);
                 }
             }
+            GPUProfiler::getInstance().end();
 
             // Set point cloud matrices:
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
@@ -0,0 +1,312 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Include OpenGL3.3 Core functions:
+#include <glad/glad.h>
+
+#include "src/WorkerPool.h"
+
+/**
+ * Change detection of the depth image of one camera in tiles of
+ * TILE_SIZE x TILE_SIZE pixels, so that the camera passes only recompute the
+ * tiles whose input changed and keep their previous results elsewhere.
+ *
+ * A pixel changed if its validity differs from the reference depth or if the
+ * difference exceeds the sensor noise at its distance (grows quadratically
+ * with the depth). The reference of a tile is the depth at which the tile was
+ * last recomputed, so slow drifts are detected as well. The passes read the
+ * temporally filtered vertices, which still move for some frames after the
+ * depth changed, so a changed tile stays changed for settleFrames frames. The
+ * changed tiles are dilated by the radius (in pixels) of the passes reading neighbouring
+ * pixels, and the resulting dirty tiles are kept as triangles (one quad per
+ * horizontal run of dirty tiles) which are drawn instead of the fullscreen
+ * quad.
+ *
+ * Everything is dirty on the first frame, after the image size or the
+ * dependencies changed and every refreshInterval frames.
+ */
+class DirtyTileMask {
+public:
+    static constexpr int TILE_SIZE = 16;
+
+    struct Settings {
+        /** Sensor noise at 1 m (in mm) below which a depth difference is ignored */
+        float noiseAtOneMeter = 4.f;
+
+        /** Changed pixels from which on a tile is dirty */
+        int minChangedPixels = 4;
+
+        /** Frames after which all tiles are recomputed (0: never) */
+        int refreshInterval = 60;
+
+        /**
+         * Frames a changed tile stays dirty while the temporal filter settles
+         * (0: no temporal filter). The filtered depth of a step is then within
+         * half of the noise threshold.
+         */
+        int settleFrames = 48;
+    };
+
+private:
+    Settings settings;
+
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+
+    bool hasReference = false;
+    int framesSinceRefresh = 0;
+
+    /** Depth at which each tile was last recomputed */
+    std::vector<uint16_t> referenceDepth;
+
+    std::vector<uint8_t> changedTiles;
+    std::vector<uint8_t> dirtyTiles;
+
+    /** Remaining frames until the temporal filter of each tile settled */
+    std::vector<uint8_t> settlingTiles;
+    int dirtyTileCount = 0;
+
+    /** Values (besides the depth) the results depend on, everything is recomputed if they change */
+    std::vector<float> dependencies;
+
+    float skippedRatio = 0.f;
+
+    unsigned int VAO_tiles = 0;
+    unsigned int VBO_tiles = 0;
+    int vertexCount = 0;
+    std::vector<float> vertexData;
+
+    bool isPixelChanged(uint16_t depth, uint16_t reference) const {
+        if((depth == 0) != (reference == 0))
+            return true;
+
+        if(depth == 0)
+            return false;
+
+        float meters = reference * 0.001f;
+        float threshold = settings.noiseAtOneMeter * std::max(1.f, meters * meters);
+        return std::abs(int(depth) - int(reference)) > threshold;
+    }
+
+    void detectChangedTiles(const uint16_t* depth){
+        WorkerPool::getInstance().parallelFor(0, tilesY, [this, depth](int tileY){
+            for(int tileX = 0; tileX < tilesX; ++tileX){
+                int changedPixels = 0;
+                int xEnd = std::min(width, (tileX + 1) * TILE_SIZE);
+                int yEnd = std::min(height, (tileY + 1) * TILE_SIZE);
+
+                for(int y = tileY * TILE_SIZE; y < yEnd && changedPixels < settings.minChangedPixels; ++y){
+                    for(int x = tileX * TILE_SIZE; x < xEnd; ++x){
+                        size_t i = size_t(y) * width + x;
+                        changedPixels += isPixelChanged(depth[i], referenceDepth[i]) ? 1 : 0;
+                    }
+                }
+
+                changedTiles[tileY * tilesX + tileX] = changedPixels >= settings.minChangedPixels ? 1 : 0;
+            }
+        });
+    }
+
+    /** Restarts the countdown of the changed tiles and keeps the tiles which are still settling changed */
+    void holdSettlingTiles(){
+        uint8_t settleFrames = uint8_t(std::clamp(settings.settleFrames, 0, 255));
+
+        for(size_t i = 0; i < changedTiles.size(); ++i){
+            if(changedTiles[i]){
+                settlingTiles[i] = settleFrames;
+            } else if(settlingTiles[i] > 0){
+                --settlingTiles[i];
+                changedTiles[i] = 1;
+            }
+        }
+    }
+
+    /** Separable maximum of the changed tiles over (2 * radius + 1)^2 tiles */
+    void dilate(int radius){
+        std::vector<uint8_t> horizontal(changedTiles.size(), 0);
+        for(int tileY = 0; tileY < tilesY; ++tileY){
+            for(int tileX = 0; tileX < tilesX; ++tileX){
+                if(!changedTiles[tileY * tilesX + tileX])
+                    continue;
+
+                for(int x = std::max(0, tileX - radius); x <= std::min(tilesX - 1, tileX + radius); ++x)
+                    horizontal[tileY * tilesX + x] = 1;
+            }
+        }
+
+        std::fill(dirtyTiles.begin(), dirtyTiles.end(), 0);
+        for(int tileY = 0; tileY < tilesY; ++tileY){
+            for(int tileX = 0; tileX < tilesX; ++tileX){
+                if(!horizontal[tileY * tilesX + tileX])
+                    continue;
+
+                for(int y = std::max(0, tileY - radius); y <= std::min(tilesY - 1, tileY + radius); ++y)
+                    dirtyTiles[y * tilesX + tileX] = 1;
+            }
+        }
+    }
+
+    /** Takes the depth of the dirty tiles as their new reference */
+    void updateReference(const uint16_t* depth){
+        WorkerPool::getInstance().parallelFor(0, tilesY, [this, depth](int tileY){
+            int yEnd = std::min(height, (tileY + 1) * TILE_SIZE);
+
+            for(int tileX = 0; tileX < tilesX; ++tileX){
+                if(!dirtyTiles[tileY * tilesX + tileX])
+                    continue;
+
+                int xBegin = tileX * TILE_SIZE;
+                int xEnd = std::min(width, xBegin + TILE_SIZE);
+                for(int y = tileY * TILE_SIZE; y < yEnd; ++y){
+                    size_t i = size_t(y) * width + xBegin;
+                    std::copy(depth + i, depth + i + (xEnd - xBegin), referenceDepth.begin() + i);
+                }
+            }
+        });
+    }
+
+    /** Builds one quad (in normalized device coordinates) per horizontal run of dirty tiles */
+    void uploadTiles(){
+        vertexData.clear();
+
+        for(int tileY = 0; tileY < tilesY; ++tileY){
+            float y0 = float(tileY * TILE_SIZE) / height * 2.f - 1.f;
+            float y1 = float(std::min(height, (tileY + 1) * TILE_SIZE)) / height * 2.f - 1.f;
+
+            for(int tileX = 0; tileX < tilesX; ++tileX){
+                if(!dirtyTiles[tileY * tilesX + tileX])
+                    continue;
+
+                int runBegin = tileX;
+                while(tileX + 1 < tilesX && dirtyTiles[tileY * tilesX + tileX + 1])
+                    ++tileX;
+
+                float x0 = float(runBegin * TILE_SIZE) / width * 2.f - 1.f;
+                float x1 = float(std::min(width, (tileX + 1) * TILE_SIZE)) / width * 2.f - 1.f;
+
+                vertexData.insert(vertexData.end(), { x1,y0, x0,y0, x0,y1, x0,y1, x1,y1, x1,y0 });
+            }
+        }
+
+        if(VAO_tiles == 0){
+            glGenVertexArrays(1, &VAO_tiles);
+            glBindVertexArray(VAO_tiles);
+
+            glGenBuffers(1, &VBO_tiles);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO_tiles);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+            glEnableVertexAttribArray(0);
+
+            glBindVertexArray(0);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_tiles);
+        glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(GLfloat), vertexData.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        vertexCount = int(vertexData.size() / 2);
+    }
+
+public:
+    /**
+     * Determines the dirty tiles of the new depth image (width x height, in
+     * mm, 0 = invalid) and uploads them for draw(). Everything is dirty if
+     * refreshAll is set or the depth is not available on the CPU.
+     */
+    void update(const uint16_t* depth, int imageWidth, int imageHeight, int dilationRadius, const std::vector<float>& currentDependencies,
+                const Settings& currentSettings, bool refreshAll){
+        settings = currentSettings;
+
+        if(imageWidth != width || imageHeight != height){
+            width = imageWidth;
+            height = imageHeight;
+            tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+            tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+            referenceDepth.assign(size_t(width) * height, 0);
+            changedTiles.assign(size_t(tilesX) * tilesY, 0);
+            dirtyTiles.assign(size_t(tilesX) * tilesY, 0);
+            settlingTiles.assign(size_t(tilesX) * tilesY, 0);
+            hasReference = false;
+        }
+
+        if(currentDependencies != dependencies){
+            dependencies = currentDependencies;
+            refreshAll = true;
+        }
+
+        ++framesSinceRefresh;
+        if(!hasReference || depth == nullptr || (settings.refreshInterval > 0 && framesSinceRefresh >= settings.refreshInterval))
+            refreshAll = true;
+
+        if(refreshAll){
+            // Without a reference, the temporal filter may just have started (or changed) everywhere:
+            if(!hasReference)
+                std::fill(changedTiles.begin(), changedTiles.end(), 1);
+            else
+                std::fill(changedTiles.begin(), changedTiles.end(), 0);
+            holdSettlingTiles();
+
+            std::fill(dirtyTiles.begin(), dirtyTiles.end(), 1);
+            framesSinceRefresh = 0;
+        } else {
+            detectChangedTiles(depth);
+            holdSettlingTiles();
+            dilate((dilationRadius + TILE_SIZE - 1) / TILE_SIZE);
+        }
+
+        if(depth != nullptr)
+            updateReference(depth);
+        hasReference = depth != nullptr;
+
+        dirtyTileCount = int(std::count(dirtyTiles.begin(), dirtyTiles.end(), 1));
+        skippedRatio = skippedRatio * 0.95f + (1.f - float(dirtyTileCount) / dirtyTiles.size()) * 0.05f;
+
+        uploadTiles();
+    }
+
+    /** Draws the dirty tiles (with the vertex layout of the fullscreen quad) */
+    void draw() const {
+        if(vertexCount == 0)
+            return;
+
+        glBindVertexArray(VAO_tiles);
+        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    }
+
+    bool hasDirtyTiles() const {
+        return dirtyTileCount > 0;
+    }
+
+    bool isFullyDirty() const {
+        return dirtyTileCount == int(dirtyTiles.size());
+    }
+
+    /** Fraction of the tiles which were not recomputed (smoothed over the frames) */
+    float getSkippedRatio() const {
+        return skippedRatio;
+    }
+
+    /** Recomputes everything in the next update (e.g. after the results were computed without the mask) */
+    void invalidate(){
+        hasReference = false;
+    }
+
+    /** Deletes the GL resources and the reference (the mask starts over on the next update) */
+    void release(){
+        if(VAO_tiles != 0){
+            glDeleteVertexArrays(1, &VAO_tiles);
+            glDeleteBuffers(1, &VBO_tiles);
+        }
+        *this = DirtyTileMask();
+    }
+};
@@ -0,0 +1,191 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+// Include OpenGL3.3 Core functions:
+#include <glad/glad.h>
+
+#include "src/gl/Shader.h"
+
+/**
+ * The render targets of the BlendPCR screen passes (used by BlendPCRRenderer
+ * and Rectification).
+ *
+ * The separate screen rendering of each camera goes into one layer of a
+ * texture array per attribute (color, vertices, normals, depth), indexed by
+ * the camera ID. The camera weights (fraction of neighbouring pixels in which
+ * a camera is the major camera) are stored in an R8 texture array with one
+ * layer per camera as well. This way, the merging passes bind a constant
+ * number of samplers regardless of the camera count.
+ *
+ * The arrays are reallocated when the screen size or the camera count changes.
+ */
+class ScreenPassTargets {
+    static void generateAndBind2DTextureArray(
+        unsigned int& texture,
+        unsigned int width,
+        unsigned int height,
+        unsigned int layers,
+        unsigned int internalFormat, // eg. GL_R8, GL_RGBA8, GL_RGBA32F,...
+        unsigned int format, // e.g. only GL_RED, GL_RG, GL_RGB, GL_BGR, GL_RGBA, GL_BGRA without Sizes!
+        unsigned int type, // egl. GL_UNSIGNED_BYTE, GL_FLOAT
+        unsigned int filter // GL_LINEAR or GL_NEAREST
+        ){
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, type, NULL);
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if(format == GL_DEPTH_COMPONENT){
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+        }
+    }
+
+    void release(){
+        if(width == -1)
+            return;
+
+        glDeleteFramebuffers(GLsizei(fbo_screen.size()), fbo_screen.data());
+        glDeleteTextures(1, &textureArray_screenColor);
+        glDeleteTextures(1, &textureArray_screenVertices);
+        glDeleteTextures(1, &textureArray_screenNormals);
+        glDeleteTextures(1, &textureArray_screenDepth);
+
+        glDeleteFramebuffers(1, &fbo_majorCam);
+        glDeleteTextures(1, &texture2D_majorCam);
+
+        glDeleteFramebuffers(1, &fbo_cameraWeights);
+        glDeleteTextures(1, &textureArray_cameraWeights);
+
+        fbo_screen.clear();
+        width = -1;
+        height = -1;
+        layers = 0;
+    }
+
+public:
+    int width = -1;
+    int height = -1;
+
+    /** Number of layers (= camera count) */
+    int layers = 0;
+
+    int miniWidth = -1;
+    int miniHeight = -1;
+
+    // The fbos (one per layer) and texture arrays for the separate screen rendering passes:
+    std::vector<unsigned int> fbo_screen;
+    unsigned int textureArray_screenColor = 0;
+    unsigned int textureArray_screenVertices = 0;
+    unsigned int textureArray_screenNormals = 0;
+    unsigned int textureArray_screenDepth = 0;
+
+    // The fbo and texture for the major cam pass:
+    unsigned int fbo_majorCam = 0;
+    unsigned int texture2D_majorCam = 0;
+
+    // The fbo (one attachment per layer) and texture array for the camera weights:
+    unsigned int fbo_cameraWeights = 0;
+    unsigned int textureArray_cameraWeights = 0;
+
+    ~ScreenPassTargets(){
+        release();
+    }
+
+    /**
+     * (Re)allocates the targets if the screen size or the camera count changed.
+     * The camera count is limited by GL_MAX_COLOR_ATTACHMENTS (at least 8).
+     */
+    void ensure(int screenWidth, int screenHeight, int cameraCount){
+        if(screenWidth == width && screenHeight == height && cameraCount == layers)
+            return;
+
+        int originalFramebuffer;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &originalFramebuffer);
+
+        release();
+
+        std::cout << "Generate FBO Screen (" << screenWidth << " x " << screenHeight << ", " << cameraCount << " cameras)" << std::endl;
+
+        // Generate resources for SCREEN SPACE PASS:
+        generateAndBind2DTextureArray(textureArray_screenColor, screenWidth, screenHeight, cameraCount, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
+        generateAndBind2DTextureArray(textureArray_screenVertices, screenWidth, screenHeight, cameraCount, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        generateAndBind2DTextureArray(textureArray_screenNormals, screenWidth, screenHeight, cameraCount, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        generateAndBind2DTextureArray(textureArray_screenDepth, screenWidth, screenHeight, cameraCount, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+
+        fbo_screen.resize(cameraCount);
+        glGenFramebuffers(cameraCount, fbo_screen.data());
+        for(int layer = 0; layer < cameraCount; ++layer){
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_screen[layer]);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureArray_screenColor, 0, layer);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, textureArray_screenVertices, 0, layer);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, textureArray_screenNormals, 0, layer);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, textureArray_screenDepth, 0, layer);
+        }
+
+        miniWidth = screenWidth / 4;
+        miniHeight = screenHeight / 4;
+
+        glGenFramebuffers(1, &fbo_majorCam);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
+
+        glGenTextures(1, &texture2D_majorCam);
+        glBindTexture(GL_TEXTURE_2D, texture2D_majorCam);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, miniWidth, miniHeight, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_majorCam, 0);
+
+        glGenFramebuffers(1, &fbo_cameraWeights);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
+
+        generateAndBind2DTextureArray(textureArray_cameraWeights, miniWidth, miniHeight, cameraCount, GL_R8, GL_RED, GL_UNSIGNED_BYTE, GL_NEAREST);
+        for(int layer = 0; layer < cameraCount; ++layer)
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + layer, textureArray_cameraWeights, 0, layer);
+
+        width = screenWidth;
+        height = screenHeight;
+        layers = cameraCount;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, originalFramebuffer);
+    }
+
+    /** Enables one draw buffer per camera weight layer on the bound fbo_cameraWeights */
+    void setCameraWeightsDrawBuffers(){
+        std::vector<GLenum> attachments(layers);
+        for(int layer = 0; layer < layers; ++layer)
+            attachments[layer] = GL_COLOR_ATTACHMENT0 + layer;
+        glDrawBuffers(layers, attachments.data());
+    }
+
+    /**
+     * Binds the screen texture arrays to the samplers color, vertices, normals
+     * and depth (starting at currentTexture, which is advanced).
+     */
+    void bindScreenTextures(Shader& shader, unsigned int& currentTexture){
+        const unsigned int textures[4] = {textureArray_screenColor, textureArray_screenVertices, textureArray_screenNormals, textureArray_screenDepth};
+        const char* names[4] = {"color", "vertices", "normals", "depth"};
+
+        for(int i = 0; i < 4; ++i){
+            glActiveTexture(GL_TEXTURE0 + currentTexture);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, textures[i]);
+            shader.setUniform(names[i], int(currentTexture));
+            ++currentTexture;
+        }
+    }
+
+    /** Binds the camera weights texture array to the sampler cameraWeights */
+    void bindCameraWeights(Shader& shader, unsigned int& currentTexture){
+        glActiveTexture(GL_TEXTURE0 + currentTexture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray_cameraWeights);
+        shader.setUniform("cameraWeights", int(currentTexture));
+        ++currentTexture;
+    }
+};
@@ -3,6 +3,8 @@
 #include "src/processing/blendpcr/ShadowAvoidance.h"
 
 #include "src/simulation/scene/components/Projector.h"
+#include "src/gl/GPUProfiler.h"
+#include "src/simulation/scene/SceneUniforms.h"
 
 
 void ShadowAvoidance::glTick(){
@@ -30,8 +32,11 @@ void ShadowAvoidance::glTick(){
 
     Mat4f projectorProjectionMatrix = Mat4f::perspectiveTransformation(16.f / 9.f, 40.f, 0.01f, 1000.f);
 
+    GPUProfiler& profiler = GPUProfiler::getInstance();
+
     {
         // PASS 1:
+        profiler.begin("Projector Distance Maps");
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         for(int projectorID = 0; projectorID < Data::instance.projectors.size(); ++projectorID){
             glViewport(0, 0, fbo_screen_width, fbo_screen_height);
@@ -46,9 +51,24 @@ void ShadowAvoidance::glTick(){
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
 
+        profiler.end();
+
         // PASS 2:
+        profiler.begin("Vertex Shadow Maps");
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
+        // The projector and camera parameters are in the uniform blocks (see SceneUniforms),
+        // the distance maps are the same for all cameras:
+        vertexShadowMapShader.bind();
+        SceneUniforms::bindBlocks(vertexShadowMapShader);
+        vertexShadowMapShader.setUniform("distanceMapProjection", projectorProjectionMatrix);
+
+        for(int projectorID = 0; projectorID < std::min<int>(Data::instance.projectors.size(), PROJECTOR_COUNT); ++projectorID){
+            glActiveTexture(GL_TEXTURE2 + projectorID);
+            glBindTexture(GL_TEXTURE_2D, texture2D_projectorDistanceMap[projectorID]);
+            vertexShadowMapShader.setUniform("projectorDistanceMaps["+std::to_string(projectorID)+"]", 2 + projectorID);
+        }
+
         for(unsigned int cameraID : pctextures.usedCameraIDs){
             if(!pctextures.cameraIsUpdatedThisFrame[cameraID])
                 continue;
@@ -57,27 +77,20 @@ void ShadowAvoidance::glTick(){
             glBindFramebuffer(GL_FRAMEBUFFER, pctextures.fbo_vertexShadowMap[cameraID]);
             glClear(GL_COLOR_BUFFER_BIT);
 
-            vertexShadowMapShader.bind();
             glActiveTexture(GL_TEXTURE1);
             glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[cameraID]);
             vertexShadowMapShader.setUniform("vertexTexture", 1);
 
-            vertexShadowMapShader.setUniform("model", pctextures.pointCloudMatrix[cameraID]);
-
-            for(int projectorID = 0; projectorID < Data::instance.projectors.size(); ++projectorID){
-                glActiveTexture(GL_TEXTURE2 + projectorID);
-                glBindTexture(GL_TEXTURE_2D, texture2D_projectorDistanceMap[projectorID]);
-                vertexShadowMapShader.setUniform("projectors["+std::to_string(projectorID)+"].distanceMap", 2 + projectorID);
-
-                vertexShadowMapShader.setUniform("projectors["+std::to_string(projectorID)+"].projection", projectorProjectionMatrix);//Data::instance.projectors[projectorID]->projectionMatrix);
-                vertexShadowMapShader.setUniform("projectors["+std::to_string(projectorID)+"].view", Data::instance.projectors[projectorID]->transformation.inverse());
-            }
+            vertexShadowMapShader.setUniform("cameraID", int(cameraID));
 
             glBindVertexArray(pctextures.VAO_quad);
             glDrawArrays(GL_TRIANGLES, 0, 6);
         }
 
+        profiler.end();
+
         // PASS 3:
+        profiler.begin("Vertex Distance Maps");
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
         for(unsigned int cameraID : pctextures.usedCameraIDs){
@@ -101,13 +114,6 @@ void ShadowAvoidance::glTick(){
                     glBindTexture(GL_TEXTURE_2D, i % 2 == 0 ? pctextures.texture2D_jumpFloodingPong : pctextures.texture2D_jumpFloodingPing);
                     jumpFloodingShader.setUniform("inputPingPong", 2);
 
-                    jumpFloodingShader.setUniform("model", pctextures.pointCloudMatrix[cameraID]);
-
-                    for(int projectorID = 0; projectorID < Data::instance.projectors.size(); ++projectorID){
-                        jumpFloodingShader.setUniform("projectors["+std::to_string(projectorID)+"].projection", Data::instance.projectors[projectorID]->projectionMatrix);
-                        jumpFloodingShader.setUniform("projectors["+std::to_string(projectorID)+"].view", Data::instance.projectors[projectorID]->transformation.inverse());
-                    }
-
                     jumpFloodingShader.setUniform("k", 1 << (max-1-i));
 
                     jumpFloodingShader.setUniform("isFirstPass", i==0);
@@ -124,6 +130,7 @@ void ShadowAvoidance::glTick(){
                 glClear(GL_COLOR_BUFFER_BIT);
 
                 vertexDistanceMapShader.bind();
+                SceneUniforms::bindBlocks(vertexDistanceMapShader);
                 glActiveTexture(GL_TEXTURE1);
                 glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[cameraID]);
                 vertexDistanceMapShader.setUniform("vertexTexture", 1);
@@ -138,11 +145,6 @@ void ShadowAvoidance::glTick(){
 
                 vertexDistanceMapShader.setUniform("model", pctextures.pointCloudMatrix[cameraID]);
 
-                for(int projectorID = 0; projectorID < Data::instance.projectors.size(); ++projectorID){
-                    /** Projectors viewing direction in World Space: */
-                    vertexDistanceMapShader.setUniform("projectors["+std::to_string(projectorID)+"].direction", Data::instance.projectors[projectorID]->transformation * Vec4f(0, 0, 1, 0));
-                }
-
                 glBindVertexArray(pctextures.VAO_quad);
                 glDrawArrays(GL_TRIANGLES, 0, 6);
             }
@@ -152,7 +154,10 @@ void ShadowAvoidance::glTick(){
             //}
         }
 
+        profiler.end();
+
         // PASS 4 (Global Distance Map):
+        profiler.begin("Global Distance Maps");
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
         for(unsigned int cameraID : pctextures.usedCameraIDs){
@@ -164,45 +169,60 @@ void ShadowAvoidance::glTick(){
             glClear(GL_COLOR_BUFFER_BIT);
 
             globalDistanceMapShader.bind();
+            SceneUniforms::bindBlocks(globalDistanceMapShader);
+            glBindVertexArray(pctextures.VAO_quad);
 
-            int textureSlot = 1;
-            for(unsigned int cID : pctextures.usedCameraIDs){
-                glActiveTexture(GL_TEXTURE0 + textureSlot);
-                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[cID]);
-                globalDistanceMapShader.setUniform("vertexTextures["+std::to_string(cID)+"]", textureSlot);
-                ++textureSlot;
-
-                glActiveTexture(GL_TEXTURE0 + textureSlot);
-                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_vertexDistanceMap[cID]);
-                globalDistanceMapShader.setUniform("distanceTextures["+std::to_string(cID)+"]", textureSlot);
-                ++textureSlot;
-
-                glActiveTexture(GL_TEXTURE0 + textureSlot);
-                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_inputLookupImageTo3D[cID]);
-                globalDistanceMapShader.setUniform("lookupImageTo3D["+std::to_string(cID)+"]", textureSlot);
-                ++textureSlot;
-
-                glActiveTexture(GL_TEXTURE0 + textureSlot);
-                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_inputLookup3DToImage[cID]);
-                globalDistanceMapShader.setUniform("lookup3DToImage["+std::to_string(cID)+"]", textureSlot);
-                ++textureSlot;
-
-                globalDistanceMapShader.setUniform("model["+std::to_string(cID)+"]", pctextures.pointCloudMatrix[cID]);
-                globalDistanceMapShader.setUniform("view["+std::to_string(cID)+"]", pctextures.pointCloudMatrix[cID].inverse());
-            }
-
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[cameraID]);
+            globalDistanceMapShader.setUniform("vertexTexture", 1);
             globalDistanceMapShader.setUniform("cameraID", int(cameraID));
-            globalDistanceMapShader.setUniform("cameraNum", int(pctextures.usedCameraIDs.size()));
 
-            glBindVertexArray(pctextures.VAO_quad);
+            // Start with the distances of the current camera:
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_vertexDistanceMap[cameraID]);
+            globalDistanceMapShader.setUniform("otherDistanceTexture", 3);
+            globalDistanceMapShader.setUniform("copyCurrent", true);
             glDrawArrays(GL_TRIANGLES, 0, 6);
 
+            // Take the minimum with the distances of every other camera on the same surface
+            // (one draw per camera, so that the bound textures do not depend on the camera count):
+            glEnable(GL_BLEND);
+            glBlendEquation(GL_MIN);
+            globalDistanceMapShader.setUniform("copyCurrent", false);
+
+            for(unsigned int otherCameraID : pctextures.usedCameraIDs){
+                if(otherCameraID == cameraID)
+                    continue;
+
+                glActiveTexture(GL_TEXTURE2);
+                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[otherCameraID]);
+                globalDistanceMapShader.setUniform("otherVertexTexture", 2);
+
+                glActiveTexture(GL_TEXTURE3);
+                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_vertexDistanceMap[otherCameraID]);
+                globalDistanceMapShader.setUniform("otherDistanceTexture", 3);
+
+                glActiveTexture(GL_TEXTURE4);
+                glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_inputLookup3DToImage[otherCameraID]);
+                globalDistanceMapShader.setUniform("otherLookup3DToImage", 4);
+
+                globalDistanceMapShader.setUniform("otherCameraID", int(otherCameraID));
+
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+            }
+
+            glBlendEquation(GL_FUNC_ADD);
+            glDisable(GL_BLEND);
+
             if(cameraID == 0){
                 //Data::instance.texture_debugSlot2 = texture2D_globalDistanceMap[cameraID];
             }
         }
 
+        profiler.end();
+
         // Pass 5 (Temporal distance map):
+        profiler.begin("Temporal Distance Maps");
         for(unsigned int cameraID : pctextures.usedCameraIDs){
             if(!pctextures.cameraIsUpdatedThisFrame[cameraID])
                 continue;
@@ -229,8 +249,12 @@ void ShadowAvoidance::glTick(){
         }
         pctextures.temporalDistanceFlipFlop = !pctextures.temporalDistanceFlipFlop;
 
+        profiler.end();
+
         // Segmentation Downscale:
+        profiler.begin("Segmentation Downscale");
         GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        const Mat4f inverseUIMatrix = Data::instance.virtualDisplayTransform.inverse();
         //glViewport(0, 0, 256, 256);
         for(unsigned int cameraID : pctextures.usedCameraIDs){
             if(!pctextures.cameraIsUpdatedThisFrame[cameraID])
@@ -253,7 +277,7 @@ void ShadowAvoidance::glTick(){
 			}
 
             segmentationDownscaleShader.setUniform("camModel", pctextures.pointCloudMatrix[cameraID]);
-            segmentationDownscaleShader.setUniform("inverseUIMatrix", Data::instance.virtualDisplayTransform.inverse());
+            segmentationDownscaleShader.setUniform("inverseUIMatrix", inverseUIMatrix);
             segmentationDownscaleShader.setUniform("spectatorPosWS", Data::instance.virtualDisplaySpectator);
 
             glBindVertexArray(pctextures.VAO_quad);
@@ -264,7 +288,10 @@ void ShadowAvoidance::glTick(){
             }
         }
 
+        profiler.end();
+
         // Pass 6 (Projector Assignment):
+        profiler.begin("Projector Assignment");
         for(unsigned int cameraID : pctextures.usedCameraIDs){
             if(!pctextures.cameraIsUpdatedThisFrame[cameraID])
                 continue;
@@ -276,6 +303,7 @@ void ShadowAvoidance::glTick(){
             glClear(GL_COLOR_BUFFER_BIT);
 
             vertexProjectorAssignmentShader.bind();
+            SceneUniforms::bindBlocks(vertexProjectorAssignmentShader);
             glActiveTexture(GL_TEXTURE1);
             glBindTexture(GL_TEXTURE_2D, pctextures.texture2D_mlsVertices[cameraID]);
             vertexProjectorAssignmentShader.setUniform("vertexTexture", 1);
@@ -288,16 +316,7 @@ void ShadowAvoidance::glTick(){
 
             vertexProjectorAssignmentShader.setUniform("distanceTexture", 2);
 
-            vertexProjectorAssignmentShader.setUniform("model", pctextures.pointCloudMatrix[cameraID]);
-
-            for(int projectorID = 0; projectorID < Data::instance.projectors.size(); ++projectorID){
-                /** Projectors viewing direction in World Space: */
-                vertexProjectorAssignmentShader.setUniform("projectors["+std::to_string(projectorID)+"].position", Data::instance.projectors[projectorID]->transformation.getPosition());
-                vertexProjectorAssignmentShader.setUniform("projectors["+std::to_string(projectorID)+"].direction", Data::instance.projectors[projectorID]->transformation * Vec4f(0, 0, 1, 0));
-
-                vertexProjectorAssignmentShader.setUniform("projectors["+std::to_string(projectorID)+"].projection", Data::instance.projectors[projectorID]->projectionMatrix);
-                vertexProjectorAssignmentShader.setUniform("projectors["+std::to_string(projectorID)+"].view", Data::instance.projectors[projectorID]->transformation.inverse());
-            }
+            vertexProjectorAssignmentShader.setUniform("cameraID", int(cameraID));
 
             glBindVertexArray(pctextures.VAO_quad);
             glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -306,6 +325,7 @@ void ShadowAvoidance::glTick(){
                 //Data::instance.texture_debugSlot3 = texture2D_vertexProjectorAssignment[cameraID];
             }
         }
+        profiler.end();
 	}
 
     // Restore viewport and framebuffer:
@@ -313,4 +333,6 @@ void ShadowAvoidance::glTick(){
     glBindFramebuffer(GL_FRAMEBUFFER, originalFramebuffer);
 
     glFlush();
+
+    LatencyTracer::getInstance().stamp(LATENCY_SHADOW_AVOIDANCE);
 }
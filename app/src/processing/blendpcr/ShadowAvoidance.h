@@ -79,7 +79,7 @@ public:
     std::shared_ptr<UIRenderer> dummyUIRenderer = nullptr;
 
 public:
-    Vec4f estimatedMarkerPositions[CAMERA_COUNT * 4];
+    Vec4f estimatedMarkerPositions[MAX_CAMERA_COUNT * 4];
 
     /** I2DShadowAvoidance */
     ShadowAvoidance(std::shared_ptr<UIRenderer> uiRenderer)
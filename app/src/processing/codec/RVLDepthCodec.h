@@ -0,0 +1,212 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Lossless depth image codec based on RVL (Wilson, "Fast Lossless Depth Image
+ * Compression", ISS 2017).
+ *
+ * The image is split into alternating runs of zero (invalid) and non-zero
+ * pixels. For non-zero pixels, the zigzag encoded difference to the previous
+ * valid pixel is stored. All numbers are written with a variable length code
+ * of 3 bit nibbles (+1 continuation bit), packed into 32 bit words.
+ *
+ * Encoded layout: uint32 pixel count, followed by the packed words.
+ */
+class RVLDepthCodec {
+    /** Variable length codes for values < 512 (code << 8 | bit count) */
+    struct CodeTable {
+        uint32_t entries[512];
+
+        CodeTable(){
+            for(uint32_t value = 0; value < 512; ++value){
+                uint32_t remaining = value;
+                uint32_t code = 0;
+                uint32_t bits = 0;
+                do {
+                    uint32_t nibble = remaining & 7;
+                    remaining >>= 3;
+                    if(remaining)
+                        nibble |= 8;
+                    code = (code << 4) | nibble;
+                    bits += 4;
+                } while(remaining);
+                entries[value] = code << 8 | bits;
+            }
+        }
+    };
+
+    static inline const CodeTable codeTable;
+
+    struct NibbleWriter {
+        uint32_t* words;
+
+        /** Pending nibbles (the oldest in the most significant bits) */
+        uint64_t pending = 0;
+        int pendingBits = 0;
+
+        inline void write(uint32_t value){
+            // Build the whole variable length code first (the first nibble
+            // contains the lowest 3 bits), then append it at once:
+            uint64_t code;
+            int bits;
+            if(value < 512){
+                code = codeTable.entries[value] >> 8;
+                bits = codeTable.entries[value] & 0xFF;
+            } else {
+                code = 0;
+                bits = 0;
+                do {
+                    uint32_t nibble = value & 7;
+                    value >>= 3;
+                    if(value)
+                        nibble |= 8;
+                    code = (code << 4) | nibble;
+                    bits += 4;
+                } while(value);
+            }
+
+            pending = (pending << bits) | code;
+            pendingBits += bits;
+            if(pendingBits >= 32){
+                pendingBits -= 32;
+                *words++ = uint32_t(pending >> pendingBits);
+            }
+        }
+
+        inline void flush(){
+            if(pendingBits > 0)
+                *words++ = uint32_t(pending << (32 - pendingBits));
+            pendingBits = 0;
+        }
+    };
+
+    struct NibbleReader {
+        const uint32_t* words;
+        const uint32_t* end;
+        uint32_t word = 0;
+        int nibbles = 0;
+        bool overflow = false;
+
+        inline uint32_t read(){
+            uint32_t value = 0;
+            int shift = 0;
+            uint32_t nibble;
+            do {
+                if(nibbles == 0){
+                    if(words == end){
+                        overflow = true;
+                        return 0;
+                    }
+                    word = *words++;
+                    nibbles = 8;
+                }
+                nibble = word >> 28;
+                word <<= 4;
+                --nibbles;
+
+                value |= (nibble & 7) << shift;
+                shift += 3;
+            } while((nibble & 8) && shift < 32);
+            return value;
+        }
+    };
+
+public:
+    /** Upper bound of the encoded size in bytes for the given pixel count. */
+    static size_t maxEncodedSize(size_t count){
+        // Worst case (alternating single zero / non-zero pixels): 8 nibbles per pixel
+        return sizeof(uint32_t) + (count + 4) * sizeof(uint32_t);
+    }
+
+    /** Encodes count depth values and returns the number of bytes written. */
+    static size_t encode(const uint16_t* input, size_t count, uint8_t* output){
+        uint32_t pixelCount = uint32_t(count);
+        std::memcpy(output, &pixelCount, sizeof(uint32_t));
+
+        NibbleWriter writer;
+        writer.words = reinterpret_cast<uint32_t*>(output + sizeof(uint32_t));
+        uint32_t* firstWord = writer.words;
+
+        const uint16_t* end = input + count;
+        int previous = 0;
+
+        while(input != end){
+            uint32_t zeros = 0;
+            while(input != end && *input == 0){
+                ++input;
+                ++zeros;
+            }
+            writer.write(zeros);
+
+            const uint16_t* nonZeroStart = input;
+            while(input != end && *input != 0)
+                ++input;
+            writer.write(uint32_t(input - nonZeroStart));
+
+            for(const uint16_t* p = nonZeroStart; p != input; ++p){
+                int delta = int(*p) - previous;
+                writer.write((uint32_t(delta) << 1) ^ uint32_t(delta >> 31));
+                previous = *p;
+            }
+        }
+        writer.flush();
+
+        return sizeof(uint32_t) + (writer.words - firstWord) * sizeof(uint32_t);
+    }
+
+    /** Encodes count depth values into the given vector (which is resized). */
+    static void encode(const uint16_t* input, size_t count, std::vector<uint8_t>& output){
+        output.resize(maxEncodedSize(count));
+        output.resize(encode(input, count, output.data()));
+    }
+
+    /**
+     * Decodes exactly count depth values. Returns false if the data is corrupt
+     * or does not contain count values.
+     */
+    static bool decode(const uint8_t* input, size_t size, uint16_t* output, size_t count){
+        if(size < sizeof(uint32_t) || (size - sizeof(uint32_t)) % sizeof(uint32_t) != 0)
+            return false;
+
+        uint32_t pixelCount;
+        std::memcpy(&pixelCount, input, sizeof(uint32_t));
+        if(pixelCount != count)
+            return false;
+
+        NibbleReader reader;
+        reader.words = reinterpret_cast<const uint32_t*>(input + sizeof(uint32_t));
+        reader.end = reader.words + (size - sizeof(uint32_t)) / sizeof(uint32_t);
+
+        uint16_t* end = output + count;
+        int previous = 0;
+
+        while(output != end){
+            uint32_t zeros = reader.read();
+            if(reader.overflow || zeros > uint32_t(end - output))
+                return false;
+
+            std::memset(output, 0, zeros * sizeof(uint16_t));
+            output += zeros;
+
+            uint32_t nonZeros = reader.read();
+            if(reader.overflow || nonZeros > uint32_t(end - output))
+                return false;
+
+            for(uint16_t* last = output + nonZeros; output != last; ++output){
+                uint32_t positive = reader.read();
+                int delta = int(positive >> 1) ^ -int(positive & 1);
+                previous += delta;
+                *output = uint16_t(previous);
+            }
+
+            if(reader.overflow)
+                return false;
+        }
+        return true;
+    }
+};
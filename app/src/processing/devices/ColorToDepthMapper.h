@@ -0,0 +1,190 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Builds a dense map from the pixels of the (high res) color image to the
+ * depth pixels which are visible there.
+ *
+ * Instead of searching along the epipolar line for every queried color pixel,
+ * all valid depth pixels are splatted into the color image once: Each depth
+ * pixel is transformed into the color camera, projected (Brown-Conrady with
+ * rational radial distortion, k4..k6 may be zero) and its footprint is filled
+ * with a z-test, so that the nearest surface wins.
+ *
+ * The depth independent part (depth pixel ray rotated into the color camera)
+ * is computed once in the constructor, so per frame only a multiply-add and
+ * the projection remain per depth pixel.
+ */
+class ColorToDepthMapper {
+public:
+    struct Intrinsics {
+        float fx, fy, cx, cy;
+    };
+
+    struct Distortion {
+        float k1 = 0.f, k2 = 0.f, k3 = 0.f, k4 = 0.f, k5 = 0.f, k6 = 0.f;
+        float p1 = 0.f, p2 = 0.f;
+    };
+
+private:
+    int depthWidth, depthHeight;
+    int colorWidth, colorHeight;
+
+    Intrinsics colorIntrinsics;
+    Distortion colorDistortion;
+
+    /** Rotation depth -> color camera (row major) */
+    float rotation[9];
+
+    /** Translation depth -> color camera in mm */
+    float translation[3];
+
+    /** Ray (x/z, y/z, 1) of every depth pixel rotated into the color camera */
+    std::vector<float> rotatedRays;
+
+    /** Size of a depth pixel in color pixels at equal distance (x, y) */
+    float footprintX = 1.f, footprintY = 1.f;
+
+    /** Nearest (depth << 32 | depth pixel index) per color pixel, reused for every frame */
+    std::unique_ptr<std::atomic<uint64_t>[]> zBuffer;
+    std::mutex zBufferMutex;
+
+    static constexpr uint64_t EMPTY = ~uint64_t(0);
+
+    inline bool project(float x, float y, float z, float& u, float& v) const {
+        if(z <= 0.f)
+            return false;
+
+        float xn = x / z;
+        float yn = y / z;
+        float r2 = xn * xn + yn * yn;
+        float r4 = r2 * r2;
+        float r6 = r4 * r2;
+
+        const Distortion& d = colorDistortion;
+        float radial = (1.f + d.k1 * r2 + d.k2 * r4 + d.k3 * r6) / (1.f + d.k4 * r2 + d.k5 * r4 + d.k6 * r6);
+        float xd = xn * radial + 2.f * d.p1 * xn * yn + d.p2 * (r2 + 2.f * xn * xn);
+        float yd = yn * radial + d.p1 * (r2 + 2.f * yn * yn) + 2.f * d.p2 * xn * yn;
+
+        u = colorIntrinsics.fx * xd + colorIntrinsics.cx;
+        v = colorIntrinsics.fy * yd + colorIntrinsics.cy;
+        return true;
+    }
+
+    static inline void atomicMin(std::atomic<uint64_t>& target, uint64_t value){
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while(value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+
+public:
+    /**
+     * @param lookupImageTo3D   Ray (x/z, y/z) per depth pixel (as OrganizedPointCloud::lookupImageTo3D)
+     * @param rotation          Rotation depth -> color camera (row major)
+     * @param translationMm     Translation depth -> color camera in mm
+     */
+    ColorToDepthMapper(int depthWidth, int depthHeight, const float* lookupImageTo3D,
+                       int colorWidth, int colorHeight, Intrinsics colorIntrinsics, Distortion colorDistortion,
+                       const float rotation[9], const float translationMm[3])
+        : depthWidth(depthWidth)
+        , depthHeight(depthHeight)
+        , colorWidth(colorWidth)
+        , colorHeight(colorHeight)
+        , colorIntrinsics(colorIntrinsics)
+        , colorDistortion(colorDistortion)
+        , rotatedRays(size_t(depthWidth) * depthHeight * 3)
+        , zBuffer(new std::atomic<uint64_t>[size_t(colorWidth) * colorHeight])
+    {
+        std::copy(rotation, rotation + 9, this->rotation);
+        std::copy(translationMm, translationMm + 3, translation);
+
+        for(size_t i = 0; i < size_t(depthWidth) * depthHeight; ++i){
+            float rx = lookupImageTo3D[i * 2];
+            float ry = lookupImageTo3D[i * 2 + 1];
+            rotatedRays[i * 3]     = rotation[0] * rx + rotation[1] * ry + rotation[2];
+            rotatedRays[i * 3 + 1] = rotation[3] * rx + rotation[4] * ry + rotation[5];
+            rotatedRays[i * 3 + 2] = rotation[6] * rx + rotation[7] * ry + rotation[8];
+        }
+
+        // Footprint of one depth pixel from the ray step in the image center:
+        size_t center = size_t(depthHeight / 2) * depthWidth + depthWidth / 2;
+        float stepX = std::abs(lookupImageTo3D[(center + 1) * 2] - lookupImageTo3D[center * 2]);
+        float stepY = std::abs(lookupImageTo3D[(center + depthWidth) * 2 + 1] - lookupImageTo3D[center * 2 + 1]);
+        footprintX = std::max(1.f, colorIntrinsics.fx * stepX);
+        footprintY = std::max(1.f, colorIntrinsics.fy * stepY);
+    }
+
+    /**
+     * Creates a mapper with the same color camera for another depth image
+     * resolution of the same sensor (e.g. a binned depth image).
+     */
+    std::shared_ptr<ColorToDepthMapper> forDepthImage(int width, int height, const float* lookupImageTo3D) const {
+        return std::make_shared<ColorToDepthMapper>(width, height, lookupImageTo3D, colorWidth, colorHeight,
+                                                    colorIntrinsics, colorDistortion, rotation, translation);
+    }
+
+    int getColorWidth() const { return colorWidth; }
+    int getColorHeight() const { return colorHeight; }
+
+    /**
+     * Fills map (colorWidth x colorHeight) with the index (y * depthWidth + x)
+     * of the nearest depth pixel visible at each color pixel, or -1.
+     */
+    void build(const uint16_t* depth, int32_t* map){
+        std::unique_lock lock(zBufferMutex);
+        const int colorPixels = colorWidth * colorHeight;
+        std::atomic<uint64_t>* z = zBuffer.get();
+
+        #pragma omp parallel for
+        for(int i = 0; i < colorPixels; ++i)
+            z[i].store(EMPTY, std::memory_order_relaxed);
+
+        #pragma omp parallel for
+        for(int y = 0; y < depthHeight; ++y){
+            for(int x = 0; x < depthWidth; ++x){
+                uint32_t index = uint32_t(y * depthWidth + x);
+                uint16_t d = depth[index];
+                if(d == 0)
+                    continue;
+
+                const float* ray = &rotatedRays[size_t(index) * 3];
+                float px = ray[0] * d + translation[0];
+                float py = ray[1] * d + translation[1];
+                float pz = ray[2] * d + translation[2];
+
+                float u, v;
+                if(!project(px, py, pz, u, v))
+                    continue;
+
+                // Half footprint of the depth pixel in the color image:
+                float halfX = 0.5f * footprintX * d / pz;
+                float halfY = 0.5f * footprintY * d / pz;
+
+                int minX = std::max(0, int(std::ceil(u - halfX)));
+                int maxX = std::min(colorWidth - 1, int(std::floor(u + halfX)));
+                int minY = std::max(0, int(std::ceil(v - halfY)));
+                int maxY = std::min(colorHeight - 1, int(std::floor(v + halfY)));
+
+                uint64_t key = uint64_t(d) << 32 | index;
+                for(int cy = minY; cy <= maxY; ++cy){
+                    for(int cx = minX; cx <= maxX; ++cx)
+                        atomicMin(z[cy * colorWidth + cx], key);
+                }
+            }
+        }
+
+        #pragma omp parallel for
+        for(int i = 0; i < colorPixels; ++i){
+            uint64_t key = z[i].load(std::memory_order_relaxed);
+            map[i] = key == EMPTY ? -1 : int32_t(key & 0xFFFFFFFFu);
+        }
+    }
+};
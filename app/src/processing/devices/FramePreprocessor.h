@@ -0,0 +1,236 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/WorkerPool.h"
+#include "src/processing/OrganizedPointCloud.h"
+#include "src/processing/LatencyTracer.h"
+#include "src/processing/devices/RGBDCamera.h"
+
+/**
+ * Preprocessing stage between the camera threads and the camera manager.
+ *
+ * A camera thread only enqueues its raw frame together with the conversion
+ * into an OrganizedPointCloud (e.g. alignment, copies, color conversion). The
+ * conversion, the registered CPU filters and the hand-over to the camera
+ * manager run on a worker pool of this stage, so the SDK threads are never
+ * blocked by them.
+ *
+ * Each device has its own bounded queue. The frames of a device are processed
+ * one after another (the conversions may use per-camera state like ob::Align),
+ * different devices in parallel. If a device delivers faster than its frames
+ * are processed, the oldest waiting frame is dropped. The time of each stage
+ * is measured per device.
+ */
+class FramePreprocessor {
+public:
+    enum Stage {
+        /** From enqueueing until a worker starts with the frame */
+        PREPROCESS_QUEUE = 0,
+
+        /** Conversion of the raw frame into an OrganizedPointCloud */
+        PREPROCESS_CONVERSION,
+
+        /** Registered CPU filters */
+        PREPROCESS_FILTERS,
+
+        /** Hand-over to the camera manager (recording, binning, mailbox) */
+        PREPROCESS_OUTPUT,
+
+        PREPROCESS_STAGE_COUNT
+    };
+
+    typedef std::function<std::shared_ptr<OrganizedPointCloud>()> Conversion;
+    typedef std::function<void(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud)> Output;
+    typedef std::function<void(int deviceIndex, OrganizedPointCloud& pointCloud)> Filter;
+
+    struct Statistics {
+        float meanMs[PREPROCESS_STAGE_COUNT] = {};
+        float p95Ms[PREPROCESS_STAGE_COUNT] = {};
+
+        uint64_t processedFrames = 0;
+        uint64_t droppedFrames = 0;
+        size_t queuedFrames = 0;
+    };
+
+    /** Maximum number of raw frames waiting per device */
+    static constexpr size_t QUEUE_CAPACITY = 2;
+
+private:
+    /** Number of frames the stage times are averaged over */
+    static constexpr size_t STATISTICS_SIZE = 300;
+
+    struct RawFrame {
+        Conversion conversion;
+        Output output;
+        int64_t enqueueUs = 0;
+    };
+
+    struct DeviceQueue {
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::deque<RawFrame> frames;
+
+        /** A worker is draining this queue */
+        bool scheduled = false;
+
+        uint64_t processedFrames = 0;
+        uint64_t droppedFrames = 0;
+        std::deque<float> stageMs[PREPROCESS_STAGE_COUNT];
+    };
+
+    std::array<DeviceQueue, MAX_RGBD_DEVICES> queues;
+
+    /** Replaced as a whole (accessed atomically, since the workers iterate over it) */
+    std::shared_ptr<const std::vector<Filter>> filters = std::make_shared<std::vector<Filter>>();
+
+    /** One worker per device is enough, since the frames of a device are processed in order */
+    WorkerPool workers{std::min<unsigned int>(MAX_RGBD_DEVICES, std::max(2u, std::thread::hardware_concurrency()) - 1)};
+
+    /** Processes the frames of the device until its queue is empty */
+    void drain(int deviceIndex){
+        DeviceQueue& queue = queues[deviceIndex];
+
+        while(true){
+            RawFrame frame;
+            {
+                std::unique_lock lock(queue.mutex);
+                if(queue.frames.empty()){
+                    queue.scheduled = false;
+                    queue.idle.notify_all();
+                    return;
+                }
+
+                frame = std::move(queue.frames.front());
+                queue.frames.pop_front();
+            }
+
+            float stageMs[PREPROCESS_STAGE_COUNT] = {};
+            int64_t startUs = FrameTrace::nowUs();
+            stageMs[PREPROCESS_QUEUE] = float(startUs - frame.enqueueUs) / 1000.f;
+
+            std::shared_ptr<OrganizedPointCloud> pointCloud = frame.conversion();
+            int64_t convertedUs = FrameTrace::nowUs();
+            stageMs[PREPROCESS_CONVERSION] = float(convertedUs - startUs) / 1000.f;
+
+            if(pointCloud == nullptr)
+                continue;
+
+            std::shared_ptr<const std::vector<Filter>> currentFilters = std::atomic_load(&filters);
+            for(const Filter& filter : *currentFilters)
+                filter(deviceIndex, *pointCloud);
+            int64_t filteredUs = FrameTrace::nowUs();
+            stageMs[PREPROCESS_FILTERS] = float(filteredUs - convertedUs) / 1000.f;
+
+            frame.output(deviceIndex, pointCloud);
+            stageMs[PREPROCESS_OUTPUT] = float(FrameTrace::nowUs() - filteredUs) / 1000.f;
+
+            std::unique_lock lock(queue.mutex);
+            ++queue.processedFrames;
+            for(int stage = 0; stage < PREPROCESS_STAGE_COUNT; ++stage){
+                queue.stageMs[stage].push_back(stageMs[stage]);
+                if(queue.stageMs[stage].size() > STATISTICS_SIZE)
+                    queue.stageMs[stage].pop_front();
+            }
+        }
+    }
+
+public:
+    static FramePreprocessor& getInstance(){
+        static FramePreprocessor instance;
+        return instance;
+    }
+
+    /**
+     * Queues the raw frame of the device (called by the camera thread). The
+     * conversion and the output are called on a worker; everything the
+     * conversion captures has to stay valid until flush(deviceIndex).
+     */
+    void enqueue(int deviceIndex, Conversion conversion, Output output){
+        if(deviceIndex < 0 || deviceIndex >= MAX_RGBD_DEVICES){
+            if(std::shared_ptr<OrganizedPointCloud> pointCloud = conversion())
+                output(deviceIndex, pointCloud);
+            return;
+        }
+
+        DeviceQueue& queue = queues[deviceIndex];
+        bool schedule = false;
+        {
+            std::unique_lock lock(queue.mutex);
+            if(queue.frames.size() >= QUEUE_CAPACITY){
+                queue.frames.pop_front();
+                ++queue.droppedFrames;
+            }
+
+            queue.frames.push_back({std::move(conversion), std::move(output), FrameTrace::nowUs()});
+
+            schedule = !queue.scheduled;
+            queue.scheduled = true;
+        }
+
+        if(schedule)
+            workers.enqueue([this, deviceIndex](){ drain(deviceIndex); });
+    }
+
+    /** Drops the waiting frames of the device and waits until the one in progress is done */
+    void flush(int deviceIndex){
+        if(deviceIndex < 0 || deviceIndex >= MAX_RGBD_DEVICES)
+            return;
+
+        DeviceQueue& queue = queues[deviceIndex];
+        std::unique_lock lock(queue.mutex);
+        queue.droppedFrames += queue.frames.size();
+        queue.frames.clear();
+        queue.idle.wait(lock, [&queue](){ return !queue.scheduled; });
+    }
+
+    /** Adds a CPU filter which is applied to every point cloud after its conversion (on a worker) */
+    void addFilter(Filter filter){
+        std::shared_ptr<std::vector<Filter>> newFilters = std::make_shared<std::vector<Filter>>(*std::atomic_load(&filters));
+        newFilters->push_back(filter);
+        std::atomic_store(&filters, std::shared_ptr<const std::vector<Filter>>(newFilters));
+    }
+
+    unsigned int getThreadCount() const {
+        return workers.getThreadCount();
+    }
+
+    Statistics getStatistics(int deviceIndex){
+        Statistics statistics;
+        if(deviceIndex < 0 || deviceIndex >= MAX_RGBD_DEVICES)
+            return statistics;
+
+        DeviceQueue& queue = queues[deviceIndex];
+        std::unique_lock lock(queue.mutex);
+        statistics.processedFrames = queue.processedFrames;
+        statistics.droppedFrames = queue.droppedFrames;
+        statistics.queuedFrames = queue.frames.size();
+
+        for(int stage = 0; stage < PREPROCESS_STAGE_COUNT; ++stage){
+            const std::deque<float>& values = queue.stageMs[stage];
+            if(values.empty())
+                continue;
+
+            std::vector<float> sorted(values.begin(), values.end());
+            std::sort(sorted.begin(), sorted.end());
+
+            float sum = 0.f;
+            for(float value : sorted)
+                sum += value;
+
+            statistics.meanMs[stage] = sum / float(sorted.size());
+            statistics.p95Ms[stage] = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+        }
+        return statistics;
+    }
+};
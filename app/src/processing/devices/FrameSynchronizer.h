@@ -0,0 +1,320 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "src/processing/OrganizedPointCloud.h"
+
+/**
+ * Groups the point clouds of all active cameras into coherent framesets by
+ * their timestamps, so that a tick does not blend a fresh frame of one camera
+ * with an older one of another camera.
+ *
+ * The synchronizer keeps the last frames of every camera. The reference time
+ * of a group is the newest frame of the camera that is furthest behind; every
+ * other camera contributes its newest frame within toleranceMs of it. If a
+ * camera has no such frame, or if it is behind the newest frame of the others
+ * by more than maxWaitMs (e.g. it stalls or runs at a lower rate), the
+ * fallback policy decides what happens with it.
+ *
+ * Must only be called from the OpenGL thread.
+ */
+class FrameSynchronizer {
+public:
+    enum FallbackPolicy {
+        /** Use the latest frame of every camera (no synchronization in this tick) */
+        FALLBACK_LATEST = 0,
+
+        /** Keep the last frame of the late camera and synchronize the others */
+        FALLBACK_HOLD_PREVIOUS,
+
+        /** Leave the late camera out of this tick */
+        FALLBACK_DROP
+    };
+
+    struct Statistics {
+        /** Skew (newest - oldest timestamp) of the last groups in ms */
+        float skewP50 = 0.f;
+        float skewP95 = 0.f;
+        float skewMax = 0.f;
+
+        /** Mean offset of each camera to the group's reference time in ms */
+        std::vector<float> meanOffset;
+
+        size_t groups = 0;
+        size_t groupsWithinTolerance = 0;
+        size_t fallbacks = 0;
+    };
+
+    bool enabled = true;
+
+    /**
+     * Frames closer than this to the reference time count as synchronous. At
+     * least half of the frame interval for cameras without hardware sync,
+     * since their frames are up to that far from the reference.
+     */
+    float toleranceMs = 17.f;
+
+    /** Cameras further behind than this are late and handled by the fallback policy */
+    float maxWaitMs = 50.f;
+
+    FallbackPolicy fallbackPolicy = FALLBACK_HOLD_PREVIOUS;
+
+private:
+    /** Number of frames kept per camera (~ 130 ms at 30 fps) */
+    static constexpr size_t HISTORY_SIZE = 4;
+
+    /** Number of groups the skew statistics are computed over */
+    static constexpr size_t STATISTICS_SIZE = 300;
+
+    struct CameraState {
+        std::deque<std::shared_ptr<OrganizedPointCloud>> history;
+        std::shared_ptr<OrganizedPointCloud> lastSelected;
+        std::deque<float> offsets;
+    };
+
+    std::vector<CameraState> cameras;
+    std::deque<float> skews;
+
+    /** Group of the previous tick (statistics only count new groups) */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> lastGroup;
+
+    size_t groups = 0;
+    size_t groupsWithinTolerance = 0;
+    size_t fallbacks = 0;
+
+    /** Timestamp in seconds (host arrival time for sources without device timestamp) */
+    static double getTime(const std::shared_ptr<OrganizedPointCloud>& pc){
+        if(pc->timestamp >= 0.0)
+            return pc->timestamp;
+        return pc->trace.stageUs[LATENCY_SDK_ARRIVAL] / 1000000.0;
+    }
+
+    /**
+     * True if the frame is older than the newest kept frame by more than the
+     * time span of the history (at least maxWaitMs), which cannot happen by a
+     * late delivery but only by a restarted clock.
+     */
+    bool isTimeReset(const CameraState& camera, const std::shared_ptr<OrganizedPointCloud>& pc) const {
+        if(camera.history.empty())
+            return false;
+
+        double newestTime = getTime(camera.history.back());
+        double span = std::max(newestTime - getTime(camera.history.front()), maxWaitMs / 1000.0);
+        return newestTime - getTime(pc) > span;
+    }
+
+    /**
+     * Newest frame of the camera within toleranceMs of the reference time (the
+     * one with the lowest latency of the synchronous ones), otherwise the
+     * closest one; never older than the last selected one. withinTolerance is
+     * false if the returned frame is not synchronous.
+     */
+    std::shared_ptr<OrganizedPointCloud> closestFrame(CameraState& camera, double referenceTime, bool& withinTolerance){
+        std::shared_ptr<OrganizedPointCloud> closest = nullptr;
+        std::shared_ptr<OrganizedPointCloud> newestSynchronous = nullptr;
+        double closestDistance = 0.0;
+        double minTime = camera.lastSelected ? getTime(camera.lastSelected) : -1e300;
+
+        for(const std::shared_ptr<OrganizedPointCloud>& pc : camera.history){
+            double time = getTime(pc);
+            if(time < minTime)
+                continue;
+
+            double distance = std::abs(time - referenceTime);
+            if(distance * 1000.0 <= toleranceMs && (newestSynchronous == nullptr || time >= getTime(newestSynchronous)))
+                newestSynchronous = pc;
+
+            if(closest == nullptr || distance < closestDistance){
+                closest = pc;
+                closestDistance = distance;
+            }
+        }
+
+        if(newestSynchronous != nullptr){
+            withinTolerance = true;
+            return newestSynchronous;
+        }
+
+        std::shared_ptr<OrganizedPointCloud> best = closest != nullptr ? closest : camera.lastSelected;
+        withinTolerance = best != nullptr && std::abs(getTime(best) - referenceTime) * 1000.0 <= toleranceMs;
+        return best;
+    }
+
+    void addStatistics(const std::vector<std::shared_ptr<OrganizedPointCloud>>& group, double referenceTime, bool fallback){
+        if(group == lastGroup)
+            return;
+        lastGroup = group;
+
+        double minTime = 1e300, maxTime = -1e300;
+        for(size_t i = 0; i < group.size(); ++i){
+            if(group[i] == nullptr)
+                continue;
+
+            double time = getTime(group[i]);
+            minTime = std::min(minTime, time);
+            maxTime = std::max(maxTime, time);
+
+            std::deque<float>& offsets = cameras[i].offsets;
+            offsets.push_back(float((time - referenceTime) * 1000.0));
+            if(offsets.size() > STATISTICS_SIZE)
+                offsets.pop_front();
+        }
+
+        if(maxTime < minTime)
+            return;
+
+        float skew = float((maxTime - minTime) * 1000.0);
+        skews.push_back(skew);
+        if(skews.size() > STATISTICS_SIZE)
+            skews.pop_front();
+
+        ++groups;
+        if(skew <= toleranceMs)
+            ++groupsWithinTolerance;
+        if(fallback)
+            ++fallbacks;
+    }
+
+public:
+    /**
+     * Takes the latest point cloud of each device (as returned by the camera
+     * manager) and returns the synchronized frameset (same indices).
+     */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> synchronize(const std::vector<std::shared_ptr<OrganizedPointCloud>>& latest){
+        if(cameras.size() < latest.size())
+            cameras.resize(latest.size());
+
+        // Append new frames to the history:
+        for(size_t i = 0; i < latest.size(); ++i){
+            std::deque<std::shared_ptr<OrganizedPointCloud>>& history = cameras[i].history;
+            if(latest[i] == nullptr || (!history.empty() && history.back() == latest[i]))
+                continue;
+
+            // The time jumped back (looping replay, device timestamp reset), so the
+            // kept frames would hide all new ones in closestFrame:
+            if(isTimeReset(cameras[i], latest[i])){
+                history.clear();
+                cameras[i].lastSelected = nullptr;
+            }
+
+            history.push_back(latest[i]);
+            if(history.size() > HISTORY_SIZE)
+                history.pop_front();
+        }
+
+        if(!enabled)
+            return latest;
+
+        // Newest timestamp of every camera:
+        std::vector<double> newest(latest.size(), 0.0);
+        double newestOverall = -1e300;
+        for(size_t i = 0; i < latest.size(); ++i){
+            if(cameras[i].history.empty())
+                continue;
+
+            newest[i] = getTime(cameras[i].history.back());
+            newestOverall = std::max(newestOverall, newest[i]);
+        }
+
+        // Late cameras are excluded from the reference time:
+        std::vector<bool> late(latest.size(), false);
+        double referenceTime = 1e300;
+        bool anyLate = false;
+        for(size_t i = 0; i < latest.size(); ++i){
+            if(cameras[i].history.empty())
+                continue;
+
+            late[i] = (newestOverall - newest[i]) * 1000.0 > maxWaitMs;
+            anyLate |= late[i];
+            if(!late[i])
+                referenceTime = std::min(referenceTime, newest[i]);
+        }
+
+        if(anyLate && fallbackPolicy == FALLBACK_LATEST){
+            addStatistics(latest, newestOverall, true);
+            for(size_t i = 0; i < latest.size(); ++i)
+                cameras[i].lastSelected = latest[i];
+            return latest;
+        }
+
+        std::vector<std::shared_ptr<OrganizedPointCloud>> group(latest.size(), nullptr);
+        bool anyFallback = anyLate;
+        for(size_t i = 0; i < latest.size(); ++i){
+            if(cameras[i].history.empty())
+                continue;
+
+            if(late[i]){
+                if(fallbackPolicy == FALLBACK_HOLD_PREVIOUS){
+                    // Nothing held yet (e.g. after a reset), so start with the newest frame:
+                    group[i] = cameras[i].lastSelected ? cameras[i].lastSelected : cameras[i].history.back();
+                    cameras[i].lastSelected = group[i];
+                }
+                continue;
+            }
+
+            bool withinTolerance;
+            std::shared_ptr<OrganizedPointCloud> frame = closestFrame(cameras[i], referenceTime, withinTolerance);
+
+            // No synchronous frame of this camera:
+            if(!withinTolerance){
+                anyFallback = true;
+                if(fallbackPolicy == FALLBACK_DROP)
+                    continue;
+                if(fallbackPolicy == FALLBACK_HOLD_PREVIOUS && cameras[i].lastSelected)
+                    frame = cameras[i].lastSelected;
+            }
+
+            group[i] = frame;
+            cameras[i].lastSelected = group[i];
+        }
+
+        addStatistics(group, referenceTime, anyFallback);
+        return group;
+    }
+
+    /** Forgets the frames of the camera (e.g. when its device was disconnected) */
+    void reset(size_t camera){
+        if(camera >= cameras.size())
+            return;
+
+        cameras[camera] = CameraState();
+        if(camera < lastGroup.size())
+            lastGroup[camera] = nullptr;
+    }
+
+    Statistics getStatistics() const {
+        Statistics statistics;
+        statistics.groups = groups;
+        statistics.groupsWithinTolerance = groupsWithinTolerance;
+        statistics.fallbacks = fallbacks;
+
+        if(!skews.empty()){
+            std::vector<float> sorted(skews.begin(), skews.end());
+            std::sort(sorted.begin(), sorted.end());
+            statistics.skewP50 = sorted[sorted.size() / 2];
+            statistics.skewP95 = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+            statistics.skewMax = sorted.back();
+        }
+
+        for(const CameraState& camera : cameras){
+            float sum = 0.f;
+            for(float offset : camera.offsets)
+                sum += offset;
+            statistics.meanOffset.push_back(camera.offsets.empty() ? 0.f : sum / camera.offsets.size());
+        }
+        return statistics;
+    }
+
+    void resetStatistics(){
+        skews.clear();
+        for(CameraState& camera : cameras)
+            camera.offsets.clear();
+        groups = groupsWithinTolerance = fallbacks = 0;
+    }
+};
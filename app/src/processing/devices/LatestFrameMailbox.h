@@ -0,0 +1,70 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Lock-free single-producer / single-consumer mailbox which always holds the
+ * latest frame (triple buffer).
+ *
+ * The producer (camera thread) writes into its back slot and swaps it with the
+ * middle slot, the consumer (render thread) swaps its front slot with the
+ * middle slot if there is something new. Neither side ever waits for the
+ * other one. Frames which are replaced before the consumer took them are
+ * counted as overwritten.
+ */
+template<typename T>
+class LatestFrameMailbox {
+    /** Flag in middleSlot, set if the middle slot was not consumed yet */
+    static constexpr uint8_t NEW_DATA = 4;
+
+    std::shared_ptr<T> slots[3];
+
+    /** Index of the middle slot (| NEW_DATA) */
+    std::atomic<uint8_t> middleSlot = 1;
+
+    /** Only accessed by the producer */
+    uint8_t backSlot = 0;
+
+    /** Only accessed by the consumer */
+    uint8_t frontSlot = 2;
+
+    std::atomic<uint64_t> publishedFrames = 0;
+    std::atomic<uint64_t> overwrittenFrames = 0;
+
+public:
+    /** Producer: Makes the given frame the latest one. */
+    void publish(std::shared_ptr<T> frame){
+        slots[backSlot] = std::move(frame);
+
+        uint8_t previousMiddle = middleSlot.exchange(backSlot | NEW_DATA, std::memory_order_acq_rel);
+        if(previousMiddle & NEW_DATA)
+            overwrittenFrames.fetch_add(1, std::memory_order_relaxed);
+
+        backSlot = previousMiddle & 3;
+        publishedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Consumer: Returns the latest frame (or the previously returned one, if
+     * there is no newer one).
+     */
+    std::shared_ptr<T> latest(){
+        if(middleSlot.load(std::memory_order_relaxed) & NEW_DATA){
+            uint8_t previousMiddle = middleSlot.exchange(frontSlot, std::memory_order_acq_rel);
+            frontSlot = previousMiddle & 3;
+        }
+        return slots[frontSlot];
+    }
+
+    uint64_t getPublishedFrameCount() const {
+        return publishedFrames.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getOverwrittenFrameCount() const {
+        return overwrittenFrames.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,173 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "src/MemoryMappedFile.h"
+
+/**
+ * File format of cached lookup tables (*.lut), little endian:
+ *
+ *   LookupTableCacheHeader
+ *   float lookupImageTo3D[height][width][2]
+ *   float lookup3DToImage[lookup3DToImageSize][lookup3DToImageSize][2]
+ *
+ * The tables only depend on the calibration of the camera and the stream
+ * profile, so they are computed once per camera and mapped from disk on the
+ * next start.
+ */
+
+#define LOOKUP_TABLE_CACHE_MAGIC "DPLUT001"
+#define LOOKUP_TABLE_CACHE_VERSION 1
+
+struct LookupTableCacheHeader {
+    char magic[8];
+    uint32_t version = LOOKUP_TABLE_CACHE_VERSION;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t lookup3DToImageSize = 0;
+    uint64_t calibrationHash = 0;
+    char serial[64] = {};
+    char profile[64] = {};
+};
+
+static_assert(sizeof(LookupTableCacheHeader) % 16 == 0, "Unexpected padding in LookupTableCacheHeader");
+
+/**
+ * Stores the lookup tables of a camera in lookupCache/, keyed by serial,
+ * stream profile and a hash of the calibration (which changes e.g. after a
+ * recalibration or a firmware update), and memory-maps them again.
+ */
+class LookupTableCache {
+public:
+    struct Key {
+        std::string serial;
+
+        /** Stream profile the tables were created for, e.g. "depth640x576_color1280x720" */
+        std::string profile;
+
+        uint64_t calibrationHash = 0;
+
+        std::string getFilename() const {
+            char hash[17];
+            std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) calibrationHash);
+            return directory + "/" + serial + "_" + profile + "_" + hash + ".lut";
+        }
+    };
+
+    /** Tables mapped from the cache file (valid as long as the entry exists) */
+    class Entry {
+        MemoryMappedFile file;
+
+        friend class LookupTableCache;
+
+    public:
+        int width = 0;
+        int height = 0;
+        int lookup3DToImageSize = 0;
+
+        const float* lookupImageTo3D = nullptr;
+        const float* lookup3DToImage = nullptr;
+    };
+
+    static inline std::string directory = "lookupCache";
+
+    /** FNV-1a hash, can be chained over several calibration structs */
+    static uint64_t hash(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull){
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; ++i){
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /** Maps the cached tables, returns nullptr if there is no (valid) cache file for the key */
+    static std::shared_ptr<Entry> load(const Key& key, int width, int height, int lookup3DToImageSize){
+        std::string filename = key.getFilename();
+        if(!std::filesystem::exists(filename))
+            return nullptr;
+
+        std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+        if(!entry->file.open(filename))
+            return nullptr;
+
+        size_t imageTo3DFloats = size_t(width) * height * 2;
+        size_t toImageFloats = size_t(lookup3DToImageSize) * lookup3DToImageSize * 2;
+        size_t expectedSize = sizeof(LookupTableCacheHeader) + (imageTo3DFloats + toImageFloats) * sizeof(float);
+
+        const LookupTableCacheHeader* header = reinterpret_cast<const LookupTableCacheHeader*>(entry->file.data());
+        if(entry->file.size() != expectedSize
+            || std::memcmp(header->magic, LOOKUP_TABLE_CACHE_MAGIC, 8) != 0
+            || header->version != LOOKUP_TABLE_CACHE_VERSION
+            || header->width != uint32_t(width) || header->height != uint32_t(height)
+            || header->lookup3DToImageSize != uint32_t(lookup3DToImageSize)
+            || header->calibrationHash != key.calibrationHash){
+            std::cerr << "Ignoring invalid lookup cache file " << filename << std::endl;
+            return nullptr;
+        }
+
+        const float* tables = reinterpret_cast<const float*>(entry->file.data() + sizeof(LookupTableCacheHeader));
+        entry->width = width;
+        entry->height = height;
+        entry->lookup3DToImageSize = lookup3DToImageSize;
+        entry->lookupImageTo3D = tables;
+        entry->lookup3DToImage = tables + imageTo3DFloats;
+        return entry;
+    }
+
+    /**
+     * Writes the tables to the cache. The file is written under a temporary
+     * name and renamed, so that a concurrent load never sees a partial file.
+     */
+    static bool store(const Key& key, int width, int height, const float* lookupImageTo3D, int lookup3DToImageSize, const float* lookup3DToImage){
+        std::string filename = key.getFilename();
+        std::string temporaryFilename = filename + ".tmp";
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        LookupTableCacheHeader header;
+        std::memcpy(header.magic, LOOKUP_TABLE_CACHE_MAGIC, 8);
+        header.width = uint32_t(width);
+        header.height = uint32_t(height);
+        header.lookup3DToImageSize = uint32_t(lookup3DToImageSize);
+        header.calibrationHash = key.calibrationHash;
+        std::strncpy(header.serial, key.serial.c_str(), sizeof(header.serial) - 1);
+        std::strncpy(header.profile, key.profile.c_str(), sizeof(header.profile) - 1);
+
+        {
+            std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+            if(!file){
+                std::cerr << "Could not write lookup cache file " << temporaryFilename << std::endl;
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(lookupImageTo3D), std::streamsize(size_t(width) * height * 2 * sizeof(float)));
+            file.write(reinterpret_cast<const char*>(lookup3DToImage), std::streamsize(size_t(lookup3DToImageSize) * lookup3DToImageSize * 2 * sizeof(float)));
+            if(!file){
+                std::cerr << "Could not write lookup cache file " << temporaryFilename << std::endl;
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporaryFilename, filename, error);
+        if(error){
+            std::cerr << "Could not write lookup cache file " << filename << ": " << error.message() << std::endl;
+            std::filesystem::remove(temporaryFilename, error);
+            return false;
+        }
+
+        std::cout << "Stored lookup tables in " << filename << std::endl;
+        return true;
+    }
+};
@@ -4,14 +4,17 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include "src/processing/OrganizedPointCloud.h"
 
+/** Maximum number of devices (device indices) the manager accepts point clouds from */
+#define MAX_RGBD_DEVICES 8
 
 /**
  * Represents a single camera, which notifies the Camera Manager when there are
  * new point clouds.
  */
-class RGBDCamera {
+class RGBDCamera : public std::enable_shared_from_this<RGBDCamera> {
 protected:
     /** Callback function */
     std::function<std::shared_ptr<OrganizedPointCloud>()> callbackFunction;
@@ -29,10 +32,18 @@ public:
     /** Deactivates the camera thread (and the light / light projector) */
     virtual bool disableIRLight() = 0;
 
+    /** Stops delivering point clouds (e.g. on shutdown) */
+    virtual void stop(){
+        disableIRLight();
+    }
+
     virtual std::string type() = 0;
 
     virtual std::string getSerial() = 0;
 
+    /** Returns the pool the per-frame arrays are acquired from (if any) */
+    virtual std::shared_ptr<FramePool> getFramePool(){ return nullptr; }
+
     Mat4f transformation;
 
     // Just for virtual sensors:
@@ -40,4 +51,6 @@ public:
 
     // To detect whether rgb sensors should be simulated in main thread:
     virtual bool requiresSimulatedRGBDData(){ return false; }
+
+    virtual ~RGBDCamera() = default;
 };
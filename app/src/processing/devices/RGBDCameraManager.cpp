@@ -2,10 +2,262 @@
 
 #include "src/simulation/scene/components/Projector.h"
 #include "src/processing/devices/RGBDCameraManager.h"
+#include "src/processing/devices/FramePreprocessor.h"
 #include "src/Data.h"
 
 #include <GLFW/glfw3.h>
 
+RGBDCameraManager::RGBDCameraManager() {
+    sharedMemoryRingDevices.fill(-1);
+
+    // Created before the cameras, so that it is destroyed after them (static destruction order):
+    FramePreprocessor::getInstance();
+
+    std::cout << "Searching for Orbbec Camera Devices..." << std::endl;
+    std::shared_ptr<ob::DeviceList> devList = OrbbecCameraProvider::getContext()->queryDeviceList();
+    for (uint32_t i = 0; i < devList->getCount(); ++i) {
+        connectOrbbecCamera(devList, i);
+    }
+    std::cout << "Started " << cameras.size() << " cameras." << std::endl;
+
+    // If no camera is connected, put virtual ones into the world:
+    if (cameras.size() == 0) {
+        simulationMode = true;
+    }
+
+    deviceEventThread = std::thread(&RGBDCameraManager::processDeviceEvents, this);
+
+    // Only queue the event here, the SDK thread must not be blocked by opening the devices:
+    OrbbecCameraProvider().setDeviceChangedCallback([this](std::shared_ptr<ob::DeviceList> removed, std::shared_ptr<ob::DeviceList> added) {
+        std::unique_lock lock(deviceEventMutex);
+        deviceEvents.push_back({removed, added});
+        deviceEventCondition.notify_one();
+    });
+}
+
+RGBDCameraManager::~RGBDCameraManager() {
+    OrbbecCameraProvider().setDeviceChangedCallback([](std::shared_ptr<ob::DeviceList>, std::shared_ptr<ob::DeviceList>) {});
+
+    {
+        std::unique_lock lock(deviceEventMutex);
+        stopDeviceEvents = true;
+        deviceEventCondition.notify_one();
+    }
+    deviceEventThread.join();
+}
+
+int RGBDCameraManager::assignDeviceIndex(const std::string& serial) {
+    std::map<std::string, int>::iterator previous = serialDeviceIndices.find(serial);
+    if (previous != serialDeviceIndices.end() && deviceSerials[previous->second].empty()) {
+        return previous->second;
+    }
+
+    // Prefer indices which no other (currently disconnected) device had before:
+    for (int deviceIndex = 0; deviceIndex < MAX_RGBD_DEVICES; ++deviceIndex) {
+        bool reserved = false;
+        for (const auto& [otherSerial, otherIndex] : serialDeviceIndices) {
+            reserved |= otherIndex == deviceIndex;
+        }
+
+        if (deviceSerials[deviceIndex].empty() && !reserved) {
+            return deviceIndex;
+        }
+    }
+
+    for (int deviceIndex = 0; deviceIndex < MAX_RGBD_DEVICES; ++deviceIndex) {
+        if (deviceSerials[deviceIndex].empty()) {
+            return deviceIndex;
+        }
+    }
+    return -1;
+}
+
+int RGBDCameraManager::reserveDeviceIndex(const std::string& serial) {
+    std::unique_lock lock(camerasMutex);
+    if (std::find(deviceSerials.begin(), deviceSerials.end(), serial) != deviceSerials.end()) {
+        return -1;
+    }
+
+    int deviceIndex = assignDeviceIndex(serial);
+    if (deviceIndex < 0) {
+        std::cerr << "No free device index for " << serial << " (max. " << MAX_RGBD_DEVICES << " devices)." << std::endl;
+        return -1;
+    }
+
+    deviceSerials[deviceIndex] = serial;
+    return deviceIndex;
+}
+
+void RGBDCameraManager::addCamera(std::shared_ptr<RGBDCamera> camera, const std::string& serial, int deviceIndex) {
+    {
+        std::unique_lock lock(camerasMutex);
+        std::map<std::string, Mat4f>::iterator known = knownTransformations.find(serial);
+        if (known != knownTransformations.end()) {
+            camera->transformation = known->second;
+        }
+
+        serialDeviceIndices[serial] = deviceIndex;
+        cameras.push_back(camera);
+        deviceStatus = "Connected " + serial + " as device " + std::to_string(deviceIndex);
+    }
+
+    // The virtual cameras don't deliver anymore, so ignore their indices until a real device uses them:
+    if (simulationMode.exchange(false)) {
+        std::cout << "Leaving simulation mode." << std::endl;
+
+        std::unique_lock lock(camerasMutex);
+        for (int i = 0; i < MAX_RGBD_DEVICES; ++i) {
+            if (deviceSerials[i].empty() || i == deviceIndex) {
+                deviceRemoved[i] = true;
+            }
+        }
+    }
+
+    camera->start();
+}
+
+bool RGBDCameraManager::connectOrbbecCamera(std::shared_ptr<ob::DeviceList> devList, uint32_t listIndex) {
+    std::string serial;
+    int deviceIndex = -1;
+    std::shared_ptr<OrbbecCamera> camera;
+
+    try {
+        serial = devList->getSerialNumber(listIndex);
+        deviceIndex = reserveDeviceIndex(serial);
+        if (deviceIndex < 0) {
+            return false;
+        }
+
+        camera = OrbbecCameraProvider().createCamera(devList, listIndex, deviceIndex, [this](int id, std::shared_ptr<OrganizedPointCloud> cloud) {
+            pointCloudCallback(id, cloud);
+        });
+    } catch (const ob::Error& e) {
+        std::cerr << "[Orbbec] Could not open device " << serial << ": " << e.what() << std::endl;
+
+        std::unique_lock lock(camerasMutex);
+        if (deviceIndex >= 0) {
+            deviceSerials[deviceIndex].clear();
+        }
+        return false;
+    }
+
+    addCamera(camera, serial, deviceIndex);
+    return true;
+}
+
+void RGBDCameraManager::connectSharedMemoryCameras() {
+    std::unique_lock lock(sharedMemoryMutex);
+    for (int ringIndex = 0; ringIndex < MAX_RGBD_DEVICES; ++ringIndex) {
+        if (sharedMemoryRingDevices[ringIndex] >= 0) {
+            continue;
+        }
+
+        std::string ringName = sharedMemoryRingName(ringIndex);
+        std::shared_ptr<SharedMemoryRingReader> ring = SharedMemoryRingReader::open(ringName);
+        if (ring == nullptr) {
+            continue;
+        }
+
+        // The serial of the daemon's camera, so that its transformation from the config is used:
+        std::string serial = ring->getSerial();
+        int deviceIndex = reserveDeviceIndex(serial);
+        if (deviceIndex < 0) {
+            continue;
+        }
+
+        std::cout << "[SharedMemory] Receive " << serial << " from " << ringName << " as device " << deviceIndex << std::endl;
+        sharedMemoryRingDevices[ringIndex] = deviceIndex;
+        addCamera(std::make_shared<SharedMemoryCamera>(ring, ringName, deviceIndex, [this](int id, std::shared_ptr<OrganizedPointCloud> cloud) {
+            pointCloudCallback(id, cloud);
+        }), serial, deviceIndex);
+    }
+}
+
+bool RGBDCameraManager::disconnectOrbbecCamera(const std::string& serial) {
+    std::shared_ptr<RGBDCamera> camera;
+    int deviceIndex = -1;
+    {
+        std::unique_lock lock(camerasMutex);
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            if (cameras[i]->type() == "Orbbec_Femto" && cameras[i]->getSerial() == serial) {
+                camera = cameras[i];
+                cameras.erase(cameras.begin() + i);
+                break;
+            }
+        }
+
+        std::array<std::string, MAX_RGBD_DEVICES>::iterator owner = std::find(deviceSerials.begin(), deviceSerials.end(), serial);
+        if (owner != deviceSerials.end()) {
+            deviceIndex = int(owner - deviceSerials.begin());
+        }
+
+        if (camera == nullptr || deviceIndex < 0) {
+            return false;
+        }
+
+        // Restored when the device comes back:
+        knownTransformations.insert_or_assign(serial, camera->transformation);
+    }
+
+    std::cout << "[Orbbec] Device " << serial << " (device " << deviceIndex << ") disconnected." << std::endl;
+
+    // Stop the stream first, so that no point cloud of it arrives after the index was marked as removed:
+    try {
+        camera->disableIRLight();
+    } catch (const ob::Error& e) {
+        std::cerr << "[Orbbec] Stopping " << serial << " failed: " << e.what() << std::endl;
+    }
+    deviceRemoved[deviceIndex] = true;
+
+    // The camera is destroyed with its last point cloud (queued in the recorder, the
+    // frame synchronizer, ...), which keeps it alive through cameraOwner:
+    camera.reset();
+
+    std::unique_lock lock(camerasMutex);
+    deviceSerials[deviceIndex].clear();
+    deviceStatus = "Disconnected " + serial + " (device " + std::to_string(deviceIndex) + ")";
+    return true;
+}
+
+void RGBDCameraManager::processDeviceEvents() {
+    std::unique_lock lock(deviceEventMutex);
+    while (true) {
+        // Rings of the capture daemon have no arrival events, so look for new ones every second:
+        deviceEventCondition.wait_for(lock, std::chrono::seconds(1), [this]() { return stopDeviceEvents || !deviceEvents.empty(); });
+        if (stopDeviceEvents) {
+            return;
+        }
+
+        if (deviceEvents.empty()) {
+            if (sharedMemoryMode) {
+                lock.unlock();
+                connectSharedMemoryCameras();
+                lock.lock();
+            }
+            continue;
+        }
+
+        DeviceEvent event = deviceEvents.front();
+        deviceEvents.pop_front();
+        lock.unlock();
+
+        // Removals first, so that a device which is reconnected in the same event gets its index back:
+        for (uint32_t i = 0; event.removed != nullptr && i < event.removed->getCount(); ++i) {
+            try {
+                disconnectOrbbecCamera(event.removed->getSerialNumber(i));
+            } catch (const ob::Error& e) {
+                std::cerr << "[Orbbec] Removed device without serial: " << e.what() << std::endl;
+            }
+        }
+
+        for (uint32_t i = 0; event.added != nullptr && i < event.added->getCount(); ++i) {
+            connectOrbbecCamera(event.added, i);
+        }
+
+        lock.lock();
+    }
+}
+
 void RGBDCameraManager::save(const std::string filename) {
     nlohmann::json j;
     nlohmann::json projectorsJson;
@@ -18,12 +270,22 @@ void RGBDCameraManager::save(const std::string filename) {
     j["projectors"] = projectorsJson;
 
     nlohmann::json depthSensorsJson;
-    for (const auto& camera : cameras) {
-        nlohmann::json camJson;
+    {
+        std::unique_lock lock(camerasMutex);
 
-        camJson["transformation"] = camera->transformation.data;
-        camJson["serial"] = camera->getSerial();
-        depthSensorsJson.push_back(camJson);
+        // Disconnected devices keep their transformation:
+        std::map<std::string, Mat4f> transformations = knownTransformations;
+        for (const auto& camera : cameras) {
+            transformations.insert_or_assign(camera->getSerial(), camera->transformation);
+        }
+
+        for (const auto& [serial, transformation] : transformations) {
+            nlohmann::json camJson;
+
+            camJson["transformation"] = transformation.data;
+            camJson["serial"] = serial;
+            depthSensorsJson.push_back(camJson);
+        }
     }
     j["depthSensors"] = depthSensorsJson;
 
@@ -61,12 +323,15 @@ void RGBDCameraManager::load(const std::string filename) {
     }
 
     if (j.contains("depthSensors")) {
-        std::map<std::string, Mat4f> sensorMap;
+        std::unique_lock lock(camerasMutex);
+
+        // Also applied to devices which are connected later on:
+        std::map<std::string, Mat4f>& sensorMap = knownTransformations;
 
         for (const auto& entry : j["depthSensors"]) {
             std::string serial = entry["serial"];
             std::vector<float> vec = entry["transformation"].get<std::vector<float>>();
-            sensorMap.emplace(serial, Mat4f(vec));
+            sensorMap.insert_or_assign(serial, Mat4f(vec));
         }
 
         for(auto& camera : cameras){
@@ -3,79 +3,338 @@
 
 #pragma once
 
+#include<array>
+#include<condition_variable>
+#include<deque>
+#include<map>
+#include<mutex>
+#include<thread>
 #include<vector>
 
 #include "src/processing/devices/orbbec/OrbbecCameraProvider.h"
 
 #include "src/processing/devices/RGBDCamera.h"
+#include "src/processing/devices/LatestFrameMailbox.h"
+#include "src/processing/devices/FrameSynchronizer.h"
+#include "src/processing/devices/recording/RecordedCamera.h"
+#include "src/processing/devices/recording/RGBDSessionRecorder.h"
+#include "src/processing/devices/sharedmemory/SharedMemoryCamera.h"
 #include "src/processing/OrganizedPointCloud.h"
+#include "src/processing/DepthBinning.h"
 
 #include <nlohmann/json.hpp>
 
 class RGBDCameraManager {
-    /** Same order as cameras */
-    std::mutex pointCloudsMutex;
+    /**
+     * Latest point cloud per device index. Written by the camera threads,
+     * read by the OpenGL thread.
+     */
+    std::array<LatestFrameMailbox<OrganizedPointCloud>, MAX_RGBD_DEVICES> mailboxes;
+
+    /** Highest device index that delivered a point cloud + 1 */
+    std::atomic<int> deviceCount = 0;
 
-    std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
     std::vector<std::shared_ptr<RGBDCamera>> cameras;
 
-    std::vector<std::function<void(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud)>> pointCloudCallbacks;
+    /** Guards cameras, the device index assignment, the known transformations and the device status */
+    std::mutex camerasMutex;
+
+    /** Serial of the camera which owns each device index (empty if the index is free) */
+    std::array<std::string, MAX_RGBD_DEVICES> deviceSerials;
+
+    /** Device index each serial had, so that a reconnected device gets its index back */
+    std::map<std::string, int> serialDeviceIndices;
+
+    /** Transformations from the config and of disconnected devices by serial */
+    std::map<std::string, Mat4f> knownTransformations;
+
+    /** Last device arrival / removal (shown in the GUI) */
+    std::string deviceStatus;
+
+    /**
+     * Set when the device of an index was disconnected, until the index delivers
+     * a point cloud again. Meanwhile the OpenGL thread ignores the mailbox and
+     * CameraPasses releases the resources of the index.
+     */
+    std::array<std::atomic<bool>, MAX_RGBD_DEVICES> deviceRemoved = {};
+
+    /** Removals the frame synchronizer was already reset for (OpenGL thread only) */
+    std::array<bool, MAX_RGBD_DEVICES> synchronizerReset = {};
+
+    struct DeviceEvent {
+        std::shared_ptr<ob::DeviceList> removed;
+        std::shared_ptr<ob::DeviceList> added;
+    };
+
+    // Device arrivals / removals are reported by the Orbbec SDK and handled in deviceEventThread,
+    // since opening and closing devices takes long (never blocks the render loop or the SDK):
+    std::deque<DeviceEvent> deviceEvents;
+    std::mutex deviceEventMutex;
+    std::condition_variable deviceEventCondition;
+    bool stopDeviceEvents = false;
+    std::thread deviceEventThread;
+
+    /** Receive from the rings of the capture daemon (rings which appear later are connected by deviceEventThread) */
+    std::atomic<bool> sharedMemoryMode = false;
+
+    /** Device index per ring of the capture daemon which is already connected (-1 if not) */
+    std::array<int, MAX_RGBD_DEVICES> sharedMemoryRingDevices;
+    std::mutex sharedMemoryMutex;
+
+    typedef std::function<void(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud)> PointCloudCallback;
+
+    /** Replaced as a whole (accessed atomically, since the camera threads iterate over it) */
+    std::shared_ptr<const std::vector<PointCloudCallback>> pointCloudCallbacks = std::make_shared<std::vector<PointCloudCallback>>();
+
+    // When no real camera is found, switch to simulation mode (left as soon as a device is connected):
+    std::atomic<bool> simulationMode = false;
+
+    /** Returns a free device index for the serial (camerasMutex must be locked), -1 if there is none */
+    int assignDeviceIndex(const std::string& serial);
+
+    /** Assigns a device index to the serial, -1 if it is already connected or there is no free index */
+    int reserveDeviceIndex(const std::string& serial);
+
+    /** Restores the transformation of the camera, adds and starts it at its reserved device index */
+    void addCamera(std::shared_ptr<RGBDCamera> camera, const std::string& serial, int deviceIndex);
+
+    /** Opens and starts the device at listIndex of the list, unless it is already connected */
+    bool connectOrbbecCamera(std::shared_ptr<ob::DeviceList> devList, uint32_t listIndex);
+
+    /** Adds a SharedMemoryCamera for each ring of the capture daemon which is not connected yet */
+    void connectSharedMemoryCameras();
 
-    // When no real camera is found, switch to simulation mode:
-    bool simulationMode = false;
+    /** Stops and removes the camera with the serial; its device index is marked as removed */
+    bool disconnectOrbbecCamera(const std::string& serial);
+
+    void processDeviceEvents();
+
+    /** Ingest binning per device (DepthBinningMode), set from the GUI */
+    std::array<std::atomic<int>, MAX_RGBD_DEVICES> depthBinningModes = {};
+
+    /** Decimated lookup tables per device (only used while binning is enabled) */
+    std::array<DepthBinning, MAX_RGBD_DEVICES> depthBinnings;
+
+    /** Active session recording (accessed atomically, since camera threads forward to it) */
+    std::shared_ptr<RGBDSessionRecorder> recorder;
 
 public:
+    /** Groups the latest point clouds by timestamp (used by getSynchronizedPointClouds) */
+    FrameSynchronizer frameSynchronizer;
+
+    /**
+     * Returns the latest point cloud of each device (nullptr for devices without
+     * one). Must only be called from the OpenGL thread.
+     */
     std::vector<std::shared_ptr<OrganizedPointCloud>> getCurrentPointClouds(){
-        std::unique_lock l(pointCloudsMutex);
-        std::vector<std::shared_ptr<OrganizedPointCloud>> copy = pointClouds;
-        return copy;
-    }
-
-    /** */
-    RGBDCameraManager(){
-        std::cout << "Searching for Orbbec Camera Devices..." << std::endl;
-        OrbbecCameraProvider orbbecProvider;
-        std::vector<std::shared_ptr<OrbbecCamera>> orbbecCameras = orbbecProvider.getCameras(0, [this](int id, std::shared_ptr<OrganizedPointCloud> cloud) {
-            pointCloudCallback(id, cloud);
-        });
-        for(std::shared_ptr<OrbbecCamera>& orbbecCam : orbbecCameras){
-            cameras.push_back(orbbecCam);
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds(deviceCount.load());
+        for(int i = 0; i < int(pointClouds.size()); ++i){
+            if(!deviceRemoved[i].load())
+                pointClouds[i] = mailboxes[i].latest();
         }
-        std::cout << "    Found " << orbbecCameras.size() << " Cameras." << std::endl << std::endl;
 
-        std::cout << "Start Cameras... " << std::endl;
-        for(std::shared_ptr<RGBDCamera>& cam : cameras){
-            cam->start();
-        }
-        std::cout << "Started " << cameras.size() << " cameras." << std::endl;
+        return pointClouds;
+    }
 
-        // If no camera is connected, put virtual ones into the world:
-        if(cameras.size() == 0){
-            simulationMode = true;
+    /**
+     * Returns a timestamp-synchronized frameset (one point cloud or nullptr per
+     * device). Must only be called from the OpenGL thread.
+     */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> getSynchronizedPointClouds(){
+        // Forget the frames of disconnected devices, so that they are not held by the synchronizer:
+        for(int i = 0; i < MAX_RGBD_DEVICES; ++i){
+            bool removed = deviceRemoved[i].load();
+            if(removed && !synchronizerReset[i])
+                frameSynchronizer.reset(i);
+            synchronizerReset[i] = removed;
         }
+
+        return frameSynchronizer.synchronize(getCurrentPointClouds());
+    }
+
+    /** True if the device of the index was disconnected (and did not deliver since) */
+    bool isDeviceRemoved(int deviceIndex){
+        return deviceIndex >= 0 && deviceIndex < MAX_RGBD_DEVICES && deviceRemoved[deviceIndex].load();
+    }
+
+    /** Describes the last device arrival or removal (empty if there was none) */
+    std::string getDeviceStatus(){
+        std::unique_lock lock(camerasMutex);
+        return deviceStatus;
+    }
+
+    DepthBinningMode getDepthBinningMode(int deviceIndex){
+        return DepthBinningMode(depthBinningModes[deviceIndex].load());
+    }
+
+    /** Bins the depth of the device 2x2 from its next point cloud on (see DepthBinning) */
+    void setDepthBinningMode(int deviceIndex, DepthBinningMode mode){
+        depthBinningModes[deviceIndex] = int(mode);
+    }
+
+    /** Number of point clouds of the device which were replaced before they were used */
+    uint64_t getOverwrittenFrameCount(int deviceIndex){
+        return mailboxes[deviceIndex].getOverwrittenFrameCount();
+    }
+
+    /** Number of point clouds the device delivered */
+    uint64_t getPublishedFrameCount(int deviceIndex){
+        return mailboxes[deviceIndex].getPublishedFrameCount();
+    }
+
+    int getDeviceCount(){
+        return deviceCount.load();
     }
 
-    void pointCloudCallback(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud){
-        for(std::function<void(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud)>& callback : pointCloudCallbacks){
+    /**
+     * Connects all Orbbec devices and listens for devices which are connected
+     * or disconnected later on.
+     */
+    RGBDCameraManager();
+
+    ~RGBDCameraManager();
+
+    /**
+     * Forwards the point cloud of the device to the recorder, the callbacks and
+     * the mailbox. Only point clouds of live devices (fromDevice) bring back an
+     * index which was marked as removed.
+     */
+    void pointCloudCallback(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud, bool fromDevice = true){
+        // Sources without an own arrival stamp (e.g. virtual cameras) start here:
+        if(pointCloud){
+            pointCloud->trace.stamp(LATENCY_SDK_ARRIVAL);
+            pointCloud->trace.stamp(LATENCY_CALLBACK_DONE);
+        }
+
+        if(std::shared_ptr<RGBDSessionRecorder> activeRecorder = std::atomic_load(&recorder))
+            activeRecorder->addPointCloud(deviceIndex, pointCloud);
+
+        // Recordings keep the full resolution, everything after the ingest gets the binned data:
+        if(deviceIndex >= 0 && deviceIndex < MAX_RGBD_DEVICES)
+            pointCloud = depthBinnings[deviceIndex].bin(pointCloud, DepthBinningMode(depthBinningModes[deviceIndex].load()));
+
+        std::shared_ptr<const std::vector<PointCloudCallback>> callbacks = std::atomic_load(&pointCloudCallbacks);
+        for(const PointCloudCallback& callback : *callbacks){
             if(callback)
                 callback(deviceIndex, pointCloud);
         }
 
-        std::unique_lock l(pointCloudsMutex);
-        while(pointClouds.size() <= deviceIndex)
-            pointClouds.push_back(nullptr);
+        if(deviceIndex < 0 || deviceIndex >= MAX_RGBD_DEVICES){
+            std::cerr << "Ignoring point cloud of device " << deviceIndex << " (max. " << MAX_RGBD_DEVICES << " devices)." << std::endl;
+            return;
+        }
 
-        pointClouds[deviceIndex] = pointCloud;
+        mailboxes[deviceIndex].publish(pointCloud);
+
+        // A virtual frame still in flight when the simulation mode was left must not revive its index:
+        if(fromDevice)
+            deviceRemoved[deviceIndex] = false;
+
+        int count = deviceCount.load();
+        while(count <= deviceIndex && !deviceCount.compare_exchange_weak(count, deviceIndex + 1));
+    }
+
+    /** Like pointCloudCallback, but drops the point cloud once the simulation mode was left */
+    void simulatedPointCloudCallback(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud){
+        if(simulationMode)
+            pointCloudCallback(deviceIndex, pointCloud, false);
     }
 
     void registerCallback(std::function<void(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pointCloud)> pointCloudCallback){
-        pointCloudCallbacks.push_back(pointCloudCallback);
+        std::shared_ptr<std::vector<PointCloudCallback>> callbacks = std::make_shared<std::vector<PointCloudCallback>>(*std::atomic_load(&pointCloudCallbacks));
+        callbacks->push_back(pointCloudCallback);
+        std::atomic_store(&pointCloudCallbacks, std::shared_ptr<const std::vector<PointCloudCallback>>(callbacks));
+    }
+
+    /** Returns the connected cameras (copy, since devices may be connected or disconnected at any time) */
+    std::vector<std::shared_ptr<RGBDCamera>> getCameras(){
+        std::unique_lock lock(camerasMutex);
+        return cameras;
     }
 
     bool requiresSimulatedRGBDData(){
         return simulationMode;
     }
 
+    /**
+     * Adds a RecordedCamera for each stream of the given recording (after the
+     * live cameras) and leaves the simulation mode.
+     */
+    bool openRecording(const std::string& filename, RecordedCamera::Pacing pacing = RecordedCamera::PACING_REALTIME, bool loop = true){
+        std::shared_ptr<RGBDRecordingReader> reader = std::make_shared<RGBDRecordingReader>(filename);
+        if(!reader->isOpen() || reader->getStreamCount() == 0){
+            std::cerr << "Could not open recording " << filename << std::endl;
+            return false;
+        }
+
+        std::shared_ptr<RecordedCamera::ReplayClock> replayClock = std::make_shared<RecordedCamera::ReplayClock>();
+
+        std::cout << "Replay " << reader->getStreamCount() << " recorded cameras from " << filename << std::endl;
+        for(int streamIndex = 0; streamIndex < int(reader->getStreamCount()); ++streamIndex){
+            std::unique_lock lock(camerasMutex);
+
+            // The streams take the next free device indices (after the live cameras):
+            int deviceIndex = assignDeviceIndex("Replay" + std::to_string(streamIndex) + ":" + filename);
+            if(deviceIndex < 0){
+                std::cerr << "No free device index for stream " << streamIndex << " of " << filename << std::endl;
+                break;
+            }
+
+            std::shared_ptr<RecordedCamera> camera = std::make_shared<RecordedCamera>(reader, replayClock, streamIndex, deviceIndex, [this](int id, std::shared_ptr<OrganizedPointCloud> cloud) {
+                pointCloudCallback(id, cloud);
+            }, pacing, loop);
+
+            deviceSerials[deviceIndex] = "Replay" + std::to_string(streamIndex) + ":" + filename;
+            cameras.push_back(camera);
+            camera->start();
+        }
+
+        simulationMode = false;
+        return true;
+    }
+
+    /**
+     * Receives the point clouds of the capture daemon (--capture-daemon) through
+     * shared memory and leaves the simulation mode. The daemon may be started
+     * (or restarted) later on.
+     */
+    void openSharedMemory(){
+        std::cout << "Receive point clouds from the capture daemon." << std::endl;
+        sharedMemoryMode = true;
+        simulationMode = false;
+        connectSharedMemoryCameras();
+    }
+
+    /** Stops all cameras (no more point clouds are delivered afterwards). */
+    void stopCameras(){
+        for(std::shared_ptr<RGBDCamera>& camera : getCameras())
+            camera->stop();
+    }
+
+    /** Starts recording all incoming point clouds into the given file. */
+    bool startRecording(const std::string& filename){
+        std::shared_ptr<RGBDSessionRecorder> newRecorder = std::make_shared<RGBDSessionRecorder>(filename);
+        if(!newRecorder->isOpen())
+            return false;
+
+        std::atomic_store(&recorder, newRecorder);
+        std::cout << "Recording to " << filename << std::endl;
+        return true;
+    }
+
+    /** Stops the recording (the file is finalized when the last frame is written). */
+    void stopRecording(){
+        std::shared_ptr<RGBDSessionRecorder> oldRecorder = std::atomic_exchange(&recorder, std::shared_ptr<RGBDSessionRecorder>());
+
+        // Finalizes the file here, camera threads which still forward a frame to it are rejected:
+        if(oldRecorder != nullptr)
+            oldRecorder->stop();
+    }
+
+    std::shared_ptr<RGBDSessionRecorder> getRecorder(){
+        return std::atomic_load(&recorder);
+    }
+
     void save(const std::string filename = "config.json");
     void load(const std::string filename = "config.json");
 
@@ -5,7 +5,13 @@
 #include <libobsensor/ObSensor.hpp>
 #include <libobsensor/h/Utils.h>
 
+#include <cmath>
+#include <future>
+
 #include "src/processing/devices/RGBDCamera.h"
+#include "src/processing/devices/FramePreprocessor.h"
+#include "src/processing/LookupTableGenerator.h"
+#include "src/processing/devices/LookupTableCache.h"
 
 /**
  * A streamer when using a single or multiple Orbbec Camera Devices.
@@ -18,12 +24,33 @@ class OrbbecCamera : public RGBDCamera {
     float* lookup2DTo3D = nullptr;
     float* lookup3DTo2D = nullptr;
 
+    /** Generation of lookup3DTo2D, which runs in the background after the first frame */
+    std::future<float*> lookup3DTo2DFuture;
+
+    /** Tables mapped from the lookup cache (if they were cached by a previous run) */
+    std::shared_ptr<LookupTableCache::Entry> lookupCacheEntry;
+
+    /** Normalized ray per high res color pixel (x, y, z, 0), see OrganizedPointCloud::lookupHighResTo3D */
+    float* lookupHighResTo3D = nullptr;
+
+    /** Generation of lookupHighResTo3D, which runs in the background after the first frame */
+    std::future<float*> lookupHighResTo3DFuture;
+
     std::shared_ptr<ob::Pipeline> pipe;
     std::string cameraSerial = "Orbbec1";
     int deviceIndex;
 
     bool isPipeRunning = false;
 
+    /** Use the global (host synchronized) timestamp of the frames, if supported */
+    bool useGlobalTimestamp = false;
+
+    /** Recycles the per-frame arrays of this camera */
+    std::shared_ptr<FramePool> framePool = std::make_shared<FramePool>();
+
+    /** Maps color to depth pixels (created with the first frame, calibration is static) */
+    std::shared_ptr<ColorToDepthMapper> colorToDepthMapper;
+
     std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback;
 
 public:
@@ -38,9 +65,65 @@ public:
         cameraSerial = pipe->getDevice()->getDeviceInfo()->serialNumber();
     }
 
+    /** Only destroyed after the last point cloud (see OrganizedPointCloud::cameraOwner) */
+    ~OrbbecCamera(){
+        disableIRLight();
+
+        // The generation uses lookup2DTo3D:
+        if(lookup3DTo2D == nullptr && lookup3DTo2DFuture.valid())
+            lookup3DTo2D = lookup3DTo2DFuture.get();
+
+        // Tables of the lookup cache are unmapped with the entry:
+        if(lookupCacheEntry == nullptr){
+            delete[] lookup2DTo3D;
+            delete[] lookup3DTo2D;
+        }
+
+        if(lookupHighResTo3D == nullptr && lookupHighResTo3DFuture.valid())
+            lookupHighResTo3D = lookupHighResTo3DFuture.get();
+        delete[] lookupHighResTo3D;
+    }
+
+    /** Cache key of the lookup tables for the stream profiles and calibration of the frame set */
+    LookupTableCache::Key getLookupCacheKey(std::shared_ptr<ob::FrameSet>& frameSet){
+        auto depthProfile = frameSet->depthFrame()->getStreamProfile()->as<ob::VideoStreamProfile>();
+        auto colorProfile = frameSet->colorFrame()->getStreamProfile()->as<ob::VideoStreamProfile>();
+
+        OBCameraIntrinsic depthIntrinsic = depthProfile->getIntrinsic();
+        OBCameraDistortion depthDistortion = depthProfile->getDistortion();
+        OBCameraIntrinsic colorIntrinsic = colorProfile->getIntrinsic();
+        OBCameraDistortion colorDistortion = colorProfile->getDistortion();
+        OBExtrinsic depthToColor = depthProfile->getExtrinsicTo(colorProfile);
+        int sdkVersion[3] = {ob::Version::getMajor(), ob::Version::getMinor(), ob::Version::getPatch()};
+
+        LookupTableCache::Key key;
+        key.serial = cameraSerial;
+        key.profile = "depth" + std::to_string(depthProfile->getWidth()) + "x" + std::to_string(depthProfile->getHeight())
+                    + "_color" + std::to_string(colorProfile->getWidth()) + "x" + std::to_string(colorProfile->getHeight());
+
+        uint64_t hash = LookupTableCache::hash(&depthIntrinsic, sizeof(depthIntrinsic));
+        hash = LookupTableCache::hash(&depthDistortion, sizeof(depthDistortion), hash);
+        hash = LookupTableCache::hash(&colorIntrinsic, sizeof(colorIntrinsic), hash);
+        hash = LookupTableCache::hash(&colorDistortion, sizeof(colorDistortion), hash);
+        hash = LookupTableCache::hash(&depthToColor, sizeof(depthToColor), hash);
+        key.calibrationHash = LookupTableCache::hash(sdkVersion, sizeof(sdkVersion), hash);
+        return key;
+    }
+
     void ensureLookupsInitialized(std::shared_ptr<ob::FrameSet>& frameSet, int width, int height){
         bool initLookup2DTo3D = false;
         if(lookup2DTo3D == nullptr){
+            LookupTableCache::Key cacheKey = getLookupCacheKey(frameSet);
+            lookupCacheEntry = LookupTableCache::load(cacheKey, width, height, 1024);
+
+            if(lookupCacheEntry != nullptr){
+                // The mapping is read-only, but the tables are never written anyway:
+                lookup2DTo3D = const_cast<float*>(lookupCacheEntry->lookupImageTo3D);
+                lookup3DTo2D = const_cast<float*>(lookupCacheEntry->lookup3DToImage);
+                std::cout << "[Orbbec] Loaded lookup tables of " << cameraSerial << " from " << cacheKey.getFilename() << std::endl;
+                return;
+            }
+
             uint16_t *data   = reinterpret_cast<uint16_t *>(frameSet->depthFrame()->getData());
             for(int i=0; i < width * height; ++i)
                 data[i] = 1000;
@@ -61,67 +144,80 @@ public:
                     lookup2DTo3D[idx*2+1] = ((float*)frame->data())[idx*3+1] / 1000.f;
                 }
             }
-            generate3DTo2D();
-        }
-    }
-
-    void generate3DTo2D() {
-        float* newLookup = new float[1024 * 1024 * 2];
 
-        // Initialisierung mit -1
-        for (int y = 0; y < 1024; ++y) {
-            for (int x = 0; x < 1024; ++x) {
-                int id = y * 1024 + x;
-                newLookup[id * 2] = -1.0f;
-                newLookup[id * 2 + 1] = -1.0f;
-            }
+            // Generating the 3D-to-image table takes some time, so the stream starts without it:
+            LookupTableCache::Key cacheKey = getLookupCacheKey(frameSet);
+            lookup3DTo2DFuture = std::async(std::launch::async, [this, width, height, cacheKey](){
+                LookupTableGenerator::Statistics statistics;
+                float* lookup = LookupTableGenerator::generate3DToImage(lookup2DTo3D, width, height, 1024, &statistics);
+                std::cout << "[Orbbec] Generated 3D-to-image lookup for " << cameraSerial << " (reprojection error: max "
+                          << statistics.maxReprojectionError << " px, mean " << statistics.meanReprojectionError << " px)" << std::endl;
+
+                LookupTableCache::store(cacheKey, width, height, lookup2DTo3D, 1024, lookup);
+                return lookup;
+            });
         }
 
-        for (int y = 0; y < 575; y++) {
-            for (int x = 0; x < 639; x++) {
-                int id = y * 640 + x;
-                float luX00 = lookup2DTo3D[id * 2];
-                float luY00 = lookup2DTo3D[id * 2 + 1];
-
-                int id01 = (y + 1) * 640 + x;
-                float luY01 = lookup2DTo3D[id01 * 2 + 1];
-
-                int id10 = y * 640 + (x + 1);
-                float luX10 = lookup2DTo3D[id10 * 2];
-
-                float fStartX = (luX00 * 0.5f + 0.5f) * 1023.0f;
-                float fEndX   = (luX10 * 0.5f + 0.5f) * 1023.0f;
-                float fStartY = (luY00 * 0.5f + 0.5f) * 1023.0f;
-                float fEndY   = (luY01 * 0.5f + 0.5f) * 1023.0f;
-
-                // Falls vertauscht, Werte tauschen, um Interpolation korrekt zu halten
-                if (fStartX > fEndX) {
-                    std::swap(fStartX, fEndX);
-                    std::swap(luX00, luX10);
-                }
-                if (fStartY > fEndY) {
-                    std::swap(fStartY, fEndY);
-                    std::swap(luY00, luY01);
-                }
-
-                for (int pY = std::max(0, int(fStartY)); pY <= std::min(1023, int(ceil(fEndY))); pY++) {
-                    for (int pX = std::max(0, int(fStartX)); pX <= std::min(1023, int(ceil(fEndX))); pX++) {
-                        float rangeX = fEndX - fStartX;
-                        float rangeY = fEndY - fStartY;
-
-                        float progressX = (rangeX != 0) ? (pX - fStartX) / rangeX : 0.0f;
-                        float progressY = (rangeY != 0) ? (pY - fStartY) / rangeY : 0.0f;
-
-                        int oid = pY * 1024 + pX;
+        if(lookup3DTo2D == nullptr && lookup3DTo2DFuture.valid() && lookup3DTo2DFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            lookup3DTo2D = lookup3DTo2DFuture.get();
+    }
 
-                        // TODO: FOR SOMEWHAT MORE PRECISION, IMPLEMENT ALSO INTERPOLATION BETWEEN ...
-                        newLookup[oid * 2]     = x + progressX;
-                        newLookup[oid * 2 + 1] = y + progressY;
+    /**
+     * Computes the normalized ray of every color pixel once (the color intrinsics
+     * don't change while streaming). This needs one SDK call per pixel, so it runs
+     * in the background and the frames are delivered without the table until then.
+     */
+    void ensureHighResLookupInitialized(std::shared_ptr<ob::StreamProfile> colorProfile, int highResWidth, int highResHeight){
+        if(lookupHighResTo3D != nullptr)
+            return;
+
+        if(!lookupHighResTo3DFuture.valid()){
+            OBCameraIntrinsic colorIntrinsic = colorProfile->as<ob::VideoStreamProfile>()->getIntrinsic();
+            OBD2CTransform transIdentity = colorProfile->getExtrinsicTo(colorProfile);
+
+            lookupHighResTo3DFuture = std::async(std::launch::async, [this, colorIntrinsic, transIdentity, highResWidth, highResHeight](){
+                float* lookup = new float[size_t(highResWidth) * highResHeight * 4];
+                size_t invalidRays = 0;
+
+                for(int y = 0; y < highResHeight; ++y){
+                    for(int x = 0; x < highResWidth; ++x){
+                        OBPoint2f src;
+                        src.x = float(x);
+                        src.y = float(y);
+
+                        OBPoint3f result;
+                        ob_error* error = nullptr;
+                        bool success = ob_transformation_2d_to_3d(src, 1000.f, colorIntrinsic, transIdentity, &result, &error);
+                        if(error != nullptr){
+                            if(invalidRays == 0)
+                                std::cerr << "[Orbbec] High res lookup of " << cameraSerial << ": " << ob_error_get_message(error) << std::endl;
+                            ob_delete_error(error);
+                            success = false;
+                        }
+
+                        // Invalid rays are zero vectors (like pixels without a table, see OrganizedPointCloud::projectHighResIn3D):
+                        Vec4f ray = Vec4f(0.f, 0.f, 0.f, 0.f);
+                        if(success && std::isfinite(result.x) && std::isfinite(result.y) && std::isfinite(result.z) && result.z > 0.f)
+                            ray = Vec4f(result.x, result.y, result.z, 0).normalized();
+                        else
+                            ++invalidRays;
+
+                        float* target = &lookup[(size_t(y) * highResWidth + x) * 4];
+                        target[0] = ray.x;
+                        target[1] = ray.y;
+                        target[2] = ray.z;
+                        target[3] = 0.f;
                     }
                 }
-            }
+
+                if(invalidRays > 0)
+                    std::cerr << "[Orbbec] High res lookup of " << cameraSerial << ": " << invalidRays << " invalid rays" << std::endl;
+                return lookup;
+            });
         }
-        lookup3DTo2D = newLookup;
+
+        if(lookupHighResTo3DFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            lookupHighResTo3D = lookupHighResTo3DFuture.get();
     }
 
     void startStream() {
@@ -134,88 +230,114 @@ public:
         pointCloudFilter->setCreatePointFormat(OB_FORMAT_POINT);
         auto dev = pipe->getDevice();
 
+        try {
+            if(dev->isGlobalTimestampSupported()){
+                dev->enableGlobalTimestamp(true);
+                useGlobalTimestamp = true;
+            }
+        } catch (const ob::Error& e) {
+            std::cerr << "[Orbbec] Global timestamp not available for " << cameraSerial << std::endl;
+        }
+
         isPipeRunning = true;
         pipe->start(config, [this](std::shared_ptr<ob::FrameSet> frameSet) {
-            try {
-                uint32_t width = frameSet->depthFrame()->width();
-                uint32_t height = frameSet->depthFrame()->height();
-
-                ensureLookupsInitialized(frameSet, width, height);
-
-                std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
-                pc->depth = new uint16_t[width * height];
-                pc->colors = new Vec4b[width * height];
-                pc->lookupImageTo3D = lookup2DTo3D;
-                pc->lookup3DToImage = lookup3DTo2D;
-                pc->lookup3DToImageSize = 1024;
-                pc->modelMatrix = transformation;
-                pc->camera = this;
-                pc->usageFlags = CAMERA_RESPONSIBILITY_GESTURES | CAMERA_RESPONSIBILITY_OCCLUSION | CAMERA_RESPONSIBILITY_RECTIFICATION;
-
-                pc->highResWidth = 1280;
-                pc->highResHeight = 720;
-                pc->highResColors = new uint8_t[pc->highResWidth * pc->highResHeight * 3];
-                std::memcpy(pc->highResColors, frameSet->colorFrame()->data(), pc->highResWidth * pc->highResHeight * 3 * sizeof(uint8_t));
-
-                auto colorProfile =  frameSet->colorFrame()->getStreamProfile();
-                auto depthProfile = frameSet->depthFrame()->getStreamProfile();
-                OBD2CTransform transDepthToColor = depthProfile->getExtrinsicTo(colorProfile);
-                OBD2CTransform transColorToDepth = colorProfile->getExtrinsicTo(depthProfile);
-
-
-                // Get the intrinsic and distortion parameters for the color and depth streams
-                OBCameraIntrinsic colorIntrinsic = colorProfile->as<ob::VideoStreamProfile>()->getIntrinsic();
-                OBCameraDistortion colorDistortion = colorProfile->as<ob::VideoStreamProfile>()->getDistortion();
-                OBCameraIntrinsic depthIntrinsic = depthProfile->as<ob::VideoStreamProfile>()->getIntrinsic();
-                OBCameraDistortion depthDistortion = depthProfile->as<ob::VideoStreamProfile>()->getDistortion();
-
-                OBD2CTransform transIdentity = colorProfile->getExtrinsicTo(colorProfile);
-
-                std::weak_ptr<OrganizedPointCloud> weakPc = pc;
-                pc->highResColorToDepthTransformer = [this, colorIntrinsic, colorDistortion, depthIntrinsic, depthDistortion, transDepthToColor, transColorToDepth, weakPc](float x, float y){
-                    if (auto pcLocked = weakPc.lock()) {
-                        OBPoint2f result;
-                        transformationColor2dToDepth2d(colorIntrinsic, colorDistortion, depthIntrinsic, depthDistortion, transDepthToColor, transColorToDepth, OBPoint2f({x,y}), pcLocked->depth, &result);
-                        return std::pair<float,float>(result.x, result.y);
-                    }
-                    return std::pair<float,float>(0.f, 0.f);
-                };
-
-                pc->projectHighResIn3D = [colorIntrinsic, transIdentity](float x, float y){
-                    OBPoint2f src;
-                    src.x = x;
-                    src.y = y;
-
-                    OBPoint3f result;
-                    ob_error* error;
-
-                    ob_transformation_2d_to_3d(src, 1000.f, colorIntrinsic, transIdentity, &result, &error);
-                    return Vec4f(result.x, result.y, result.z, 0).normalized();
-                };
-
-                std::memcpy(pc->depth, frameSet->depthFrame()->data(), width*height * sizeof(uint16_t));
-                std::shared_ptr<ob::FrameSet> alignedFrameset = std::static_pointer_cast<ob::FrameSet>(aligner->process(frameSet));
-                convert3DTo4D((uint8_t*)(alignedFrameset->colorFrame()->data()), (uint8_t*)(pc->colors), width * height);
-
-                pointCloudCallback(deviceIndex, pc);
-
-            } catch (const ob::Error& e) {
-                std::cerr << "[Orbbec/Callback] "
-                          << /* e.message()/e.getMessage()/e.what() */ "exception in frame callback"
-                          << std::endl;
-                // optional: mehr Details, falls verfügbar
-            } catch (const std::exception& e) {
-                std::cerr << "[Callback std::exception] " << e.what() << std::endl;
-            } catch (...) {
-                std::cerr << "[Callback] Unknown exception\n";
-            }
+            FrameTrace trace;
+            trace.stamp(LATENCY_SDK_ARRIVAL);
+
+            // The SDK thread only hands over the frame set, the conversion runs on the preprocessing workers:
+            FramePreprocessor::getInstance().enqueue(deviceIndex, [this, frameSet, trace](){
+                return convertFrameSet(frameSet, trace);
+            }, pointCloudCallback);
         });
     }
 
+    /** Converts the frame set into a point cloud (on a worker of the FramePreprocessor, returns nullptr on errors) */
+    std::shared_ptr<OrganizedPointCloud> convertFrameSet(std::shared_ptr<ob::FrameSet> frameSet, const FrameTrace& trace) {
+        try {
+            uint32_t width = frameSet->depthFrame()->width();
+            uint32_t height = frameSet->depthFrame()->height();
+
+            ensureLookupsInitialized(frameSet, width, height);
+
+            std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+            pc->framePool = framePool;
+            pc->depth = framePool->acquire<uint16_t>(width * height);
+            pc->colors = framePool->acquire<Vec4b>(width * height);
+            pc->lookupImageTo3D = lookup2DTo3D;
+            pc->lookup3DToImage = lookup3DTo2D;
+            pc->lookup3DToImageSize = 1024;
+            pc->modelMatrix = transformation;
+            pc->camera = this;
+            pc->cameraOwner = shared_from_this();
+            pc->usageFlags = CAMERA_RESPONSIBILITY_GESTURES | CAMERA_RESPONSIBILITY_OCCLUSION | CAMERA_RESPONSIBILITY_RECTIFICATION;
+            pc->frameID = int(frameSet->depthFrame()->getIndex());
+            pc->timestamp = (useGlobalTimestamp ? frameSet->depthFrame()->getGlobalTimeStampUs() : frameSet->depthFrame()->getTimeStampUs()) / 1000000.0;
+            pc->trace = trace;
+
+            pc->highResWidth = 1280;
+            pc->highResHeight = 720;
+            pc->highResColors = framePool->acquire<uint8_t>(pc->highResWidth * pc->highResHeight * 3);
+            std::memcpy(pc->highResColors, frameSet->colorFrame()->data(), pc->highResWidth * pc->highResHeight * 3 * sizeof(uint8_t));
+
+            auto colorProfile =  frameSet->colorFrame()->getStreamProfile();
+            auto depthProfile = frameSet->depthFrame()->getStreamProfile();
+            OBD2CTransform transDepthToColor = depthProfile->getExtrinsicTo(colorProfile);
+
+
+            // Get the intrinsic and distortion parameters of the color stream
+            OBCameraIntrinsic colorIntrinsic = colorProfile->as<ob::VideoStreamProfile>()->getIntrinsic();
+            OBCameraDistortion colorDistortion = colorProfile->as<ob::VideoStreamProfile>()->getDistortion();
+
+            ensureHighResLookupInitialized(colorProfile, pc->highResWidth, pc->highResHeight);
+            pc->lookupHighResTo3D = lookupHighResTo3D;
+
+            if(colorToDepthMapper == nullptr){
+                ColorToDepthMapper::Intrinsics intrinsics{colorIntrinsic.fx, colorIntrinsic.fy, colorIntrinsic.cx, colorIntrinsic.cy};
+                ColorToDepthMapper::Distortion distortion;
+                distortion.k1 = colorDistortion.k1; distortion.k2 = colorDistortion.k2; distortion.k3 = colorDistortion.k3;
+                distortion.k4 = colorDistortion.k4; distortion.k5 = colorDistortion.k5; distortion.k6 = colorDistortion.k6;
+                distortion.p1 = colorDistortion.p1; distortion.p2 = colorDistortion.p2;
+
+                colorToDepthMapper = std::make_shared<ColorToDepthMapper>(width, height, lookup2DTo3D, pc->highResWidth, pc->highResHeight,
+                                                                          intrinsics, distortion, transDepthToColor.rot, transDepthToColor.trans);
+            }
+            pc->colorToDepthMapper = colorToDepthMapper;
+
+            // Table lookup in the dense color to depth map (built on first use):
+            std::weak_ptr<OrganizedPointCloud> weakPc = pc;
+            pc->highResColorToDepthTransformer = [weakPc](float x, float y){
+                if (auto pcLocked = weakPc.lock())
+                    return pcLocked->mapHighResColorToDepth(x, y);
+                return std::pair<float,float>(-1.f, -1.f);
+            };
+
+            std::memcpy(pc->depth, frameSet->depthFrame()->data(), width*height * sizeof(uint16_t));
+            std::shared_ptr<ob::FrameSet> alignedFrameset = std::static_pointer_cast<ob::FrameSet>(aligner->process(frameSet));
+            convert3DTo4D((uint8_t*)(alignedFrameset->colorFrame()->data()), (uint8_t*)(pc->colors), width * height);
+
+            return pc;
+
+        } catch (const ob::Error& e) {
+            std::cerr << "[Orbbec/Callback] "
+                      << /* e.message()/e.getMessage()/e.what() */ "exception in frame callback"
+                      << std::endl;
+            // optional: mehr Details, falls verfügbar
+        } catch (const std::exception& e) {
+            std::cerr << "[Callback std::exception] " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "[Callback] Unknown exception\n";
+        }
+        return nullptr;
+    }
+
     virtual std::string getSerial() override{
         return cameraSerial;
     }
 
+    virtual std::shared_ptr<FramePool> getFramePool() override {
+        return framePool;
+    }
+
     virtual int responsibilityFlags() override{
         return CAMERA_RESPONSIBILITY_GESTURES | CAMERA_RESPONSIBILITY_OCCLUSION;
     }
@@ -245,6 +367,9 @@ public:
         pipe->stop();
         isPipeRunning = false;
 
+        // Frame sets which are still queued reference this camera:
+        FramePreprocessor::getInstance().flush(deviceIndex);
+
         return false;
     }
 
@@ -288,110 +413,4 @@ private:
             dest[i * 4 + 3] = w;
         }
     }
-
-
-    /**
-     * Function from orbbec sdk to project color pixel to depth pixel coordinate
-     */
-    const bool isPixelValid(const OBPoint2f curr, const OBPoint2f start, const OBPoint2f end) {
-        bool valid1 = end.x >= start.x && end.x >= curr.x && curr.x >= start.x;
-        bool valid2 = end.x <= start.x && end.x <= curr.x && curr.x <= start.x;
-        bool valid3 = end.y >= start.y && end.y >= curr.y && curr.y >= start.y;
-        bool valid4 = end.y <= start.y && end.y <= curr.y && curr.y <= start.y;
-        return (valid1 || valid2) && (valid3 || valid4);
-    }
-
-    /**
-     * Function from orbbec sdk to project color pixel to depth pixel coordinate
-     */
-    const void nextPixel(OBPoint2f &curr, const OBPoint2f start, const OBPoint2f end) {
-        if(fabsf(end.x - start.x) < 1e-4) {
-            curr.y = end.y > curr.y ? curr.y + 1 : curr.y - 1;
-        }
-        else {
-            float slope = (end.y - start.y) / (end.x - start.x);
-
-            if(fabs(end.x - curr.x) > fabs(end.y - curr.y)) {
-                curr.x = end.x > curr.x ? curr.x + 1 : curr.x - 1;
-                curr.y = end.y - slope * (end.x - curr.x);
-            }
-            else {
-                curr.y = end.y > curr.y ? curr.y + 1 : curr.y - 1;
-                curr.x = end.x - ((end.y - curr.y) / slope);
-            }
-        }
-    }
-
-
-    /**
-     * Function from orbbec sdk to project color pixel to depth pixel coordinate
-     */
-    const bool transformationColor2dToDepth2d(OBCameraIntrinsic colorIntrinsic, OBCameraDistortion colorDistortion, OBCameraIntrinsic depthIntrinsic, OBCameraDistortion depthDistortion, OBD2CTransform transDepthToColor, OBD2CTransform transColorToDepth, const OBPoint2f colorPixel, uint16_t *depthMap, OBPoint2f *depthPixel) {
-        float     depthRangeMm[2] = { 60.f, 8000.f };
-        OBPoint2f nearPixelDepth, farthestPixelDepth;
-        bool      nearValid = 0, farthestValid = 0;
-        ob_error* error;
-
-        // color pixel to depth pixel when z= depthRangeMm[0]
-        nearValid = ob_transformation_2d_to_2d(colorPixel, depthRangeMm[0], colorIntrinsic, colorDistortion, depthIntrinsic, depthDistortion, transColorToDepth, &nearPixelDepth, &error);
-
-        if(!nearValid) {
-            if(nearPixelDepth.x < 0) {
-                nearPixelDepth.x = 0;
-            }
-            if(nearPixelDepth.y < 0) {
-                nearPixelDepth.y = 0;
-            }
-            if(nearPixelDepth.x > depthIntrinsic.width - 1) {
-                nearPixelDepth.x = (float)depthIntrinsic.width - 1;
-            }
-            if(nearPixelDepth.y > depthIntrinsic.height - 1) {
-                nearPixelDepth.y = (float)depthIntrinsic.height - 1;
-            }
-        }
-
-        // color pixel to depth pixel when z= depthRangeMm[1]
-        farthestValid = ob_transformation_2d_to_2d(colorPixel, depthRangeMm[1], colorIntrinsic, colorDistortion, depthIntrinsic, depthDistortion, transColorToDepth, &farthestPixelDepth, &error);
-
-        if(!farthestValid) {
-            if(farthestPixelDepth.x < 0) {
-                farthestPixelDepth.x = 0;
-            }
-            if(farthestPixelDepth.y < 0) {
-                farthestPixelDepth.y = 0;
-            }
-            if(farthestPixelDepth.x > depthIntrinsic.width - 1) {
-                farthestPixelDepth.x = (float)depthIntrinsic.width - 1;
-            }
-            if(farthestPixelDepth.y > depthIntrinsic.height - 1) {
-                farthestPixelDepth.y = (float)depthIntrinsic.height - 1;
-            }
-        }
-
-        // search along line for the depth pixel that it's projected pixel is the closest to the input pixel
-        float minDist = std::numeric_limits<float>::max();
-        for(OBPoint2f curPixel = nearPixelDepth; isPixelValid(curPixel, nearPixelDepth, farthestPixelDepth); nextPixel(curPixel, nearPixelDepth, farthestPixelDepth)){
-            int x     = (int)curPixel.x;
-            int y     = (int)curPixel.y;
-            int index = y * depthIntrinsic.width + x;
-
-            if(depthMap[index] == 0)
-                continue;
-
-            float depth = depthMap[index];
-
-            OBPoint2f curColorPixel{};
-            ob_transformation_2d_to_2d(curPixel, depth, depthIntrinsic, depthDistortion, colorIntrinsic, colorDistortion, transDepthToColor, &curColorPixel, &error);
-            float errDist = (float)(pow((curColorPixel.x - colorPixel.x), 2) + pow((curColorPixel.y - colorPixel.y), 2));
-
-            if(errDist < minDist) {
-                minDist       = errDist;
-                depthPixel->x = (int)curPixel.x;
-                depthPixel->y = (int)curPixel.y;
-            }
-        }
-
-        return true;
-    }
-
 };
@@ -13,30 +13,50 @@
 struct OrbbecCameraProvider {
     static ob::Context* ctx;
 
-    std::vector<std::shared_ptr<OrbbecCamera>> getCameras(int indexOffset, std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback){
-        if(ctx == nullptr)
+    static ob::Context* getContext(){
+        if(ctx == nullptr){
             ctx = new ob::Context();
 
+            // Periodically synchronize the device clocks with the host, so that the
+            // timestamps of multiple cameras can be compared (frame grouping):
+            ctx->enableDeviceClockSync(60000);
+        }
+        return ctx;
+    }
+
+    /** Creates the camera for the device at listIndex of the device list (the stream is not started) */
+    std::shared_ptr<OrbbecCamera> createCamera(std::shared_ptr<ob::DeviceList> devList, uint32_t listIndex, int deviceIndex, std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback){
+        std::shared_ptr<ob::Device> dev = devList->getDevice(listIndex);
+        std::shared_ptr<ob::Pipeline> pipe = std::make_shared<ob::Pipeline>(dev);
+
+        std::cout << "    Added Camera " << deviceIndex << "." << std::endl;
+        return std::make_shared<OrbbecCamera>(pipe, deviceIndex, pointCloudCallback);
+    }
 
+    std::vector<std::shared_ptr<OrbbecCamera>> getCameras(int indexOffset, std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback){
         std::vector<std::shared_ptr<OrbbecCamera>> result;
 
         // Query the list of connected devices
-        auto devList = ctx->queryDeviceList();
+        auto devList = getContext()->queryDeviceList();
 
         // Get the number of connected devices
         int devCount = devList->getCount();
 
         for(int i = 0; i < devCount; i++){
-            std::shared_ptr<ob::Device> dev  = devList->getDevice(i);
-            std::shared_ptr<ob::Pipeline> pipe = std::make_shared<ob::Pipeline>(dev);
-
-            std::cout << "    Added Camera " << i + indexOffset << "." << std::endl;
-            result.push_back(std::make_shared<OrbbecCamera>(pipe, i + indexOffset, pointCloudCallback));
+            result.push_back(createCamera(devList, i, i + indexOffset, pointCloudCallback));
         }
 
         return result;
     }
 
+    /**
+     * Calls the callback (in a thread of the SDK) with the lists of disconnected
+     * and newly connected devices.
+     */
+    void setDeviceChangedCallback(ob::Context::DeviceChangedCallback callback){
+        getContext()->setDeviceChangedCallback(callback);
+    }
+
     void free(){
 
     }
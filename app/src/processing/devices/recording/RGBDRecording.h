@@ -0,0 +1,520 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/MemoryMappedFile.h"
+
+/**
+ * File format of recorded RGBD sessions (*.rgbdrec), little endian:
+ *
+ *   RGBDRecordingFileHeader
+ *   Chunk*        (each: RGBDRecordingChunkHeader + payload, padded to 8 bytes)
+ *
+ * A STREAM chunk describes one camera (resolution, serial, model matrix and
+ * both lookup tables), each FRAME chunk contains one organized point cloud of
+ * a stream. A LOOKUP chunk adds a lookup table of a stream which was not
+ * available yet when the stream was added. The INDEX chunk at the end lists
+ * the offsets of all stream and frame chunks and is referenced by the file
+ * header. If a recording was not closed properly, the reader rebuilds the
+ * index by walking over the chunks.
+ */
+
+#define RGBD_RECORDING_MAGIC "DPRGBD01"
+#define RGBD_RECORDING_VERSION 1
+
+enum RGBDRecordingChunkType : uint32_t {
+    RGBD_RECORDING_CHUNK_STREAM = 1,
+    RGBD_RECORDING_CHUNK_FRAME = 2,
+    RGBD_RECORDING_CHUNK_INDEX = 3,
+    RGBD_RECORDING_CHUNK_LOOKUP = 4
+};
+
+enum RGBDRecordingLookupType : uint32_t {
+    /** width * height * 2 floats */
+    RGBD_RECORDING_LOOKUP_IMAGE_TO_3D = 0,
+
+    /** lookup3DToImageSize^2 * 2 floats */
+    RGBD_RECORDING_LOOKUP_3D_TO_IMAGE = 1
+};
+
+enum RGBDRecordingDepthEncoding : uint32_t {
+    RGBD_RECORDING_DEPTH_RAW = 0,
+
+    /** Lossless, see RVLDepthCodec */
+    RGBD_RECORDING_DEPTH_RVL = 1
+};
+
+struct RGBDRecordingFileHeader {
+    char magic[8];
+    uint32_t version = RGBD_RECORDING_VERSION;
+    uint32_t streamCount = 0;
+    uint64_t indexOffset = 0;
+    uint64_t frameCount = 0;
+};
+
+struct RGBDRecordingChunkHeader {
+    uint32_t type;
+    uint32_t streamIndex;
+    uint64_t payloadSize;
+};
+
+struct RGBDRecordingStreamInfo {
+    char serial[64] = {};
+    char cameraType[32] = {};
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int32_t highResWidth = -1;
+    int32_t highResHeight = -1;
+    uint32_t lookup3DToImageSize = 0;
+    uint32_t usageFlags = 0;
+
+    /** Column major, like Mat4f */
+    float modelMatrix[16] = {};
+};
+
+struct RGBDRecordingFrameHeader {
+    /** Arrival time on the host (steady clock) */
+    uint64_t hostTimestampUs = 0;
+
+    /** Device timestamp in seconds (-1 if not available) */
+    double deviceTimestamp = -1;
+
+    int32_t frameID = -1;
+    uint32_t depthEncoding = RGBD_RECORDING_DEPTH_RAW;
+    uint64_t depthBytes = 0;
+    uint64_t colorBytes = 0;
+    uint64_t highResColorBytes = 0;
+
+    /** Column major, like Mat4f */
+    float modelMatrix[16] = {};
+};
+
+struct RGBDRecordingLookupInfo {
+    uint32_t lookupType = RGBD_RECORDING_LOOKUP_IMAGE_TO_3D;
+    uint32_t lookup3DToImageSize = 0;
+    uint64_t lookupBytes = 0;
+};
+
+struct RGBDRecordingIndexEntry {
+    uint64_t chunkOffset;
+    uint64_t hostTimestampUs;
+    uint32_t streamIndex;
+    uint32_t chunkType;
+};
+
+static_assert(sizeof(RGBDRecordingFileHeader) == 32, "Unexpected padding in RGBDRecordingFileHeader");
+static_assert(sizeof(RGBDRecordingChunkHeader) == 16, "Unexpected padding in RGBDRecordingChunkHeader");
+static_assert(sizeof(RGBDRecordingStreamInfo) % 8 == 0, "Unexpected padding in RGBDRecordingStreamInfo");
+static_assert(sizeof(RGBDRecordingFrameHeader) % 8 == 0, "Unexpected padding in RGBDRecordingFrameHeader");
+static_assert(sizeof(RGBDRecordingLookupInfo) == 16, "Unexpected padding in RGBDRecordingLookupInfo");
+static_assert(sizeof(RGBDRecordingIndexEntry) == 24, "Unexpected padding in RGBDRecordingIndexEntry");
+
+/**
+ * Writes a recording chunk by chunk. All functions are thread safe.
+ */
+class RGBDRecordingWriter {
+    std::mutex mutex;
+    std::ofstream file;
+
+    RGBDRecordingFileHeader header;
+    std::vector<RGBDRecordingIndexEntry> index;
+
+    uint64_t writtenBytes = 0;
+
+    void writeBytes(const void* data, size_t size){
+        if(size == 0)
+            return;
+        file.write(static_cast<const char*>(data), std::streamsize(size));
+        writtenBytes += size;
+    }
+
+    void writePadding(){
+        static const uint8_t zeros[8] = {};
+        writeBytes(zeros, (8 - writtenBytes % 8) % 8);
+    }
+
+    static uint64_t padded(uint64_t size){
+        return (size + 7) / 8 * 8;
+    }
+
+public:
+    RGBDRecordingWriter(const std::string& path)
+        : file(path, std::ios::binary | std::ios::trunc)
+    {
+        if(!file){
+            std::cerr << "Could not create recording " << path << std::endl;
+            return;
+        }
+
+        std::memcpy(header.magic, RGBD_RECORDING_MAGIC, 8);
+        writeBytes(&header, sizeof(header));
+    }
+
+    ~RGBDRecordingWriter(){
+        close();
+    }
+
+    bool isOpen(){
+        std::unique_lock l(mutex);
+        return file.is_open() && file.good();
+    }
+
+    /**
+     * Adds a stream description and returns its index. The lookup tables are
+     * expected to have width * height * 2 and lookup3DToImageSize^2 * 2 floats
+     * (or to be nullptr).
+     */
+    uint32_t addStream(const RGBDRecordingStreamInfo& info, const float* lookupImageTo3D, const float* lookup3DToImage){
+        std::unique_lock l(mutex);
+
+        uint64_t lookupImageTo3DBytes = lookupImageTo3D ? uint64_t(info.width) * info.height * 2 * sizeof(float) : 0;
+        uint64_t lookup3DToImageBytes = lookup3DToImage ? uint64_t(info.lookup3DToImageSize) * info.lookup3DToImageSize * 2 * sizeof(float) : 0;
+
+        RGBDRecordingStreamInfo storedInfo = info;
+        if(!lookup3DToImage)
+            storedInfo.lookup3DToImageSize = 0;
+
+        RGBDRecordingChunkHeader chunk;
+        chunk.type = RGBD_RECORDING_CHUNK_STREAM;
+        chunk.streamIndex = header.streamCount;
+        chunk.payloadSize = sizeof(RGBDRecordingStreamInfo) + 2 * sizeof(uint64_t) + padded(lookupImageTo3DBytes) + padded(lookup3DToImageBytes);
+
+        index.push_back({writtenBytes, 0, chunk.streamIndex, RGBD_RECORDING_CHUNK_STREAM});
+
+        writeBytes(&chunk, sizeof(chunk));
+        writeBytes(&storedInfo, sizeof(storedInfo));
+        writeBytes(&lookupImageTo3DBytes, sizeof(uint64_t));
+        writeBytes(&lookup3DToImageBytes, sizeof(uint64_t));
+        writeBytes(lookupImageTo3D, lookupImageTo3DBytes);
+        writePadding();
+        writeBytes(lookup3DToImage, lookup3DToImageBytes);
+        writePadding();
+
+        return header.streamCount++;
+    }
+
+    /**
+     * Adds a lookup table to a stream which did not have it yet when it was
+     * added (e.g. because it was still being generated). lookup3DToImageSize
+     * is only used for RGBD_RECORDING_LOOKUP_3D_TO_IMAGE.
+     */
+    void addLookup(uint32_t streamIndex, RGBDRecordingLookupType lookupType, uint32_t lookup3DToImageSize, const float* lookup, uint64_t lookupBytes){
+        std::unique_lock l(mutex);
+
+        RGBDRecordingLookupInfo info;
+        info.lookupType = lookupType;
+        info.lookup3DToImageSize = lookup3DToImageSize;
+        info.lookupBytes = lookupBytes;
+
+        RGBDRecordingChunkHeader chunk;
+        chunk.type = RGBD_RECORDING_CHUNK_LOOKUP;
+        chunk.streamIndex = streamIndex;
+        chunk.payloadSize = sizeof(RGBDRecordingLookupInfo) + padded(lookupBytes);
+
+        index.push_back({writtenBytes, 0, streamIndex, RGBD_RECORDING_CHUNK_LOOKUP});
+
+        writeBytes(&chunk, sizeof(chunk));
+        writeBytes(&info, sizeof(info));
+        writeBytes(lookup, lookupBytes);
+        writePadding();
+    }
+
+    /** Appends a frame of the given stream. */
+    void writeFrame(uint32_t streamIndex, const RGBDRecordingFrameHeader& frame, const void* depth, const void* colors, const void* highResColors){
+        std::unique_lock l(mutex);
+
+        RGBDRecordingChunkHeader chunk;
+        chunk.type = RGBD_RECORDING_CHUNK_FRAME;
+        chunk.streamIndex = streamIndex;
+        chunk.payloadSize = sizeof(RGBDRecordingFrameHeader) + padded(frame.depthBytes) + padded(frame.colorBytes) + padded(frame.highResColorBytes);
+
+        index.push_back({writtenBytes, frame.hostTimestampUs, streamIndex, RGBD_RECORDING_CHUNK_FRAME});
+
+        writeBytes(&chunk, sizeof(chunk));
+        writeBytes(&frame, sizeof(frame));
+        writeBytes(depth, frame.depthBytes);
+        writePadding();
+        writeBytes(colors, frame.colorBytes);
+        writePadding();
+        writeBytes(highResColors, frame.highResColorBytes);
+        writePadding();
+    }
+
+    /** Writes the frame index and finalizes the file header. */
+    void close(){
+        std::unique_lock l(mutex);
+        if(!file.is_open())
+            return;
+
+        RGBDRecordingChunkHeader chunk;
+        chunk.type = RGBD_RECORDING_CHUNK_INDEX;
+        chunk.streamIndex = 0;
+        chunk.payloadSize = index.size() * sizeof(RGBDRecordingIndexEntry);
+
+        header.indexOffset = writtenBytes;
+        header.frameCount = 0;
+        for(const RGBDRecordingIndexEntry& entry : index)
+            header.frameCount += entry.chunkType == RGBD_RECORDING_CHUNK_FRAME ? 1 : 0;
+
+        writeBytes(&chunk, sizeof(chunk));
+        writeBytes(index.data(), index.size() * sizeof(RGBDRecordingIndexEntry));
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+    }
+};
+
+/**
+ * Read access to a memory mapped recording. Returned pointers point directly
+ * into the mapping and stay valid as long as the reader exists.
+ */
+class RGBDRecordingReader {
+public:
+    struct Stream {
+        RGBDRecordingStreamInfo info;
+        const float* lookupImageTo3D = nullptr;
+        const float* lookup3DToImage = nullptr;
+
+        /** Offsets of the frame chunks of this stream, ordered by time */
+        std::vector<uint64_t> frameOffsets;
+    };
+
+    struct Frame {
+        const RGBDRecordingFrameHeader* header = nullptr;
+        const uint8_t* depth = nullptr;
+        const uint8_t* colors = nullptr;
+        const uint8_t* highResColors = nullptr;
+    };
+
+private:
+    MemoryMappedFile file;
+    std::vector<Stream> streams;
+
+    uint64_t firstTimestampUs = 0;
+    uint64_t lastTimestampUs = 0;
+
+    static uint64_t padded(uint64_t size){
+        return (size + 7) / 8 * 8;
+    }
+
+    const RGBDRecordingChunkHeader* chunkAt(uint64_t offset) const {
+        if(offset + sizeof(RGBDRecordingChunkHeader) > file.size())
+            return nullptr;
+
+        const RGBDRecordingChunkHeader* chunk = reinterpret_cast<const RGBDRecordingChunkHeader*>(file.data() + offset);
+        if(chunk->payloadSize > file.size() - offset - sizeof(RGBDRecordingChunkHeader))
+            return nullptr;
+
+        return chunk;
+    }
+
+    /**
+     * True if the sections with the given sizes (each padded to 8 bytes) fit
+     * into the remaining bytes of a payload. The sizes come from the file, so
+     * they are checked one by one to avoid overflows of the sum.
+     */
+    static bool sectionsFit(uint64_t remainingBytes, std::initializer_list<uint64_t> sectionSizes){
+        for(uint64_t size : sectionSizes){
+            if(size > remainingBytes || padded(size) > remainingBytes)
+                return false;
+            remainingBytes -= padded(size);
+        }
+        return true;
+    }
+
+    /** Checks that the sizes in the frame header match the stream and the chunk */
+    bool isFrameValid(const RGBDRecordingChunkHeader* chunk) const {
+        if(chunk->payloadSize < sizeof(RGBDRecordingFrameHeader) || chunk->streamIndex >= streams.size())
+            return false;
+
+        const RGBDRecordingFrameHeader* frame = reinterpret_cast<const RGBDRecordingFrameHeader*>(chunk + 1);
+        if(!sectionsFit(chunk->payloadSize - sizeof(RGBDRecordingFrameHeader), {frame->depthBytes, frame->colorBytes, frame->highResColorBytes}))
+            return false;
+
+        const RGBDRecordingStreamInfo& info = streams[chunk->streamIndex].info;
+        uint64_t pixelCount = uint64_t(info.width) * info.height;
+        uint64_t highResBytes = info.highResWidth > 0 && info.highResHeight > 0 ? uint64_t(info.highResWidth) * info.highResHeight * 3 : 0;
+
+        return (frame->colorBytes == 0 || frame->colorBytes == pixelCount * 4)
+            && (frame->highResColorBytes == 0 || frame->highResColorBytes == highResBytes);
+    }
+
+    bool readStream(const RGBDRecordingChunkHeader* chunk){
+        const uint8_t* payload = reinterpret_cast<const uint8_t*>(chunk + 1);
+        if(chunk->payloadSize < sizeof(RGBDRecordingStreamInfo) + 2 * sizeof(uint64_t) || chunk->streamIndex != streams.size())
+            return false;
+
+        Stream stream;
+        std::memcpy(&stream.info, payload, sizeof(RGBDRecordingStreamInfo));
+        payload += sizeof(RGBDRecordingStreamInfo);
+
+        uint64_t lookupImageTo3DBytes, lookup3DToImageBytes;
+        std::memcpy(&lookupImageTo3DBytes, payload, sizeof(uint64_t));
+        std::memcpy(&lookup3DToImageBytes, payload + sizeof(uint64_t), sizeof(uint64_t));
+        payload += 2 * sizeof(uint64_t);
+
+        // The lookup tables have to match the resolution and fit into the chunk:
+        uint64_t expectedImageTo3DBytes = uint64_t(stream.info.width) * stream.info.height * 2 * sizeof(float);
+        uint64_t expected3DToImageBytes = uint64_t(stream.info.lookup3DToImageSize) * stream.info.lookup3DToImageSize * 2 * sizeof(float);
+        uint64_t remainingBytes = chunk->payloadSize - sizeof(RGBDRecordingStreamInfo) - 2 * sizeof(uint64_t);
+
+        if((lookupImageTo3DBytes != 0 && lookupImageTo3DBytes != expectedImageTo3DBytes)
+           || (lookup3DToImageBytes != 0 && lookup3DToImageBytes != expected3DToImageBytes)
+           || !sectionsFit(remainingBytes, {lookupImageTo3DBytes, lookup3DToImageBytes})){
+            std::cerr << "Recording: Stream " << chunk->streamIndex << " has invalid lookup tables." << std::endl;
+            return false;
+        }
+
+        if(lookupImageTo3DBytes > 0)
+            stream.lookupImageTo3D = reinterpret_cast<const float*>(payload);
+        if(lookup3DToImageBytes > 0)
+            stream.lookup3DToImage = reinterpret_cast<const float*>(payload + padded(lookupImageTo3DBytes));
+
+        streams.push_back(stream);
+        return true;
+    }
+
+    /** Applies a lookup table that was added after the stream to the whole stream */
+    bool readLookup(const RGBDRecordingChunkHeader* chunk){
+        if(chunk->payloadSize < sizeof(RGBDRecordingLookupInfo) || chunk->streamIndex >= streams.size())
+            return false;
+
+        const RGBDRecordingLookupInfo* info = reinterpret_cast<const RGBDRecordingLookupInfo*>(chunk + 1);
+        const float* lookup = reinterpret_cast<const float*>(info + 1);
+        Stream& stream = streams[chunk->streamIndex];
+
+        if(!sectionsFit(chunk->payloadSize - sizeof(RGBDRecordingLookupInfo), {info->lookupBytes}))
+            return false;
+
+        if(info->lookupType == RGBD_RECORDING_LOOKUP_IMAGE_TO_3D && info->lookupBytes == uint64_t(stream.info.width) * stream.info.height * 2 * sizeof(float)){
+            stream.lookupImageTo3D = lookup;
+            return true;
+        }
+
+        if(info->lookupType == RGBD_RECORDING_LOOKUP_3D_TO_IMAGE && info->lookup3DToImageSize > 0
+           && info->lookupBytes == uint64_t(info->lookup3DToImageSize) * info->lookup3DToImageSize * 2 * sizeof(float)){
+            stream.lookup3DToImage = lookup;
+            stream.info.lookup3DToImageSize = info->lookup3DToImageSize;
+            return true;
+        }
+
+        std::cerr << "Recording: Stream " << chunk->streamIndex << " has an invalid lookup table chunk." << std::endl;
+        return false;
+    }
+
+public:
+    RGBDRecordingReader(const std::string& path){
+        if(!file.open(path))
+            return;
+
+        const RGBDRecordingFileHeader* header = reinterpret_cast<const RGBDRecordingFileHeader*>(file.data());
+        if(file.size() < sizeof(RGBDRecordingFileHeader) || std::memcmp(header->magic, RGBD_RECORDING_MAGIC, 8) != 0 || header->version != RGBD_RECORDING_VERSION){
+            std::cerr << "Recording " << path << " has an unknown format." << std::endl;
+            file.close();
+            return;
+        }
+
+        std::vector<RGBDRecordingIndexEntry> index;
+
+        const RGBDRecordingChunkHeader* indexChunk = header->indexOffset > 0 ? chunkAt(header->indexOffset) : nullptr;
+        if(indexChunk != nullptr && indexChunk->type == RGBD_RECORDING_CHUNK_INDEX){
+            const RGBDRecordingIndexEntry* entries = reinterpret_cast<const RGBDRecordingIndexEntry*>(indexChunk + 1);
+            index.assign(entries, entries + indexChunk->payloadSize / sizeof(RGBDRecordingIndexEntry));
+        } else {
+            // Not closed properly, so walk over all chunks to rebuild the index:
+            uint64_t offset = sizeof(RGBDRecordingFileHeader);
+            while(const RGBDRecordingChunkHeader* chunk = chunkAt(offset)){
+                if(chunk->type == RGBD_RECORDING_CHUNK_STREAM || chunk->type == RGBD_RECORDING_CHUNK_LOOKUP){
+                    index.push_back({offset, 0, chunk->streamIndex, chunk->type});
+                } else if(chunk->type == RGBD_RECORDING_CHUNK_FRAME && chunk->payloadSize >= sizeof(RGBDRecordingFrameHeader)){
+                    const RGBDRecordingFrameHeader* frame = reinterpret_cast<const RGBDRecordingFrameHeader*>(chunk + 1);
+                    index.push_back({offset, frame->hostTimestampUs, chunk->streamIndex, RGBD_RECORDING_CHUNK_FRAME});
+                } else {
+                    break;
+                }
+                offset += sizeof(RGBDRecordingChunkHeader) + chunk->payloadSize;
+            }
+            std::cout << "Recording " << path << " has no frame index (not closed properly), rebuilt " << index.size() << " entries." << std::endl;
+        }
+
+        firstTimestampUs = UINT64_MAX;
+        size_t invalidFrames = 0;
+        for(const RGBDRecordingIndexEntry& entry : index){
+            const RGBDRecordingChunkHeader* chunk = chunkAt(entry.chunkOffset);
+            if(chunk == nullptr || chunk->type != entry.chunkType || chunk->streamIndex != entry.streamIndex)
+                continue;
+
+            if(entry.chunkType == RGBD_RECORDING_CHUNK_STREAM){
+                readStream(chunk);
+            } else if(entry.chunkType == RGBD_RECORDING_CHUNK_LOOKUP){
+                readLookup(chunk);
+            } else if(entry.chunkType == RGBD_RECORDING_CHUNK_FRAME && entry.streamIndex < streams.size()){
+                // Only frames whose sections lie within their chunk are indexed, so getFrame() never reads past the mapping:
+                if(!isFrameValid(chunk)){
+                    ++invalidFrames;
+                    continue;
+                }
+
+                firstTimestampUs = std::min(firstTimestampUs, entry.hostTimestampUs);
+                lastTimestampUs = std::max(lastTimestampUs, entry.hostTimestampUs);
+                streams[entry.streamIndex].frameOffsets.push_back(entry.chunkOffset);
+            }
+        }
+
+        if(firstTimestampUs == UINT64_MAX)
+            firstTimestampUs = 0;
+
+        if(invalidFrames > 0)
+            std::cerr << "Recording " << path << ": Skipped " << invalidFrames << " corrupt frames." << std::endl;
+    }
+
+    bool isOpen() const {
+        return file.isOpen();
+    }
+
+    size_t getStreamCount() const {
+        return streams.size();
+    }
+
+    const Stream& getStream(size_t streamIndex) const {
+        return streams[streamIndex];
+    }
+
+    size_t getFrameCount(size_t streamIndex) const {
+        return streams[streamIndex].frameOffsets.size();
+    }
+
+    /** Host timestamp of the first frame of all streams */
+    uint64_t getFirstTimestampUs() const {
+        return firstTimestampUs;
+    }
+
+    /** Host timestamp of the last frame of all streams */
+    uint64_t getLastTimestampUs() const {
+        return lastTimestampUs;
+    }
+
+    /** Returns a frame of the stream (only frames with valid section sizes are indexed) */
+    Frame getFrame(size_t streamIndex, size_t frameIndex) const {
+        Frame frame;
+        const RGBDRecordingChunkHeader* chunk = chunkAt(streams[streamIndex].frameOffsets[frameIndex]);
+
+        frame.header = reinterpret_cast<const RGBDRecordingFrameHeader*>(chunk + 1);
+        frame.depth = reinterpret_cast<const uint8_t*>(frame.header + 1);
+        frame.colors = frame.depth + padded(frame.header->depthBytes);
+        frame.highResColors = frame.colors + padded(frame.header->colorBytes);
+        return frame;
+    }
+};
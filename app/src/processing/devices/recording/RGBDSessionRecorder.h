@@ -0,0 +1,213 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <thread>
+
+#include "src/processing/devices/RGBDCamera.h"
+#include "src/processing/devices/recording/RGBDRecording.h"
+#include "src/processing/codec/RVLDepthCodec.h"
+
+/**
+ * Records the point clouds of all devices (live or simulated) into a session
+ * file which can be replayed with RecordedCamera.
+ *
+ * Frames are only queued in the camera threads, the file is written by a
+ * separate thread. If writing is too slow, frames are dropped (and counted)
+ * instead of stalling the cameras.
+ */
+class RGBDSessionRecorder {
+    RGBDRecordingWriter writer;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+
+    struct QueuedFrame {
+        int deviceIndex;
+        std::shared_ptr<OrganizedPointCloud> pointCloud;
+        uint64_t hostTimestampUs;
+    };
+
+    std::deque<QueuedFrame> queue;
+    size_t maxQueueSize;
+
+    bool stopping = false;
+    std::thread writerThread;
+
+    struct StreamState {
+        uint32_t streamIndex;
+
+        /** Lookup tables already in the file (they may be generated after the first frame) */
+        bool hasLookupImageTo3D;
+        bool hasLookup3DToImage;
+    };
+
+    /** Device index to stream (only used by writer thread) */
+    std::map<int, StreamState> streams;
+
+    std::atomic<size_t> writtenFrames = 0;
+    std::atomic<size_t> droppedFrames = 0;
+
+    /** Compress the depth images losslessly (RVL) */
+    bool compressDepth;
+
+    /** Encoded depth of the current frame (only used by writer thread) */
+    std::vector<uint8_t> encodedDepth;
+
+    static uint64_t nowUs(){
+        return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /** Writes the lookup tables of the point cloud which were not available when the stream was added */
+    void addMissingLookups(StreamState& stream, const std::shared_ptr<OrganizedPointCloud>& pc){
+        if(!stream.hasLookupImageTo3D && pc->lookupImageTo3D){
+            writer.addLookup(stream.streamIndex, RGBD_RECORDING_LOOKUP_IMAGE_TO_3D, 0, pc->lookupImageTo3D, uint64_t(pc->width) * pc->height * 2 * sizeof(float));
+            stream.hasLookupImageTo3D = true;
+        }
+
+        if(!stream.hasLookup3DToImage && pc->lookup3DToImage && pc->lookup3DToImageSize > 0){
+            writer.addLookup(stream.streamIndex, RGBD_RECORDING_LOOKUP_3D_TO_IMAGE, pc->lookup3DToImageSize, pc->lookup3DToImage,
+                             uint64_t(pc->lookup3DToImageSize) * pc->lookup3DToImageSize * 2 * sizeof(float));
+            stream.hasLookup3DToImage = true;
+        }
+    }
+
+    uint32_t getStreamIndex(int deviceIndex, const std::shared_ptr<OrganizedPointCloud>& pc){
+        auto it = streams.find(deviceIndex);
+        if(it != streams.end()){
+            addMissingLookups(it->second, pc);
+            return it->second.streamIndex;
+        }
+
+        RGBDRecordingStreamInfo info;
+        std::string serial = pc->camera ? pc->camera->getSerial() : "Virtual" + std::to_string(deviceIndex);
+        std::string cameraType = pc->camera ? pc->camera->type() : "Virtual";
+        std::strncpy(info.serial, serial.c_str(), sizeof(info.serial) - 1);
+        std::strncpy(info.cameraType, cameraType.c_str(), sizeof(info.cameraType) - 1);
+
+        info.width = pc->width;
+        info.height = pc->height;
+        info.highResWidth = pc->highResColors ? pc->highResWidth : -1;
+        info.highResHeight = pc->highResColors ? pc->highResHeight : -1;
+        info.lookup3DToImageSize = pc->lookup3DToImageSize;
+        info.usageFlags = pc->usageFlags;
+        std::memcpy(info.modelMatrix, pc->modelMatrix.data, sizeof(info.modelMatrix));
+
+        uint32_t streamIndex = writer.addStream(info, pc->lookupImageTo3D, pc->lookup3DToImage);
+        streams[deviceIndex] = {streamIndex, pc->lookupImageTo3D != nullptr, pc->lookup3DToImage != nullptr};
+        return streamIndex;
+    }
+
+    void writeFrame(int deviceIndex, const std::shared_ptr<OrganizedPointCloud>& pc, uint64_t hostTimestampUs){
+        uint32_t streamIndex = getStreamIndex(deviceIndex, pc);
+        size_t pixelCount = size_t(pc->width) * pc->height;
+
+        RGBDRecordingFrameHeader frame;
+        frame.hostTimestampUs = hostTimestampUs;
+        frame.deviceTimestamp = pc->timestamp;
+        frame.frameID = pc->frameID;
+        frame.depthEncoding = RGBD_RECORDING_DEPTH_RAW;
+        frame.depthBytes = pc->depth ? pixelCount * sizeof(uint16_t) : 0;
+
+        const void* depth = pc->depth;
+        if(compressDepth && pc->depth){
+            RVLDepthCodec::encode(pc->depth, pixelCount, encodedDepth);
+            frame.depthEncoding = RGBD_RECORDING_DEPTH_RVL;
+            frame.depthBytes = encodedDepth.size();
+            depth = encodedDepth.data();
+        }
+        frame.colorBytes = pc->colors ? pixelCount * sizeof(Vec4b) : 0;
+        frame.highResColorBytes = pc->highResColors ? size_t(pc->highResWidth) * pc->highResHeight * 3 : 0;
+        std::memcpy(frame.modelMatrix, pc->modelMatrix.data, sizeof(frame.modelMatrix));
+
+        writer.writeFrame(streamIndex, frame, depth, pc->colors, pc->highResColors);
+        ++writtenFrames;
+    }
+
+    void writeLoop(){
+        while(true){
+            QueuedFrame item;
+            {
+                std::unique_lock l(queueMutex);
+                queueCondition.wait(l, [this]{ return stopping || !queue.empty(); });
+
+                if(queue.empty())
+                    return;
+
+                item = queue.front();
+                queue.pop_front();
+            }
+
+            writeFrame(item.deviceIndex, item.pointCloud, item.hostTimestampUs);
+        }
+    }
+
+public:
+    RGBDSessionRecorder(const std::string& path, bool compressDepth = true, size_t maxQueueSize = 90)
+        : writer(path)
+        , maxQueueSize(maxQueueSize)
+        , compressDepth(compressDepth)
+    {
+        writerThread = std::thread(&RGBDSessionRecorder::writeLoop, this);
+    }
+
+    ~RGBDSessionRecorder(){
+        stop();
+    }
+
+    /**
+     * Rejects further point clouds, writes the queued ones and finalizes the
+     * file. Camera threads which still hold the recorder afterwards only see
+     * it stopped (does nothing if already stopped).
+     */
+    void stop(){
+        if(!writerThread.joinable())
+            return;
+
+        {
+            std::unique_lock l(queueMutex);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        writerThread.join();
+        writer.close();
+
+        std::cout << "Recording finished: " << writtenFrames << " frames written, " << droppedFrames << " dropped." << std::endl;
+    }
+
+    bool isOpen(){
+        return writer.isOpen();
+    }
+
+    /** Queues the point cloud for writing (called from the camera threads) */
+    void addPointCloud(int deviceIndex, std::shared_ptr<OrganizedPointCloud> pc){
+        if(pc == nullptr)
+            return;
+
+        {
+            std::unique_lock l(queueMutex);
+            if(stopping)
+                return;
+
+            if(queue.size() >= maxQueueSize){
+                ++droppedFrames;
+                return;
+            }
+            queue.push_back({deviceIndex, pc, nowUs()});
+        }
+        queueCondition.notify_one();
+    }
+
+    size_t getWrittenFrameCount(){
+        return writtenFrames;
+    }
+
+    size_t getDroppedFrameCount(){
+        return droppedFrames;
+    }
+};
@@ -0,0 +1,244 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "src/processing/devices/RGBDCamera.h"
+#include "src/processing/devices/recording/RGBDRecording.h"
+#include "src/processing/codec/RVLDepthCodec.h"
+
+/**
+ * Replays one stream of a recorded RGBD session. The point clouds are passed
+ * to the camera manager exactly like an OrbbecCamera does, so the whole
+ * pipeline can be run (and benchmarked) without any hardware.
+ *
+ * All RecordedCameras of one session share the same reader and replay start
+ * time, so their relative timing stays as recorded in realtime mode.
+ */
+class RecordedCamera : public RGBDCamera {
+public:
+    enum Pacing {
+        /** Frames are passed on with the timing of the recording */
+        PACING_REALTIME,
+
+        /** Frames are passed on as fast as they can be read */
+        PACING_AS_FAST_AS_POSSIBLE
+    };
+
+    /**
+     * Start of the replay, shared by all cameras of a session. While paused,
+     * the start is moved forward, so that the replay continues where it was
+     * paused.
+     */
+    class ReplayClock {
+        std::mutex mutex;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point pausedAt;
+        bool paused = false;
+
+    public:
+        std::chrono::steady_clock::time_point getStart(){
+            std::unique_lock l(mutex);
+            return start;
+        }
+
+        void pause(){
+            std::unique_lock l(mutex);
+            if(!paused)
+                pausedAt = std::chrono::steady_clock::now();
+            paused = true;
+        }
+
+        void resume(){
+            std::unique_lock l(mutex);
+            if(paused)
+                start += std::chrono::steady_clock::now() - pausedAt;
+            paused = false;
+        }
+    };
+
+private:
+    std::shared_ptr<RGBDRecordingReader> reader;
+    std::shared_ptr<ReplayClock> replayClock;
+    int streamIndex;
+    int deviceIndex;
+
+    Pacing pacing;
+    bool loop;
+
+    std::thread replayThread;
+    std::atomic<bool> running = false;
+
+    /** Recycles the per-frame arrays of this camera */
+    std::shared_ptr<FramePool> framePool = std::make_shared<FramePool>();
+
+    std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback;
+
+    void replay(){
+        const RGBDRecordingReader::Stream& stream = reader->getStream(streamIndex);
+        size_t frameCount = reader->getFrameCount(streamIndex);
+        uint64_t loopDurationUs = reader->getLastTimestampUs() - reader->getFirstTimestampUs() + 33333;
+
+        // When (re-)started later, continue in the loop iteration the other cameras are in:
+        size_t firstIteration = 0;
+        if(pacing == PACING_REALTIME && loop){
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - replayClock->getStart());
+            firstIteration = size_t(std::max<int64_t>(0, elapsed.count()) / loopDurationUs);
+        }
+
+        for(size_t iteration = firstIteration; running; ++iteration){
+            for(size_t frameIndex = 0; frameIndex < frameCount && running; ++frameIndex){
+                RGBDRecordingReader::Frame frame = reader->getFrame(streamIndex, frameIndex);
+
+                if(pacing == PACING_REALTIME){
+                    uint64_t replayTimeUs = frame.header->hostTimestampUs - reader->getFirstTimestampUs() + iteration * loopDurationUs;
+                    auto replayTime = replayClock->getStart() + std::chrono::microseconds(replayTimeUs);
+
+                    // Like a live camera, frames which are already too late are dropped:
+                    if(std::chrono::steady_clock::now() - replayTime > std::chrono::milliseconds(100))
+                        continue;
+
+                    std::this_thread::sleep_until(replayTime);
+                }
+
+                std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(stream.info.width, stream.info.height);
+                size_t pixelCount = size_t(stream.info.width) * stream.info.height;
+
+                pc->framePool = framePool;
+                pc->depth = framePool->acquire<uint16_t>(pixelCount);
+                pc->colors = framePool->acquire<Vec4b>(pixelCount);
+                pc->lookupImageTo3D = const_cast<float*>(stream.lookupImageTo3D);
+                pc->lookup3DToImage = const_cast<float*>(stream.lookup3DToImage);
+                pc->lookup3DToImageSize = stream.info.lookup3DToImageSize;
+                pc->modelMatrix = transformation;
+                pc->camera = this;
+                pc->usageFlags = stream.info.usageFlags;
+                pc->frameID = frame.header->frameID;
+                pc->timestamp = frame.header->deviceTimestamp;
+                pc->trace.stamp(LATENCY_SDK_ARRIVAL);
+
+                if(!decodeDepth(frame, pc->depth, pixelCount) || frame.header->colorBytes != pixelCount * sizeof(Vec4b)){
+                    std::cerr << "[RecordedCamera] Skipping corrupt frame " << frameIndex << " of " << getSerial() << std::endl;
+                    continue;
+                }
+                std::memcpy(pc->colors, frame.colors, frame.header->colorBytes);
+
+                if(frame.header->highResColorBytes > 0){
+                    pc->highResWidth = stream.info.highResWidth;
+                    pc->highResHeight = stream.info.highResHeight;
+                    pc->highResColors = framePool->acquire<uint8_t>(frame.header->highResColorBytes);
+                    std::memcpy(pc->highResColors, frame.highResColors, frame.header->highResColorBytes);
+                }
+
+                pointCloudCallback(deviceIndex, pc);
+            }
+
+            if(!loop || frameCount == 0)
+                break;
+        }
+        running = false;
+    }
+
+    bool decodeDepth(const RGBDRecordingReader::Frame& frame, uint16_t* depth, size_t pixelCount){
+        if(frame.header->depthEncoding == RGBD_RECORDING_DEPTH_RAW && frame.header->depthBytes == pixelCount * sizeof(uint16_t)){
+            std::memcpy(depth, frame.depth, frame.header->depthBytes);
+            return true;
+        }
+
+        if(frame.header->depthEncoding == RGBD_RECORDING_DEPTH_RVL)
+            return RVLDepthCodec::decode(frame.depth, frame.header->depthBytes, depth, pixelCount);
+
+        return false;
+    }
+
+public:
+    RecordedCamera(std::shared_ptr<RGBDRecordingReader> reader, std::shared_ptr<ReplayClock> replayClock, int streamIndex, int deviceIndex, std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback, Pacing pacing = PACING_REALTIME, bool loop = true)
+        : reader(reader)
+        , replayClock(replayClock)
+        , streamIndex(streamIndex)
+        , deviceIndex(deviceIndex)
+        , pacing(pacing)
+        , loop(loop)
+        , pointCloudCallback(pointCloudCallback)
+    {
+        transformation = Mat4f(reader->getStream(streamIndex).info.modelMatrix);
+    }
+
+    ~RecordedCamera(){
+        pause();
+    }
+
+    virtual std::string getSerial() override {
+        const RGBDRecordingStreamInfo& info = reader->getStream(streamIndex).info;
+        return std::string(info.serial, strnlen(info.serial, sizeof(info.serial)));
+    }
+
+    virtual std::shared_ptr<FramePool> getFramePool() override {
+        return framePool;
+    }
+
+    virtual int responsibilityFlags() override {
+        return reader->getStream(streamIndex).info.usageFlags;
+    }
+
+    virtual bool start() override {
+        return play();
+    }
+
+    virtual void stop() override {
+        pause();
+    }
+
+    virtual std::string type() override {
+        const RGBDRecordingStreamInfo& info = reader->getStream(streamIndex).info;
+        return "Recorded_" + std::string(info.cameraType, strnlen(info.cameraType, sizeof(info.cameraType)));
+    }
+
+    /** A recording has no IR projector, so this does nothing (the replay continues) */
+    virtual bool enableIRLight() override {
+        return false;
+    }
+
+    /** A recording has no IR projector, so this does nothing (the replay continues) */
+    virtual bool disableIRLight() override {
+        return false;
+    }
+
+    /**
+     * Starts (or continues) the replay. In realtime mode it continues at the
+     * position of the session's replay clock (where the session was paused).
+     */
+    bool play(){
+        if(running)
+            return false;
+
+        replayClock->resume();
+
+        if(replayThread.joinable())
+            replayThread.join();
+
+        running = true;
+        replayThread = std::thread(&RecordedCamera::replay, this);
+        return true;
+    }
+
+    /** Pauses the replay (and the replay clock of the session) */
+    bool pause(){
+        bool wasRunning = running;
+        running = false;
+        replayClock->pause();
+
+        if(replayThread.joinable())
+            replayThread.join();
+
+        return wasRunning;
+    }
+
+    bool isPlaying() const {
+        return running;
+    }
+};
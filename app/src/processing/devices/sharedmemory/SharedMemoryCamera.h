@@ -0,0 +1,131 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "src/processing/devices/RGBDCamera.h"
+#include "src/processing/devices/sharedmemory/SharedMemoryRing.h"
+
+/**
+ * Receives the point clouds of a camera of the capture daemon (started with
+ * --capture-daemon) through its shared memory ring. The depth and color
+ * arrays are used in place, nothing is copied in the renderer.
+ *
+ * The ring is polled by a thread of this camera. If the daemon stops writing,
+ * the ring is reopened by name from time to time, so the daemon can be
+ * restarted while the renderer keeps running (and vice versa).
+ */
+class SharedMemoryCamera : public RGBDCamera {
+    std::string ringName;
+    int deviceIndex;
+
+    /** Replaced when the daemon was restarted (guarded by ringMutex, point clouds keep the old one alive) */
+    std::shared_ptr<SharedMemoryRingReader> ring;
+    mutable std::mutex ringMutex;
+
+    std::thread receiveThread;
+    std::atomic<bool> running = false;
+
+    std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback;
+
+    /** Frames of the daemon are usually 33 ms apart, a much longer pause means it is gone */
+    static constexpr float STALE_RING_MS = 1000.f;
+
+    std::shared_ptr<SharedMemoryRingReader> getRing() const {
+        std::unique_lock lock(ringMutex);
+        return ring;
+    }
+
+    void receive(){
+        std::shared_ptr<SharedMemoryRingReader> currentRing = getRing();
+        uint64_t lastSequence = 0;
+        auto lastReopen = std::chrono::steady_clock::now();
+
+        while(running){
+            // Pick up a restarted daemon (which creates a new segment under the same name):
+            if((currentRing == nullptr || currentRing->getHeartbeatAgeMs() > STALE_RING_MS) && std::chrono::steady_clock::now() - lastReopen > std::chrono::seconds(1)){
+                lastReopen = std::chrono::steady_clock::now();
+
+                std::shared_ptr<SharedMemoryRingReader> reopened = SharedMemoryRingReader::open(ringName);
+                if(reopened != nullptr && (currentRing == nullptr || reopened->getHeader().producerId != currentRing->getHeader().producerId)){
+                    std::cout << "[SharedMemory] Reopened " << ringName << " (" << reopened->getSerial() << ")" << std::endl;
+                    currentRing = reopened;
+                    lastSequence = 0;
+
+                    std::unique_lock lock(ringMutex);
+                    ring = reopened;
+                }
+            }
+
+            std::shared_ptr<OrganizedPointCloud> pc = currentRing ? currentRing->acquireLatest(lastSequence) : nullptr;
+            if(pc == nullptr){
+                // There is no cross-process notification, the next frame is at most 0.5 ms late:
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+                continue;
+            }
+
+            pc->modelMatrix = transformation;
+            pc->camera = this;
+            pointCloudCallback(deviceIndex, pc);
+        }
+    }
+
+public:
+    SharedMemoryCamera(std::shared_ptr<SharedMemoryRingReader> ring, const std::string& ringName, int deviceIndex, std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback)
+        : ringName(ringName)
+        , deviceIndex(deviceIndex)
+        , ring(ring)
+        , pointCloudCallback(pointCloudCallback)
+    {}
+
+    ~SharedMemoryCamera(){
+        disableIRLight();
+    }
+
+    virtual std::string getSerial() override {
+        std::shared_ptr<SharedMemoryRingReader> currentRing = getRing();
+        return currentRing ? currentRing->getSerial() : ringName;
+    }
+
+    virtual int responsibilityFlags() override {
+        std::shared_ptr<SharedMemoryRingReader> currentRing = getRing();
+        return currentRing ? currentRing->getHeader().usageFlags : 0;
+    }
+
+    virtual std::string type() override {
+        std::shared_ptr<SharedMemoryRingReader> currentRing = getRing();
+        return "SharedMemory_" + (currentRing ? currentRing->getCameraType() : std::string("Unknown"));
+    }
+
+    virtual bool start() override {
+        return enableIRLight();
+    }
+
+    /** Starts receiving (the IR light of the camera is controlled by the daemon) */
+    virtual bool enableIRLight() override {
+        if(running)
+            return false;
+
+        if(receiveThread.joinable())
+            receiveThread.join();
+
+        running = true;
+        receiveThread = std::thread(&SharedMemoryCamera::receive, this);
+        return true;
+    }
+
+    /** Stops receiving */
+    virtual bool disableIRLight() override {
+        bool wasRunning = running;
+        running = false;
+
+        if(receiveThread.joinable())
+            receiveThread.join();
+
+        return wasRunning;
+    }
+};
@@ -0,0 +1,82 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "src/Data.h"
+#include "src/processing/devices/sharedmemory/SharedMemoryRing.h"
+
+/**
+ * Capture-only mode (started with --capture-daemon): runs the connected
+ * cameras without a window and writes their point clouds into one shared
+ * memory ring per device index. The renderer, started with --shared-memory,
+ * reads them with SharedMemoryCameras.
+ *
+ * This way, stalls of the camera SDK, the alignment and the color conversion
+ * happen in a different process than the rendering, and both processes can be
+ * restarted and profiled independently. Stops on SIGINT / SIGTERM.
+ */
+class SharedMemoryCaptureDaemon {
+    /** Each ring is only written by the camera thread of its device */
+    std::array<std::unique_ptr<SharedMemoryRingWriter>, MAX_RGBD_DEVICES> writers;
+
+    static std::atomic<bool>& stopRequested(){
+        static std::atomic<bool> stop = false;
+        return stop;
+    }
+
+    static void onSignal(int){
+        stopRequested() = true;
+    }
+
+public:
+    SharedMemoryCaptureDaemon(){
+        for(int deviceIndex = 0; deviceIndex < MAX_RGBD_DEVICES; ++deviceIndex)
+            writers[deviceIndex] = std::make_unique<SharedMemoryRingWriter>(sharedMemoryRingName(deviceIndex));
+    }
+
+    int run(){
+        // The transformations of the cameras are applied by the renderer:
+        RGBDCameraManager& cameraManager = Data::instance.cameraManager;
+
+        std::signal(SIGINT, &SharedMemoryCaptureDaemon::onSignal);
+        std::signal(SIGTERM, &SharedMemoryCaptureDaemon::onSignal);
+
+        cameraManager.registerCallback([this](int deviceIndex, std::shared_ptr<OrganizedPointCloud> pc){
+            if(deviceIndex < 0 || deviceIndex >= MAX_RGBD_DEVICES || pc == nullptr || pc->camera == nullptr)
+                return;
+
+            pc->trace.stamp(LATENCY_CALLBACK_DONE);
+            writers[deviceIndex]->write(*pc, pc->camera->getSerial(), pc->camera->type());
+        });
+
+        std::cout << "Capture daemon running with " << cameraManager.getCameras().size() << " cameras (stop with Ctrl+C)." << std::endl;
+
+        std::array<uint64_t, MAX_RGBD_DEVICES> lastWritten = {};
+        while(!stopRequested()){
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+
+            for(int deviceIndex = 0; deviceIndex < cameraManager.getDeviceCount(); ++deviceIndex){
+                uint64_t written = writers[deviceIndex]->getWrittenFrameCount();
+                double fps = (written - lastWritten[deviceIndex]) / 5.0;
+                std::cout << "Device " << deviceIndex << ": " << std::round(fps * 10.0) / 10.0 << " fps, "
+                          << written << " written, " << writers[deviceIndex]->getDroppedFrameCount() << " dropped" << std::endl;
+                lastWritten[deviceIndex] = written;
+            }
+        }
+
+        // The callback uses the rings, so no camera may deliver anymore:
+        cameraManager.stopCameras();
+
+        std::cout << "Capture daemon stopped." << std::endl;
+        return EXIT_SUCCESS;
+    }
+};
@@ -0,0 +1,434 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "src/SharedMemorySegment.h"
+#include "src/processing/OrganizedPointCloud.h"
+#include "src/processing/LatencyTracer.h"
+
+/**
+ * Layout of the shared memory ring buffer of one camera, through which the
+ * capture daemon (--capture-daemon) passes its point clouds to the renderer:
+ *
+ *   SharedMemoryRingHeader
+ *   lookupImageTo3D     (width x height x 2 floats)
+ *   lookup3DToImage     (lookup3DToImageSize^2 x 2 floats)
+ *   Slot*               (SharedMemoryRingSlot + depth + colors + high res colors)
+ *
+ * All sections are 64 byte aligned and have a fixed size, which is derived
+ * from the resolutions in the header. The lookup tables are written once
+ * (flagged in lookupFlags when complete), the slots are reused round robin.
+ *
+ * Each slot has a sequence number (SHARED_MEMORY_RING_WRITING while being
+ * written) and a count of the readers which currently use its arrays in place.
+ * The writer never overwrites the latest slot or a slot with readers, it drops
+ * the frame if there is none left. A reader pins a slot and checks the
+ * sequence number afterwards, so a slot which the writer started to overwrite
+ * in between is never used.
+ */
+
+#define SHARED_MEMORY_RING_MAGIC 0x31524D5344424752ull // "RGBDSMR1"
+#define SHARED_MEMORY_RING_VERSION 1
+
+/** Number of slots (the renderer holds up to ~8 frames per camera: mailbox + frame synchronizer) */
+#define SHARED_MEMORY_RING_SLOTS 12
+
+#define SHARED_MEMORY_RING_WRITING 1
+
+enum SharedMemoryRingLookupFlags : uint32_t {
+    SHARED_MEMORY_RING_LOOKUP_IMAGE_TO_3D = 1,
+    SHARED_MEMORY_RING_LOOKUP_3D_TO_IMAGE = 2
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "Shared memory requires address-free atomics");
+
+struct SharedMemoryRingHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+
+    /** Differs for every start of the capture daemon */
+    uint64_t producerId;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t highResWidth;
+    uint32_t highResHeight;
+    uint32_t lookup3DToImageSize;
+    int32_t usageFlags;
+
+    char serial[64];
+    char cameraType[32];
+
+    uint64_t lookupImageTo3DOffset;
+    uint64_t lookup3DToImageOffset;
+    uint64_t slotsOffset;
+    uint64_t slotStride;
+
+    /** SharedMemoryRingLookupFlags of the completely written lookup tables */
+    std::atomic<uint32_t> lookupFlags;
+
+    /** Sequence number of the latest frame << 8 | its slot (0: none yet) */
+    std::atomic<uint64_t> latest;
+
+    /** Time of the last written frame (FrameTrace::nowUs) */
+    std::atomic<int64_t> heartbeatUs;
+
+    std::atomic<uint64_t> writtenFrames;
+
+    /** Frames dropped because every slot was in use by the reader */
+    std::atomic<uint64_t> droppedFrames;
+};
+
+struct SharedMemoryRingSlot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint32_t> readers;
+    uint32_t hasHighResColors;
+
+    int32_t frameID;
+    double timestamp;
+    int64_t stageUs[LATENCY_STAGE_COUNT];
+};
+
+/** Offsets and sizes of the sections for given resolutions */
+struct SharedMemoryRingLayout {
+    uint64_t lookupImageTo3DOffset = 0;
+    uint64_t lookup3DToImageOffset = 0;
+    uint64_t slotsOffset = 0;
+    uint64_t slotStride = 0;
+
+    uint64_t depthOffset = 0;
+    uint64_t colorsOffset = 0;
+    uint64_t highResColorsOffset = 0;
+
+    uint64_t totalSize = 0;
+
+    static uint64_t align(uint64_t size){
+        return (size + 63) & ~uint64_t(63);
+    }
+
+    SharedMemoryRingLayout(uint32_t width, uint32_t height, uint32_t highResWidth, uint32_t highResHeight, uint32_t lookup3DToImageSize){
+        const uint64_t pixelCount = uint64_t(width) * height;
+
+        lookupImageTo3DOffset = align(sizeof(SharedMemoryRingHeader));
+        lookup3DToImageOffset = lookupImageTo3DOffset + align(pixelCount * 2 * sizeof(float));
+        slotsOffset = lookup3DToImageOffset + align(uint64_t(lookup3DToImageSize) * lookup3DToImageSize * 2 * sizeof(float));
+
+        // Relative to the slot:
+        depthOffset = align(sizeof(SharedMemoryRingSlot));
+        colorsOffset = depthOffset + align(pixelCount * sizeof(uint16_t));
+        highResColorsOffset = colorsOffset + align(pixelCount * sizeof(Vec4b));
+        slotStride = highResColorsOffset + align(uint64_t(highResWidth) * highResHeight * 3);
+
+        totalSize = slotsOffset + slotStride * SHARED_MEMORY_RING_SLOTS;
+    }
+};
+
+/** Name of the ring of a device index */
+inline std::string sharedMemoryRingName(int deviceIndex){
+    return "blendpcr_rgbd_" + std::to_string(deviceIndex);
+}
+
+/**
+ * Writes the point clouds of one camera into its ring (capture daemon side).
+ * Must only be used by one thread at a time (the camera thread).
+ */
+class SharedMemoryRingWriter {
+    std::string name;
+    SharedMemorySegment segment;
+    SharedMemoryRingHeader* header = nullptr;
+    uint64_t sequence = 0;
+    uint32_t lastSlot = 0;
+
+    const float* writtenLookupImageTo3D = nullptr;
+    const float* writtenLookup3DToImage = nullptr;
+
+    /** Also counted here, since the segment may be replaced while other threads read them */
+    std::atomic<uint64_t> writtenFrames = 0;
+    std::atomic<uint64_t> droppedFrames = 0;
+
+    SharedMemoryRingSlot* slot(uint32_t index){
+        return reinterpret_cast<SharedMemoryRingSlot*>(segment.data() + header->slotsOffset + header->slotStride * index);
+    }
+
+    /** (Re)creates the segment for the resolutions of the point cloud */
+    bool ensureSegment(const OrganizedPointCloud& pc, uint32_t highResWidth, uint32_t highResHeight, const std::string& serial, const std::string& cameraType){
+        if(header != nullptr && header->width == pc.width && header->height == pc.height && header->highResWidth == highResWidth
+                && header->highResHeight == highResHeight && header->lookup3DToImageSize == pc.lookup3DToImageSize)
+            return true;
+
+        header = nullptr;
+        SharedMemoryRingLayout layout(pc.width, pc.height, highResWidth, highResHeight, pc.lookup3DToImageSize);
+        if(!segment.create(name, layout.totalSize))
+            return false;
+
+        std::cout << "[SharedMemory] Created " << name << " for " << serial << " (" << pc.width << " x " << pc.height << ", "
+                  << layout.totalSize / (1024 * 1024) << " MB)" << std::endl;
+
+        // The segment is zero-initialized, so all slots are free and the lookup tables not written:
+        SharedMemoryRingHeader* newHeader = reinterpret_cast<SharedMemoryRingHeader*>(segment.data());
+        newHeader->version = SHARED_MEMORY_RING_VERSION;
+        newHeader->slotCount = SHARED_MEMORY_RING_SLOTS;
+        newHeader->producerId = uint64_t(std::chrono::system_clock::now().time_since_epoch().count());
+        newHeader->width = pc.width;
+        newHeader->height = pc.height;
+        newHeader->highResWidth = highResWidth;
+        newHeader->highResHeight = highResHeight;
+        newHeader->lookup3DToImageSize = pc.lookup3DToImageSize;
+        newHeader->usageFlags = pc.usageFlags;
+        std::strncpy(newHeader->serial, serial.c_str(), sizeof(newHeader->serial) - 1);
+        std::strncpy(newHeader->cameraType, cameraType.c_str(), sizeof(newHeader->cameraType) - 1);
+        newHeader->lookupImageTo3DOffset = layout.lookupImageTo3DOffset;
+        newHeader->lookup3DToImageOffset = layout.lookup3DToImageOffset;
+        newHeader->slotsOffset = layout.slotsOffset;
+        newHeader->slotStride = layout.slotStride;
+
+        // Readers only accept the segment once the magic is there:
+        std::atomic_thread_fence(std::memory_order_release);
+        newHeader->magic = SHARED_MEMORY_RING_MAGIC;
+
+        header = newHeader;
+        sequence = 0;
+        lastSlot = 0;
+        writtenLookupImageTo3D = nullptr;
+        writtenLookup3DToImage = nullptr;
+        return true;
+    }
+
+    void writeLookupTables(const OrganizedPointCloud& pc){
+        // The tables of a camera don't change, but lookup3DToImage may arrive some frames later:
+        uint32_t flags = header->lookupFlags.load(std::memory_order_relaxed);
+        if(pc.lookupImageTo3D != nullptr && pc.lookupImageTo3D != writtenLookupImageTo3D){
+            std::memcpy(segment.data() + header->lookupImageTo3DOffset, pc.lookupImageTo3D, size_t(pc.width) * pc.height * 2 * sizeof(float));
+            writtenLookupImageTo3D = pc.lookupImageTo3D;
+            flags |= SHARED_MEMORY_RING_LOOKUP_IMAGE_TO_3D;
+        }
+        if(pc.lookup3DToImage != nullptr && pc.lookup3DToImage != writtenLookup3DToImage){
+            std::memcpy(segment.data() + header->lookup3DToImageOffset, pc.lookup3DToImage, size_t(pc.lookup3DToImageSize) * pc.lookup3DToImageSize * 2 * sizeof(float));
+            writtenLookup3DToImage = pc.lookup3DToImage;
+            flags |= SHARED_MEMORY_RING_LOOKUP_3D_TO_IMAGE;
+        }
+        header->lookupFlags.store(flags, std::memory_order_release);
+    }
+
+    /** Returns a slot which is neither the latest one nor in use by the reader and marks it as being written */
+    bool lockFreeSlot(uint32_t& slotIndex){
+        for(uint32_t i = 1; i <= header->slotCount; ++i){
+            uint32_t candidate = (lastSlot + i) % header->slotCount;
+            if(sequence > 0 && candidate == lastSlot)
+                continue;
+
+            SharedMemoryRingSlot* candidateSlot = slot(candidate);
+            if(candidateSlot->readers.load() != 0)
+                continue;
+
+            // A reader which pins the slot now sees the writing mark, otherwise we see its pin:
+            uint64_t previousSequence = candidateSlot->sequence.exchange(SHARED_MEMORY_RING_WRITING);
+            if(candidateSlot->readers.load() != 0){
+                candidateSlot->sequence.store(previousSequence);
+                continue;
+            }
+
+            slotIndex = candidate;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    SharedMemoryRingWriter(const std::string& name)
+        : name(name)
+    {}
+
+    uint64_t getWrittenFrameCount() const {
+        return writtenFrames.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getDroppedFrameCount() const {
+        return droppedFrames.load(std::memory_order_relaxed);
+    }
+
+    /** Copies the point cloud into the next free slot. Returns false if it was dropped. */
+    bool write(const OrganizedPointCloud& pc, const std::string& serial, const std::string& cameraType){
+        if(pc.depth == nullptr || pc.colors == nullptr)
+            return false;
+
+        uint32_t highResWidth = pc.highResColors ? uint32_t(pc.highResWidth) : 0;
+        uint32_t highResHeight = pc.highResColors ? uint32_t(pc.highResHeight) : 0;
+        if(!ensureSegment(pc, highResWidth, highResHeight, serial, cameraType))
+            return false;
+
+        writeLookupTables(pc);
+
+        uint32_t slotIndex;
+        if(!lockFreeSlot(slotIndex)){
+            header->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        SharedMemoryRingLayout layout(header->width, header->height, highResWidth, highResHeight, header->lookup3DToImageSize);
+        SharedMemoryRingSlot* target = slot(slotIndex);
+        uint8_t* slotData = reinterpret_cast<uint8_t*>(target);
+        const size_t pixelCount = size_t(pc.width) * pc.height;
+
+        target->frameID = pc.frameID;
+        target->timestamp = pc.timestamp;
+        target->hasHighResColors = highResWidth > 0;
+        std::memcpy(target->stageUs, pc.trace.stageUs, sizeof(target->stageUs));
+
+        std::memcpy(slotData + layout.depthOffset, pc.depth, pixelCount * sizeof(uint16_t));
+        std::memcpy(slotData + layout.colorsOffset, pc.colors, pixelCount * sizeof(Vec4b));
+        if(highResWidth > 0)
+            std::memcpy(slotData + layout.highResColorsOffset, pc.highResColors, size_t(highResWidth) * highResHeight * 3);
+
+        // Sequence numbers are even and > 0 (SHARED_MEMORY_RING_WRITING is odd):
+        sequence += 2;
+        target->sequence.store(sequence, std::memory_order_release);
+        header->latest.store(sequence << 8 | slotIndex, std::memory_order_release);
+        header->heartbeatUs.store(FrameTrace::nowUs(), std::memory_order_relaxed);
+        header->writtenFrames.fetch_add(1, std::memory_order_relaxed);
+        writtenFrames.fetch_add(1, std::memory_order_relaxed);
+
+        lastSlot = slotIndex;
+        return true;
+    }
+};
+
+/**
+ * Reads the point clouds of one camera from its ring (renderer side). The
+ * returned point clouds use the arrays of the ring in place; the slot stays
+ * pinned (and the segment mapped) until the point cloud is destroyed.
+ */
+class SharedMemoryRingReader : public std::enable_shared_from_this<SharedMemoryRingReader> {
+    SharedMemorySegment segment;
+    SharedMemoryRingHeader* header = nullptr;
+
+    /**
+     * Returns true only for the first attach of this process to a producer.
+     * Pins which exist then were left by a previous renderer process, later
+     * (re)opens of the same segment must keep the pins of our own frames.
+     */
+    static bool isFirstAttach(uint64_t producerId){
+        static std::mutex mutex;
+        static std::set<uint64_t> attachedProducers;
+
+        std::unique_lock lock(mutex);
+        return attachedProducers.insert(producerId).second;
+    }
+
+    /** Releases a pin, never below 0 (in case it was cleared in between by another process) */
+    static void unpin(SharedMemoryRingSlot* slot){
+        uint32_t readers = slot->readers.load();
+        while(readers > 0 && !slot->readers.compare_exchange_weak(readers, readers - 1));
+    }
+
+public:
+    /** Opens the ring with the given name. Returns nullptr if there is no (valid) one. */
+    static std::shared_ptr<SharedMemoryRingReader> open(const std::string& name){
+        std::shared_ptr<SharedMemoryRingReader> reader = std::make_shared<SharedMemoryRingReader>();
+        if(!reader->segment.open(name) || reader->segment.size() < sizeof(SharedMemoryRingHeader))
+            return nullptr;
+
+        SharedMemoryRingHeader* header = reinterpret_cast<SharedMemoryRingHeader*>(reader->segment.data());
+        if(header->magic != SHARED_MEMORY_RING_MAGIC || header->version != SHARED_MEMORY_RING_VERSION)
+            return nullptr;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        SharedMemoryRingLayout layout(header->width, header->height, header->highResWidth, header->highResHeight, header->lookup3DToImageSize);
+        if(reader->segment.size() < layout.totalSize || header->slotStride != layout.slotStride)
+            return nullptr;
+
+        // Pins of a previous renderer process which did not release them (e.g. it crashed):
+        if(isFirstAttach(header->producerId)){
+            for(uint32_t i = 0; i < header->slotCount; ++i)
+                reinterpret_cast<SharedMemoryRingSlot*>(reader->segment.data() + header->slotsOffset + header->slotStride * i)->readers.store(0);
+        }
+
+        reader->header = header;
+        return reader;
+    }
+
+    const SharedMemoryRingHeader& getHeader() const {
+        return *header;
+    }
+
+    std::string getSerial() const {
+        return std::string(header->serial, strnlen(header->serial, sizeof(header->serial)));
+    }
+
+    std::string getCameraType() const {
+        return std::string(header->cameraType, strnlen(header->cameraType, sizeof(header->cameraType)));
+    }
+
+    /** Milliseconds since the daemon wrote the last frame */
+    float getHeartbeatAgeMs() const {
+        return float(FrameTrace::nowUs() - header->heartbeatUs.load(std::memory_order_relaxed)) / 1000.f;
+    }
+
+    /**
+     * Returns the latest frame if it is newer than lastSequence (which is
+     * updated), nullptr otherwise. Only the model matrix and the camera are
+     * left to the caller.
+     */
+    std::shared_ptr<OrganizedPointCloud> acquireLatest(uint64_t& lastSequence){
+        uint64_t latest = header->latest.load(std::memory_order_acquire);
+        uint64_t sequence = latest >> 8;
+        uint32_t slotIndex = uint32_t(latest & 0xFF);
+        if(sequence == 0 || sequence == lastSequence || slotIndex >= header->slotCount)
+            return nullptr;
+
+        uint8_t* slotData = segment.data() + header->slotsOffset + header->slotStride * slotIndex;
+        SharedMemoryRingSlot* slot = reinterpret_cast<SharedMemoryRingSlot*>(slotData);
+
+        // Pin first, then check that the writer did not start to overwrite the slot in between:
+        slot->readers.fetch_add(1);
+        if(slot->sequence.load() != sequence){
+            unpin(slot);
+            return nullptr;
+        }
+        lastSequence = sequence;
+
+        // The arrays belong to the ring, so they are detached before the point cloud is deleted:
+        std::shared_ptr<SharedMemoryRingReader> self = shared_from_this();
+        std::shared_ptr<OrganizedPointCloud> pc(new OrganizedPointCloud(header->width, header->height), [self, slot](OrganizedPointCloud* pc){
+            pc->depth = nullptr;
+            pc->colors = nullptr;
+            pc->highResColors = nullptr;
+            delete pc;
+            unpin(slot);
+        });
+
+        SharedMemoryRingLayout layout(header->width, header->height, header->highResWidth, header->highResHeight, header->lookup3DToImageSize);
+        pc->depth = reinterpret_cast<uint16_t*>(slotData + layout.depthOffset);
+        pc->colors = reinterpret_cast<Vec4b*>(slotData + layout.colorsOffset);
+        if(slot->hasHighResColors){
+            pc->highResColors = slotData + layout.highResColorsOffset;
+            pc->highResWidth = int(header->highResWidth);
+            pc->highResHeight = int(header->highResHeight);
+        }
+
+        uint32_t lookupFlags = header->lookupFlags.load(std::memory_order_acquire);
+        if(lookupFlags & SHARED_MEMORY_RING_LOOKUP_IMAGE_TO_3D)
+            pc->lookupImageTo3D = reinterpret_cast<float*>(segment.data() + header->lookupImageTo3DOffset);
+        if(lookupFlags & SHARED_MEMORY_RING_LOOKUP_3D_TO_IMAGE)
+            pc->lookup3DToImage = reinterpret_cast<float*>(segment.data() + header->lookup3DToImageOffset);
+        pc->lookup3DToImageSize = header->lookup3DToImageSize;
+
+        pc->usageFlags = header->usageFlags;
+        pc->frameID = slot->frameID;
+        pc->timestamp = slot->timestamp;
+        std::memcpy(pc->trace.stageUs, slot->stageUs, sizeof(pc->trace.stageUs));
+        return pc;
+    }
+};
@@ -0,0 +1,167 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "src/processing/OrganizedPointCloud.h"
+#include "src/simulation/raycast/RaycastScene.h"
+#include "src/WorkerPool.h"
+
+/**
+ * Simulated RGBD camera which raycasts a RaycastScene on the CPU instead of
+ * rendering and reading back the scene like VirtualRGBDCamera.
+ *
+ * It has the same resolution, field of view and lookup tables as
+ * VirtualRGBDCamera and the same noise model as rgbdSndPass.frag (the normal
+ * is the exact geometric normal of the hit instead of the one estimated from
+ * neighboring depth values). Colors are the flat instance colors with a
+ * simple headlight shading, since textures and projector light are not
+ * available on the CPU.
+ */
+class RaycastRGBDCamera {
+    std::shared_ptr<FramePool> framePool = std::make_shared<FramePool>();
+
+    float* lookupImageTo3D = nullptr;
+    float* lookup3DToImage = nullptr;
+
+    int frameCounter = 0;
+
+    /** Same clear color as the first pass of VirtualRGBDCamera */
+    const Vec4f backgroundColor = Vec4f(0.6f, 0.725f, 0.8f, 1.f);
+
+    /** Noise model of rgbdSndPass.frag */
+    const float noiseMagnitude = 0.02f;
+    const float maxDistance = 10.f;
+
+    /** White noise in [0, 1] per pixel and frame (replaces the noise texture) */
+    static inline float random(uint32_t x, uint32_t y, uint32_t frame, uint32_t channel){
+        uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ frame * 0xcb1ab31fu ^ channel * 0x165667b1u;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return (h >> 8) * (1.f / 16777216.f);
+    }
+
+    /** Same byte order as the GL_BGRA readback of VirtualRGBDCamera */
+    static inline Vec4b toBGRA(Vec4f color){
+        auto channel = [](float c){ return uint8_t(std::clamp(c, 0.f, 1.f) * 255.f + 0.5f); };
+        return Vec4b(channel(color.z), channel(color.y), channel(color.x), 255);
+    }
+
+public:
+    const int width = 640;
+    const int height = 576;
+
+    const float horizontalFOV = 75.0f;
+    const float verticalFOV = 65.0f;
+
+    const int lookup3DToImageSize = 1024;
+
+    RaycastRGBDCamera(){
+        float tanHalfFovX = std::tan(horizontalFOV / 2.f / 180.f * M_PI);
+        float tanHalfFovY = std::tan(verticalFOV / 2.f / 180.f * M_PI);
+
+        lookupImageTo3D = new float[width * height * 2];
+        for(int y = 0; y < height; ++y){
+            for(int x = 0; x < width; ++x){
+                int i = y * width + x;
+                lookupImageTo3D[i*2] = tanHalfFovX * ((x / float(width-1)) * 2.f - 1.f);
+                lookupImageTo3D[i*2+1] = tanHalfFovY * ((y / float(height-1)) * 2.f - 1.f);
+            }
+        }
+
+        lookup3DToImage = new float[lookup3DToImageSize * lookup3DToImageSize * 2];
+        for(int y = 0; y < lookup3DToImageSize; ++y){
+            for(int x = 0; x < lookup3DToImageSize; ++x){
+                float relX = x / float(lookup3DToImageSize - 1) * 2 - 1;
+                float relY = y / float(lookup3DToImageSize - 1) * 2 - 1;
+
+                int idx = (y * lookup3DToImageSize + x) * 2;
+                lookup3DToImage[idx] = ((relX / tanHalfFovX) + 1) * 0.5f * (width - 1);
+                lookup3DToImage[idx+1] = ((relY / tanHalfFovY) + 1) * 0.5f * (height - 1);
+            }
+        }
+    }
+
+    ~RaycastRGBDCamera(){
+        delete[] lookupImageTo3D;
+        delete[] lookup3DToImage;
+    }
+
+    RaycastRGBDCamera(const RaycastRGBDCamera&) = delete;
+    RaycastRGBDCamera& operator=(const RaycastRGBDCamera&) = delete;
+
+    std::shared_ptr<FramePool> getFramePool(){
+        return framePool;
+    }
+
+    /**
+     * Raycasts the scene from the camera at modelMatrix (camera looks along +z
+     * in its local space, like VirtualRGBDCamera) on the worker pool.
+     */
+    std::shared_ptr<OrganizedPointCloud> render(const RaycastScene& scene, const Mat4f& modelMatrix, bool simulateNoise){
+        FrameTrace trace;
+        trace.stamp(LATENCY_SDK_ARRIVAL);
+
+        const size_t size = size_t(width) * height;
+        std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+        pc->framePool = framePool;
+        pc->depth = framePool->acquire<uint16_t>(size);
+        pc->colors = framePool->acquire<Vec4b>(size);
+        pc->lookupImageTo3D = lookupImageTo3D;
+        pc->lookup3DToImage = lookup3DToImage;
+        pc->lookup3DToImageSize = lookup3DToImageSize;
+        pc->modelMatrix = modelMatrix;
+        pc->usageFlags = CAMERA_RESPONSIBILITY_GESTURES | CAMERA_RESPONSIBILITY_OCCLUSION | CAMERA_RESPONSIBILITY_RECTIFICATION;
+        pc->frameID = frameCounter;
+        pc->trace = trace;
+
+        const uint32_t frame = uint32_t(frameCounter++);
+        const Vec4f origin = modelMatrix.getPosition();
+        const Vec4b background = toBGRA(backgroundColor);
+        uint16_t* depth = pc->depth;
+        Vec4b* colors = pc->colors;
+
+        WorkerPool::getInstance().parallelForChunks(0, height, 8, [&](int rowBegin, int rowEnd){
+            Mat4f model = modelMatrix;
+            for(int y = rowBegin; y < rowEnd; ++y){
+                for(int x = 0; x < width; ++x){
+                    const int i = y * width + x;
+                    const float rayX = lookupImageTo3D[i*2];
+                    const float rayY = lookupImageTo3D[i*2+1];
+
+                    // Ray with z = 1 in camera space, so t is the view space depth:
+                    Vec4f direction = model * Vec4f(rayX, rayY, 1.f, 0.f);
+
+                    RaycastScene::Hit hit;
+                    if(!scene.intersect(origin, direction, maxDistance, hit)){
+                        depth[i] = 0;
+                        colors[i] = background;
+                        continue;
+                    }
+
+                    float z = hit.t;
+                    float rayLength = std::sqrt(rayX * rayX + rayY * rayY + 1.f);
+                    float cosAngle = std::abs(hit.normal.dot(direction)) / direction.length();
+
+                    if(simulateNoise){
+                        // Offset along the ray, growing with the angle to the surface:
+                        float noise = random(x, y, frame, 0) * 2.f - 1.f;
+                        z -= noise * noiseMagnitude * (1.f - cosAngle) * 0.5f / rayLength;
+                    }
+
+                    depth[i] = uint16_t(std::ceil(z * 1000.f));
+                    colors[i] = toBGRA(hit.color * (0.3f + 0.7f * cosAngle));
+                }
+            }
+        });
+
+        return pc;
+    }
+};
@@ -0,0 +1,112 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/simulation/raycast/RaycastRGBDCamera.h"
+#include "src/simulation/raycast/RaycastScene.h"
+
+/**
+ * Produces the simulated RGBD data of all virtual cameras on its own thread
+ * by raycasting (see RaycastRGBDCamera), so the render thread neither renders
+ * the scene per camera nor waits for a texture readback.
+ *
+ * The render thread only hands over a snapshot of the scene and the camera
+ * poses every frame with update(). The point clouds are passed to the
+ * callback (index = index of the active camera, like the rasterized path).
+ */
+class RaycastRGBDSimulator {
+public:
+    struct Settings {
+        RaycastScene scene;
+
+        /** Model matrix of every active camera */
+        std::vector<Mat4f> cameraPoses;
+
+        bool simulateNoise = false;
+    };
+
+private:
+    std::thread thread;
+    std::atomic<bool> running = false;
+
+    std::mutex settingsMutex;
+    Settings settings;
+
+    std::vector<std::unique_ptr<RaycastRGBDCamera>> cameras;
+
+    std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> callback;
+
+    std::atomic<float> lastFrameMs = 0.f;
+
+    void loop(){
+        using Clock = std::chrono::steady_clock;
+
+        while(running){
+            Clock::time_point frameStart = Clock::now();
+
+            Settings current;
+            {
+                std::unique_lock lock(settingsMutex);
+                current = settings;
+            }
+
+            while(cameras.size() < current.cameraPoses.size())
+                cameras.push_back(std::make_unique<RaycastRGBDCamera>());
+
+            for(size_t i = 0; i < current.cameraPoses.size(); ++i)
+                callback(int(i), cameras[i]->render(current.scene, current.cameraPoses[i], current.simulateNoise));
+
+            lastFrameMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+
+            std::this_thread::sleep_until(frameStart + std::chrono::microseconds(int64_t(1000000.f / std::max(1.f, targetFps.load()))));
+        }
+    }
+
+public:
+    /** Frames per second the cameras deliver (if raycasting is fast enough) */
+    std::atomic<float> targetFps = 30.f;
+
+    ~RaycastRGBDSimulator(){
+        stop();
+    }
+
+    /** Hands over the scene and camera poses for the next frames (render thread) */
+    void update(const Settings& newSettings){
+        std::unique_lock lock(settingsMutex);
+        settings = newSettings;
+    }
+
+    /** Starts the simulation thread, which passes every point cloud to the callback */
+    void start(std::function<void(int, std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback){
+        if(running)
+            return;
+
+        callback = pointCloudCallback;
+        running = true;
+        thread = std::thread(&RaycastRGBDSimulator::loop, this);
+    }
+
+    /** Stops the thread; no callback is called after this returns */
+    void stop(){
+        running = false;
+        if(thread.joinable())
+            thread.join();
+    }
+
+    bool isRunning() const {
+        return running;
+    }
+
+    /** Duration of the last frame (all cameras) in ms */
+    float getLastFrameMs() const {
+        return lastFrameMs;
+    }
+};
@@ -0,0 +1,155 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/math/Mat4.h"
+#include "src/math/Vec4.h"
+#include "src/gl/primitive/Triangle.h"
+#include "src/simulation/raycast/TriangleBVH.h"
+
+// Implementation is compiled in Mesh.cpp (or by the including tool):
+#include "src/tiny_obj_loader/tiny_obj_loader.h"
+
+/**
+ * The geometry of the scene as seen by the CPU raycaster: a list of mesh
+ * instances, each with its (shared, immutable) BVH in object space, a model
+ * matrix and a flat color.
+ *
+ * Copying a scene is cheap (the BVHs are shared), so the render thread can
+ * hand a snapshot with updated model matrices to the raycasting thread. No
+ * OpenGL is involved, so the raycaster also works headless.
+ */
+class RaycastScene {
+public:
+    struct Instance {
+        std::shared_ptr<const TriangleBVH> bvh;
+
+        /** Geometric normal of every triangle (object space) */
+        std::shared_ptr<const std::vector<Vec4f>> normals;
+
+        Mat4f modelMatrix;
+        Mat4f inverseModelMatrix;
+
+        /** RGB in [0, 1] */
+        Vec4f color = Vec4f(0.8f, 0.8f, 0.8f, 1.f);
+
+        bool visible = true;
+    };
+
+    struct Hit {
+        /** Ray parameter (in units of the given direction) */
+        float t = 0.f;
+
+        /** Normalized world space normal */
+        Vec4f normal;
+
+        Vec4f color;
+    };
+
+    std::vector<Instance> instances;
+
+    /** Adds a mesh (triangles in object space) and returns the instance index */
+    int addMesh(const std::vector<Triangle>& triangles, Vec4f color = Vec4f(0.8f, 0.8f, 0.8f, 1.f), Mat4f modelMatrix = Mat4f()){
+        std::shared_ptr<std::vector<Vec4f>> normals = std::make_shared<std::vector<Vec4f>>();
+        normals->reserve(triangles.size());
+        for(const Triangle& triangle : triangles){
+            Vec4f normal = (triangle.b.position - triangle.a.position).cross(triangle.c.position - triangle.a.position);
+            normals->push_back(normal.length() > 0.f ? normal.normalized() : Vec4f(0.f, 0.f, 1.f, 0.f));
+        }
+
+        Instance instance;
+        instance.bvh = std::make_shared<TriangleBVH>(triangles);
+        instance.normals = normals;
+        instance.color = color;
+        instances.push_back(instance);
+
+        setModelMatrix(int(instances.size()) - 1, modelMatrix);
+        return int(instances.size()) - 1;
+    }
+
+    /** Loads the positions of an .obj file (without OpenGL) and adds it, returns -1 on failure */
+    int addObj(const std::string& filepath, Vec4f color = Vec4f(0.8f, 0.8f, 0.8f, 1.f), Mat4f modelMatrix = Mat4f()){
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+
+        std::string directory = filepath.substr(0, filepath.find_last_of("/\\"));
+        if(!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str(), directory.c_str())){
+            std::cerr << "Obj-file " << filepath << " could not be loaded for raycasting: " << err << std::endl;
+            return -1;
+        }
+
+        std::vector<Triangle> triangles;
+        for(const tinyobj::shape_t& shape : shapes){
+            size_t indexOffset = 0;
+            for(unsigned char faceVertices : shape.mesh.num_face_vertices){
+                // Faces are triangulated by the loader:
+                if(faceVertices == 3){
+                    Triangle triangle;
+                    for(int v = 0; v < 3; ++v){
+                        tinyobj::index_t index = shape.mesh.indices[indexOffset + v];
+                        const float* position = &attrib.vertices[3 * size_t(index.vertex_index)];
+                        triangle[v].position = Vec4f(position[0], position[1], position[2], 1.f);
+                    }
+                    triangles.push_back(triangle);
+                }
+                indexOffset += faceVertices;
+            }
+        }
+
+        return addMesh(triangles, color, modelMatrix);
+    }
+
+    void setModelMatrix(int instance, Mat4f modelMatrix){
+        instances[instance].modelMatrix = modelMatrix;
+        instances[instance].inverseModelMatrix = modelMatrix.inverse();
+    }
+
+    /** Finds the closest hit of origin + t * direction (world space) with t in (0, maxT) */
+    bool intersect(Vec4f origin, Vec4f direction, float maxT, Hit& hit) const {
+        const Instance* hitInstance = nullptr;
+        int hitTriangle = -1;
+
+        for(const Instance& instance : instances){
+            if(!instance.visible)
+                continue;
+
+            // Transform the ray into object space (keeps t, since the direction is not normalized):
+            Vec4f localOrigin = instance.inverseModelMatrix * Vec4f(origin.x, origin.y, origin.z, 1.f);
+            Vec4f localDirection = instance.inverseModelMatrix * Vec4f(direction.x, direction.y, direction.z, 0.f);
+            float o[3] = {localOrigin.x, localOrigin.y, localOrigin.z};
+            float d[3] = {localDirection.x, localDirection.y, localDirection.z};
+
+            TriangleBVH::Hit localHit;
+            if(instance.bvh->intersect(o, d, maxT, localHit)){
+                maxT = localHit.t;
+                hitInstance = &instance;
+                hitTriangle = localHit.triangle;
+            }
+        }
+
+        if(hitInstance == nullptr)
+            return false;
+
+        // Normals transform with the inverse transpose:
+        const Vec4f& n = (*hitInstance->normals)[hitTriangle];
+        const float* inverse = hitInstance->inverseModelMatrix.data;
+        Vec4f normal(
+            inverse[0] * n.x + inverse[1] * n.y + inverse[2] * n.z,
+            inverse[4] * n.x + inverse[5] * n.y + inverse[6] * n.z,
+            inverse[8] * n.x + inverse[9] * n.y + inverse[10] * n.z,
+            0.f);
+
+        hit.t = maxT;
+        hit.normal = normal.normalized();
+        hit.color = hitInstance->color;
+        return true;
+    }
+};
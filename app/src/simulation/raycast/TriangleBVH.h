@@ -0,0 +1,328 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "src/gl/primitive/Triangle.h"
+
+/**
+ * Bounding volume hierarchy over a static triangle mesh for CPU raycasting.
+ *
+ * The tree is built once with a binned surface area heuristic. Nodes and
+ * triangles are stored in flat arrays (triangles as vertex + two edges, ready
+ * for the Möller-Trumbore test), so intersect() is allocation-free and can be
+ * called from any number of threads at once.
+ */
+class TriangleBVH {
+public:
+    struct Hit {
+        float t = std::numeric_limits<float>::infinity();
+
+        /** Index of the triangle in the list given to the constructor */
+        int triangle = -1;
+
+        /** Barycentric coordinates of the hit (weights of vertex b and c) */
+        float u = 0.f, v = 0.f;
+    };
+
+private:
+    struct Node {
+        float boundsMin[3];
+
+        /** Leaf: index of the first triangle, inner node: index of the left child (right = left + 1) */
+        int32_t leftOrFirst;
+
+        float boundsMax[3];
+
+        /** Number of triangles (leaf), 0 for inner nodes */
+        int32_t count;
+    };
+
+    struct PreparedTriangle {
+        float v0[3];
+        float edge1[3];
+        float edge2[3];
+    };
+
+    struct BuildTriangle {
+        float boundsMin[3];
+        float boundsMax[3];
+        float centroid[3];
+        int index;
+    };
+
+    static constexpr int BIN_COUNT = 12;
+    static constexpr int MAX_LEAF_SIZE = 4;
+    static constexpr int MAX_DEPTH = 64;
+
+    std::vector<Node> nodes;
+    std::vector<PreparedTriangle> triangles;
+
+    /** Original index of each (reordered) triangle */
+    std::vector<int> triangleIndices;
+
+    static float surfaceArea(const float* boundsMin, const float* boundsMax){
+        float dx = boundsMax[0] - boundsMin[0];
+        float dy = boundsMax[1] - boundsMin[1];
+        float dz = boundsMax[2] - boundsMin[2];
+        return dx < 0.f ? 0.f : 2.f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    static void resetBounds(float* boundsMin, float* boundsMax){
+        for(int a = 0; a < 3; ++a){
+            boundsMin[a] = std::numeric_limits<float>::infinity();
+            boundsMax[a] = -std::numeric_limits<float>::infinity();
+        }
+    }
+
+    static void growBounds(float* boundsMin, float* boundsMax, const float* otherMin, const float* otherMax){
+        for(int a = 0; a < 3; ++a){
+            boundsMin[a] = std::min(boundsMin[a], otherMin[a]);
+            boundsMax[a] = std::max(boundsMax[a], otherMax[a]);
+        }
+    }
+
+    void build(std::vector<BuildTriangle>& buildTriangles, int nodeIndex, int first, int count, int depth){
+        Node& node = nodes[nodeIndex];
+        resetBounds(node.boundsMin, node.boundsMax);
+        float centroidMin[3], centroidMax[3];
+        resetBounds(centroidMin, centroidMax);
+        for(int i = first; i < first + count; ++i){
+            growBounds(node.boundsMin, node.boundsMax, buildTriangles[i].boundsMin, buildTriangles[i].boundsMax);
+            growBounds(centroidMin, centroidMax, buildTriangles[i].centroid, buildTriangles[i].centroid);
+        }
+
+        node.leftOrFirst = first;
+        node.count = count;
+        if(count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH - 2)
+            return;
+
+        // Split along the axis with the largest centroid extent:
+        int axis = 0;
+        for(int a = 1; a < 3; ++a){
+            if(centroidMax[a] - centroidMin[a] > centroidMax[axis] - centroidMin[axis])
+                axis = a;
+        }
+        float extent = centroidMax[axis] - centroidMin[axis];
+        if(extent <= 0.f)
+            return;
+
+        struct Bin {
+            float boundsMin[3], boundsMax[3];
+            int count = 0;
+        } bins[BIN_COUNT];
+        for(Bin& bin : bins)
+            resetBounds(bin.boundsMin, bin.boundsMax);
+
+        float binScale = BIN_COUNT / extent;
+        auto binOf = [&](const BuildTriangle& triangle){
+            return std::min(BIN_COUNT - 1, int((triangle.centroid[axis] - centroidMin[axis]) * binScale));
+        };
+        for(int i = first; i < first + count; ++i){
+            Bin& bin = bins[binOf(buildTriangles[i])];
+            growBounds(bin.boundsMin, bin.boundsMax, buildTriangles[i].boundsMin, buildTriangles[i].boundsMax);
+            ++bin.count;
+        }
+
+        // Evaluate the SAH cost for every split between two bins:
+        float bestCost = std::numeric_limits<float>::infinity();
+        int bestSplit = -1;
+        for(int split = 1; split < BIN_COUNT; ++split){
+            float leftMin[3], leftMax[3], rightMin[3], rightMax[3];
+            resetBounds(leftMin, leftMax);
+            resetBounds(rightMin, rightMax);
+            int leftCount = 0, rightCount = 0;
+            for(int b = 0; b < split; ++b){
+                growBounds(leftMin, leftMax, bins[b].boundsMin, bins[b].boundsMax);
+                leftCount += bins[b].count;
+            }
+            for(int b = split; b < BIN_COUNT; ++b){
+                growBounds(rightMin, rightMax, bins[b].boundsMin, bins[b].boundsMax);
+                rightCount += bins[b].count;
+            }
+            if(leftCount == 0 || rightCount == 0)
+                continue;
+
+            float cost = leftCount * surfaceArea(leftMin, leftMax) + rightCount * surfaceArea(rightMin, rightMax);
+            if(cost < bestCost){
+                bestCost = cost;
+                bestSplit = split;
+            }
+        }
+
+        // Stay a leaf if splitting is not cheaper than testing all triangles:
+        if(bestSplit < 0 || bestCost >= count * surfaceArea(node.boundsMin, node.boundsMax))
+            return;
+
+        BuildTriangle* middle = std::partition(buildTriangles.data() + first, buildTriangles.data() + first + count, [&](const BuildTriangle& triangle){
+            return binOf(triangle) < bestSplit;
+        });
+        int leftCount = int(middle - (buildTriangles.data() + first));
+
+        int leftIndex = int(nodes.size());
+        nodes.emplace_back();
+        nodes.emplace_back();
+
+        // (node may be invalidated by emplace_back)
+        nodes[nodeIndex].leftOrFirst = leftIndex;
+        nodes[nodeIndex].count = 0;
+
+        build(buildTriangles, leftIndex, first, leftCount, depth + 1);
+        build(buildTriangles, leftIndex + 1, first + leftCount, count - leftCount, depth + 1);
+    }
+
+    /** Distance to the entry of the node's box, or infinity if it is missed (or behind maxT) */
+    static inline float intersectBounds(const Node& node, const float* origin, const float* inverseDirection, float maxT){
+        float tMin = 0.f, tMax = maxT;
+        for(int a = 0; a < 3; ++a){
+            float t0 = (node.boundsMin[a] - origin[a]) * inverseDirection[a];
+            float t1 = (node.boundsMax[a] - origin[a]) * inverseDirection[a];
+            if(t0 > t1)
+                std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+        }
+        return tMin <= tMax ? tMin : std::numeric_limits<float>::infinity();
+    }
+
+    /** Möller-Trumbore test (double sided) */
+    static inline bool intersectTriangle(const PreparedTriangle& triangle, const float* origin, const float* direction, float maxT, float& t, float& u, float& v){
+        const float* e1 = triangle.edge1;
+        const float* e2 = triangle.edge2;
+
+        float p[3] = {direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0]};
+        float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if(std::abs(determinant) < 1e-12f)
+            return false;
+
+        float inverseDeterminant = 1.f / determinant;
+        float s[3] = {origin[0] - triangle.v0[0], origin[1] - triangle.v0[1], origin[2] - triangle.v0[2]};
+        u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverseDeterminant;
+        if(u < 0.f || u > 1.f)
+            return false;
+
+        float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+        v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverseDeterminant;
+        if(v < 0.f || u + v > 1.f)
+            return false;
+
+        t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverseDeterminant;
+        return t > 0.f && t < maxT;
+    }
+
+public:
+    /** Builds the hierarchy over the triangles (only the positions are used) */
+    TriangleBVH(const std::vector<Triangle>& meshTriangles){
+        std::vector<BuildTriangle> buildTriangles(meshTriangles.size());
+        for(size_t i = 0; i < meshTriangles.size(); ++i){
+            const Triangle& triangle = meshTriangles[i];
+            const float* a0 = &triangle.a.position.x;
+            const float* b0 = &triangle.b.position.x;
+            const float* c0 = &triangle.c.position.x;
+
+            BuildTriangle& buildTriangle = buildTriangles[i];
+            buildTriangle.index = int(i);
+            for(int a = 0; a < 3; ++a){
+                float p0 = a0[a], p1 = b0[a], p2 = c0[a];
+                buildTriangle.boundsMin[a] = std::min({p0, p1, p2});
+                buildTriangle.boundsMax[a] = std::max({p0, p1, p2});
+                buildTriangle.centroid[a] = (p0 + p1 + p2) / 3.f;
+            }
+        }
+
+        nodes.reserve(std::max<size_t>(1, meshTriangles.size() * 2));
+        nodes.emplace_back();
+        build(buildTriangles, 0, 0, int(buildTriangles.size()), 0);
+
+        triangles.resize(buildTriangles.size());
+        triangleIndices.resize(buildTriangles.size());
+        for(size_t i = 0; i < buildTriangles.size(); ++i){
+            const Triangle& triangle = meshTriangles[buildTriangles[i].index];
+            const float* a0 = &triangle.a.position.x;
+            const float* b0 = &triangle.b.position.x;
+            const float* c0 = &triangle.c.position.x;
+            for(int a = 0; a < 3; ++a){
+                triangles[i].v0[a] = a0[a];
+                triangles[i].edge1[a] = b0[a] - a0[a];
+                triangles[i].edge2[a] = c0[a] - a0[a];
+            }
+            triangleIndices[i] = buildTriangles[i].index;
+        }
+    }
+
+    size_t getTriangleCount() const {
+        return triangles.size();
+    }
+
+    size_t getNodeCount() const {
+        return nodes.size();
+    }
+
+    /**
+     * Finds the closest triangle hit by origin + t * direction with t in (0, maxT).
+     * The direction does not need to be normalized.
+     */
+    bool intersect(const float origin[3], const float direction[3], float maxT, Hit& hit) const {
+        if(triangles.empty())
+            return false;
+
+        float inverseDirection[3];
+        for(int a = 0; a < 3; ++a)
+            inverseDirection[a] = 1.f / (direction[a] != 0.f ? direction[a] : 1e-30f);
+
+        int stack[MAX_DEPTH];
+        int stackSize = 0;
+        int current = 0;
+        if(intersectBounds(nodes[0], origin, inverseDirection, maxT) == std::numeric_limits<float>::infinity())
+            return false;
+
+        int hitIndex = -1;
+        while(true){
+            const Node& node = nodes[current];
+            if(node.count > 0){
+                for(int i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i){
+                    float t, u, v;
+                    if(intersectTriangle(triangles[i], origin, direction, maxT, t, u, v)){
+                        maxT = t;
+                        hit.t = t;
+                        hit.u = u;
+                        hit.v = v;
+                        hitIndex = i;
+                    }
+                }
+            } else {
+                // Visit the closer child first, push the other one:
+                int left = node.leftOrFirst;
+                int right = left + 1;
+                float tLeft = intersectBounds(nodes[left], origin, inverseDirection, maxT);
+                float tRight = intersectBounds(nodes[right], origin, inverseDirection, maxT);
+                if(tRight < tLeft){
+                    std::swap(left, right);
+                    std::swap(tLeft, tRight);
+                }
+
+                if(tLeft != std::numeric_limits<float>::infinity()){
+                    if(tRight != std::numeric_limits<float>::infinity())
+                        stack[stackSize++] = right;
+                    current = left;
+                    continue;
+                }
+            }
+
+            if(stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+
+        if(hitIndex < 0)
+            return false;
+
+        hit.triangle = triangleIndices[hitIndex];
+        return true;
+    }
+};
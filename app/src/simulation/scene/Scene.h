@@ -74,6 +74,15 @@ public:
             }
         }
 
+        // Further cameras around a larger table (inactive by default, up to 8 cameras in total):
+        for(float angle : {0.f, 90.f, -90.f, 130.f, -130.f}){
+            std::shared_ptr<VirtualRGBDCamera> rgbdCamera = std::make_shared<VirtualRGBDCamera>();
+            rgbdCamera->transformation = Mat4f::translation(0.9f * std::cos(degToRad(angle)), 2.6f, -0.9f * std::sin(degToRad(angle))) * Mat4f::rotationY(degToRad(angle)) * Mat4f::rotationZ(degToRad(65.f + 180.f)) * Mat4f::rotationY(degToRad(90));
+            rgbdCamera->active = false;
+            add(rgbdCamera);
+            Data::instance.rgbdCameras.push_back(rgbdCamera);
+        }
+
         // A simple coordinate system:
         std::shared_ptr<CoordinateSystem> coordinateSystem = std::make_shared<CoordinateSystem>();
         add(coordinateSystem);
@@ -2,11 +2,13 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "src/math/Mat4.h"
 
 #include "src/gl/Shader.h"
+#include "src/simulation/scene/SceneUniforms.h"
 
 /** Data from a light source */
 struct LightData {
@@ -57,19 +59,22 @@ struct SceneData {
     /** List of lights that are active this frame */
     std::vector<LightData> lights;
 
-    /** Function that sets the light data in the shader, since multiple objects use the same lighting model */
+    /**
+     * Function that sets the light data in the shader, since multiple objects use the same lighting model.
+     * The lights are uploaded into the light block in world space (only when they changed), the shader
+     * transforms them with its view matrix.
+     */
     void setLightUniforms(const std::shared_ptr<Shader>& shader) const {
-        shader->setUniform("light_num", static_cast<int>(lights.size()));
+        LightBlock block;
+        block.lightCount = static_cast<int>(std::min<size_t>(lights.size(), UNIFORM_BLOCK_MAX_LIGHTS));
 
-        for (int i = 0; i < lights.size(); ++i) {
-            const LightData& lightData = lights[i];
-            std::string lightIdStr = std::to_string(i);
-            const Vec4f lightPosCS = view * lightData.positionWS;
-            constexpr float range = 15.0f;
-
-            shader->setUniform("lights[" + lightIdStr + "].position", lightPosCS);
-            shader->setUniform("lights[" + lightIdStr + "].range", range);
-            shader->setUniform("lights[" + lightIdStr + "].color", lightData.color);
+        for (int i = 0; i < block.lightCount; ++i) {
+            block.lights[i].position = lights[i].positionWS;
+            block.lights[i].color = lights[i].color;
+            block.lights[i].range = 15.0f;
         }
+
+        SceneUniforms::getInstance().uploadLights(block);
+        SceneUniforms::bindBlocks(*shader);
     }
 };
@@ -0,0 +1,122 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include "src/math/Mat4.h"
+#include "src/gl/Shader.h"
+#include "src/gl/UniformBuffer.h"
+
+// Array sizes of the uniform blocks (have to match shader/*Block.shader):
+#define UNIFORM_BLOCK_MAX_PROJECTORS 5
+#define UNIFORM_BLOCK_MAX_CAMERAS 8
+#define UNIFORM_BLOCK_MAX_LIGHTS 10
+
+/** Binding points of the uniform blocks */
+enum UniformBlockBinding {
+    UNIFORM_BLOCK_PROJECTORS = 0,
+    UNIFORM_BLOCK_CAMERAS,
+    UNIFORM_BLOCK_LIGHTS
+};
+
+// std140 mirrors of the blocks in shader/projectorBlock.shader, cameraBlock.shader and lightBlock.shader:
+
+struct ProjectorParameters {
+    Mat4f projection;
+
+    /** Inverse of the transformation */
+    Mat4f view;
+    Mat4f model;
+
+    Vec4f position;
+
+    /** Viewing direction in world space */
+    Vec4f direction;
+
+    int isActive = 0;
+    int padding[3] = {};
+};
+
+struct ProjectorBlock {
+    ProjectorParameters projectors[UNIFORM_BLOCK_MAX_PROJECTORS];
+    int projectorCount = 0;
+    int padding[3] = {};
+};
+
+struct CameraParameters {
+    /** Camera to world space (point cloud matrix) */
+    Mat4f model;
+
+    /** Inverse of the model matrix */
+    Mat4f view;
+
+    int isActive = 0;
+    int padding[3] = {};
+};
+
+struct CameraBlock {
+    CameraParameters cameras[UNIFORM_BLOCK_MAX_CAMERAS];
+};
+
+struct LightParameters {
+    /** Position in world space */
+    Vec4f position;
+    Vec4f color;
+    float range = 0.f;
+    float padding[3] = {};
+};
+
+struct LightBlock {
+    LightParameters lights[UNIFORM_BLOCK_MAX_LIGHTS];
+    int lightCount = 0;
+    int padding[3] = {};
+};
+
+static_assert(sizeof(ProjectorParameters) == 240 && sizeof(ProjectorBlock) == 1216, "ProjectorBlock does not match the std140 layout");
+static_assert(sizeof(CameraParameters) == 144 && sizeof(CameraBlock) == 1152, "CameraBlock does not match the std140 layout");
+static_assert(sizeof(LightParameters) == 48 && sizeof(LightBlock) == 496, "LightBlock does not match the std140 layout");
+
+/**
+ * The uniform buffers of the projector, camera and light parameters shared by
+ * all shaders.
+ *
+ * They are filled once per frame (the lights whenever they change), so that
+ * the shaders only have to connect their blocks instead of looking up and
+ * setting the uniforms of every array element in every pass.
+ */
+class SceneUniforms {
+    UniformBuffer<ProjectorBlock> projectorBuffer = UniformBuffer<ProjectorBlock>(UNIFORM_BLOCK_PROJECTORS);
+    UniformBuffer<CameraBlock> cameraBuffer = UniformBuffer<CameraBlock>(UNIFORM_BLOCK_CAMERAS);
+    UniformBuffer<LightBlock> lightBuffer = UniformBuffer<LightBlock>(UNIFORM_BLOCK_LIGHTS);
+
+public:
+    static SceneUniforms& getInstance(){
+        static SceneUniforms sceneUniforms;
+        return sceneUniforms;
+    }
+
+    void uploadProjectors(const ProjectorBlock& block){
+        projectorBuffer.upload(block);
+    }
+
+    void uploadCameras(const CameraBlock& block){
+        cameraBuffer.upload(block);
+    }
+
+    void uploadLights(const LightBlock& block){
+        lightBuffer.upload(block);
+    }
+
+    /** Connects the blocks of the shader to the buffers (blocks the shader does not use are ignored) */
+    static void bindBlocks(Shader& shader){
+        shader.setUniformBlockBinding("ProjectorBlock", UNIFORM_BLOCK_PROJECTORS);
+        shader.setUniformBlockBinding("CameraBlock", UNIFORM_BLOCK_CAMERAS);
+        shader.setUniformBlockBinding("LightBlock", UNIFORM_BLOCK_LIGHTS);
+    }
+
+    /** Deletes the buffers (before the context is destroyed) */
+    void release(){
+        projectorBuffer.release();
+        cameraBuffer.release();
+        lightBuffer.release();
+    }
+};
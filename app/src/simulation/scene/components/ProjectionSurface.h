@@ -5,6 +5,7 @@
 #include "src/Data.h"
 
 #include "src/simulation/scene/components/Projector.h"
+#include "src/simulation/scene/SceneUniforms.h"
 
 #include "src/gl/Mesh.h"
 #include "src/gl/Shader.h"
@@ -66,25 +67,17 @@ public:
         shader->setUniform("model", model);
         shader->setUniform("ambient_color", sceneData.ambientColor);
 
-        // Set data for the projectors:
-        std::vector<std::shared_ptr<Projector>> projectors = Data::instance.projectors;
-        shader->setUniform("proj_num", static_cast<int>(projectors.size()));
+        // The projector parameters are in the projector block (see SceneUniforms),
+        // only the images have to be bound:
+        const std::vector<std::shared_ptr<Projector>>& projectors = Data::instance.projectors;
+        int projectorCount = std::min(static_cast<int>(projectors.size()), UNIFORM_BLOCK_MAX_PROJECTORS);
 
-        for (int i = 0; i < projectors.size(); i++) {
-            std::shared_ptr<Projector> projector = projectors[i];
-            std::string projIdStr = std::to_string(i);
-
-            projector->getTexture().bind(i+1);
-            shader->setUniform("images[" + projIdStr + "]", i+1);
-            shader->setUniform("projectors[" + projIdStr + "].is_active", projector->active);
-
-            // Assumes that projector parentModel is identity!
-            shader->setUniform("projectors[" + projIdStr + "].model", projector->transformation);
-            shader->setUniform("projectors[" + projIdStr + "].invModel", projector->transformation.inverse());
-            shader->setUniform("projectors[" + projIdStr + "].projectionMatrix", projector->projectionMatrix);
+        for (int i = 0; i < projectorCount; i++) {
+            projectors[i]->getTexture().bind(i+1);
+            shader->setUniform("images[" + std::to_string(i) + "]", i+1);
         }
 
-        // Set data for the lights:
+        // Set data for the lights (and connect the uniform blocks):
         sceneData.setLightUniforms(shader);
 
         shader->setUniform("bumpIntensity", Data::instance.projectionPlaneBumpIntensity);
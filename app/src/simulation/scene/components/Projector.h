@@ -11,6 +11,7 @@
 #include "src/gl/TextureFBO.h"
 
 #include "src/simulation/scene/components/RectifiedProjection.h"
+#include "src/processing/LatencyTracer.h"
 
 
 class Projector : public SceneComponent {
@@ -108,6 +109,8 @@ public:
 
         glBindFramebuffer(GL_FRAMEBUFFER, storedFBO);
         glViewport(storedViewport[0], storedViewport[1], storedViewport[2], storedViewport[3]);
+
+        LatencyTracer::getInstance().stamp(LATENCY_PROJECTOR_RENDER);
     }
 
     /**
@@ -6,6 +6,7 @@
 
 #include "src/processing/OrganizedPointCloud.h"
 
+#include "src/gl/AsyncReadback.h"
 #include "src/gl/TextureFBO.h"
 #include "src/gl/Mesh.h"
 #include "src/gl/Shader.h"
@@ -43,11 +44,8 @@ class VirtualRGBDCamera : public SceneComponent {
 
     NoiseTexture2D noiseTexture;
 
-    // Vector for 3d data:
-    std::vector<uint16_t> dataDepth;
-
-    // Vector for color data:
-    std::vector<Vec4b> dataBGRA;
+    /** Recycles the arrays of the organized point clouds */
+    std::shared_ptr<FramePool> framePool = std::make_shared<FramePool>();
 
     float* lookupImageTo3D = nullptr;
     float* lookup3DToImage = nullptr;
@@ -106,11 +104,7 @@ public:
         if (sndPassShader == nullptr)
             sndPassShader = std::make_shared<Shader>(CMAKE_SOURCE_DIR "/shader/rgbdSndPass.vert", CMAKE_SOURCE_DIR "/shader/rgbdSndPass.frag");
 
-        // Allocate memory for the texture data:
         GLsizei dataSize = width * height;
-        dataDepth.resize(dataSize);
-        dataBGRA.resize(dataSize);
-
         lookupImageTo3D = new float[dataSize * 2];
         lookup3DToImage = new float[lookup3DToImageSize * lookup3DToImageSize * 2];
 
@@ -177,8 +171,14 @@ public:
         mesh->render();
     }
 
-    /** Renders the rgbd image */
-    void renderRGBD(SceneComposite& scene) {
+    /**
+     * Renders the rgbd image and reads it back asynchronously (see AsyncReadback).
+     * The point cloud is passed to the callback in a later frame.
+     */
+    void renderRGBD(SceneComposite& scene, std::function<void(std::shared_ptr<OrganizedPointCloud>)> pointCloudCallback) {
+        FrameTrace trace;
+        trace.stamp(LATENCY_SDK_ARRIVAL);
+
         // First pass:
         {
             SceneData rgbdSceneData(SD_SIMULATED_CAMERA);
@@ -226,39 +226,42 @@ public:
             quadMesh.render();
         }
 
-        // Read Point Cloud data from GPU to RAM:
-        {
-            dataFBO.getTexture2D(0).bind();
-            glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, dataDepth.data());
-        }
+        // Read depth and color back (delivered in request order, so the point cloud is complete after the color):
+        std::shared_ptr<OrganizedPointCloud> pc = createPointCloud();
+        pc->trace = trace;
 
-        // Read Color data from GPU to RAM:
-        {
-            fstPassFBO.getTexture2D(0).bind();
-            glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA, GL_UNSIGNED_BYTE, dataBGRA.data());
-        }
+        AsyncReadback::getInstance().read(dataFBO.getTexture2D(0).texture, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, pc->width * pc->height * sizeof(uint16_t),
+            [pc](const void* data, size_t size){
+                std::memcpy(pc->depth, data, size);
+            });
 
+        AsyncReadback::getInstance().read(fstPassFBO.getTexture2D(0).texture, 0, GL_BGRA, GL_UNSIGNED_BYTE, pc->width * pc->height * sizeof(Vec4b),
+            [pc, pointCloudCallback](const void* data, size_t size){
+                std::memcpy(pc->colors, data, size);
+                pointCloudCallback(pc);
+            });
     }
 
-    std::shared_ptr<OrganizedPointCloud> getOrganizedPointCloud(){
-        const size_t size = dataDepth.size();
+    /** Creates a point cloud with the arrays and lookup tables of this camera (data not filled) */
+    std::shared_ptr<OrganizedPointCloud> createPointCloud(){
+        const size_t size = size_t(width) * height;
         auto pc = std::make_shared<OrganizedPointCloud>(width, height);
-        // TODO: maybe only initialize multiple arrays at the beginning
-        pc->depth = new uint16_t[size];
-        pc->colors = new Vec4b[size];
+        pc->framePool = framePool;
+        pc->depth = framePool->acquire<uint16_t>(size);
+        pc->colors = framePool->acquire<Vec4b>(size);
         pc->lookupImageTo3D = lookupImageTo3D;
         pc->lookup3DToImage = lookup3DToImage;
         pc->lookup3DToImageSize = lookup3DToImageSize;
         pc->modelMatrix = transformation;
         pc->usageFlags = CAMERA_RESPONSIBILITY_GESTURES | CAMERA_RESPONSIBILITY_OCCLUSION | CAMERA_RESPONSIBILITY_RECTIFICATION;
-
-        // Invalid pixels are drawn but placed inside the RGBD Camera:
-        std::memcpy(pc->depth, dataDepth.data(), size * sizeof(uint16_t));
-        std::memcpy(pc->colors, dataBGRA.data(), size * sizeof(Vec4b));
-
         return pc;
     }
 
+    /** Returns the pool the point cloud arrays are acquired from. */
+    std::shared_ptr<FramePool> getFramePool() {
+        return framePool;
+    }
+
     /** Returns the projection matrix for this camera. */
     Mat4f getProjection() const {
         return Mat4f::customPerspectiveTransformation(horizontalFOV, verticalFOV);
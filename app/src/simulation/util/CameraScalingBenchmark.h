@@ -0,0 +1,245 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "src/Data.h"
+#include "src/processing/blendpcr/CameraPasses.h"
+#include "src/simulation/scene/components/VirtualRGBDCamera.h"
+
+/**
+ * Measures how the frame time scales with the number of simulated cameras
+ * (started with --benchmark-cameras [frames]).
+ *
+ * Activates the first 1, 2, ..., 8 virtual RGBD cameras in turn. For each
+ * count it waits until CameraPasses uses all of them (plus some warm up frames
+ * for the specialized shaders and reallocated targets) and averages the frame
+ * time and the GPU time of the camera passes (CameraPasses, ShadowAvoidance)
+ * and of the screen passes (BlendPCRRenderer) over the given number of frames.
+ *
+ * The GPU times are read back at the end of each frame, which synchronizes
+ * CPU and GPU once per frame. V-Sync of the main window is disabled while
+ * running. The results are printed and written to camera_scaling.csv.
+ */
+class CameraScalingBenchmark {
+public:
+    enum Section {
+        SECTION_CAMERA_PASSES = 0,
+        SECTION_SCREEN_PASSES = 1,
+        SECTION_COUNT = 2
+    };
+
+    struct Result {
+        int cameras = 0;
+        int frames = 0;
+        double frameMs = 0.0;
+        double sectionMs[SECTION_COUNT] = {0.0, 0.0};
+    };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    int framesPerStep = 200;
+    int warmupFrames = 30;
+
+    /** Frames to wait for the cameras of a step before it is skipped */
+    int timeoutFrames = 300;
+
+    int maxCameras = 0;
+    int cameras = 0;
+    int stepFrame = 0;
+    int measuredFrames = 0;
+    bool running = false;
+
+    GLuint queries[SECTION_COUNT] = {0, 0};
+    bool queryIssued[SECTION_COUNT] = {false, false};
+
+    Clock::time_point lastFrameEnd;
+    Result current;
+
+    std::vector<bool> previouslyActive;
+    bool previousRenderRawPointCloud = false;
+
+    std::vector<Result> results;
+
+    void startStep(int cameraCount){
+        cameras = cameraCount;
+        stepFrame = 0;
+        measuredFrames = 0;
+        current = Result();
+        current.cameras = cameraCount;
+
+        for(size_t i = 0; i < Data::instance.rgbdCameras.size(); ++i)
+            Data::instance.rgbdCameras[i]->active = int(i) < cameraCount;
+    }
+
+    void finish(){
+        running = false;
+
+        for(size_t i = 0; i < Data::instance.rgbdCameras.size() && i < previouslyActive.size(); ++i)
+            Data::instance.rgbdCameras[i]->active = previouslyActive[i];
+        Data::instance.renderRawPointCloud = previousRenderRawPointCloud;
+
+        glDeleteQueries(SECTION_COUNT, queries);
+        glfwSwapInterval(1);
+
+        printResults();
+        writeCsv("camera_scaling.csv");
+    }
+
+public:
+    bool isRunning() const {
+        return running;
+    }
+
+    const std::vector<Result>& getResults() const {
+        return results;
+    }
+
+    /**
+     * Starts the benchmark with the given number of measured frames per camera
+     * count. Requires the simulated RGBD data (no real or recorded cameras).
+     */
+    bool start(int frames){
+        if(!Data::instance.cameraManager.requiresSimulatedRGBDData()){
+            std::cerr << "Camera scaling benchmark: Requires simulated cameras (no connected or replayed devices)." << std::endl;
+            return false;
+        }
+
+        maxCameras = std::min<int>(int(Data::instance.rgbdCameras.size()), MAX_CAMERA_COUNT);
+        if(maxCameras == 0){
+            std::cerr << "Camera scaling benchmark: No virtual RGBD cameras in the scene." << std::endl;
+            return false;
+        }
+
+        framesPerStep = std::max(1, frames);
+        results.clear();
+
+        previouslyActive.clear();
+        for(const std::shared_ptr<VirtualRGBDCamera>& rgbdCam : Data::instance.rgbdCameras)
+            previouslyActive.push_back(rgbdCam->active);
+        previousRenderRawPointCloud = Data::instance.renderRawPointCloud;
+
+        // The screen passes are only executed when the raw point cloud is rendered:
+        Data::instance.renderRawPointCloud = true;
+
+        glGenQueries(SECTION_COUNT, queries);
+        glfwSwapInterval(0);
+
+        std::cout << "Camera scaling benchmark: 1 to " << maxCameras << " cameras, " << framesPerStep << " frames each." << std::endl;
+
+        running = true;
+        lastFrameEnd = Clock::now();
+        startStep(1);
+        return true;
+    }
+
+    /** Starts the GPU timer of a section (must not be nested) */
+    void beginSection(Section section){
+        if(!running)
+            return;
+
+        glBeginQuery(GL_TIME_ELAPSED, queries[section]);
+    }
+
+    void endSection(Section section){
+        if(!running)
+            return;
+
+        glEndQuery(GL_TIME_ELAPSED);
+        queryIssued[section] = true;
+    }
+
+    /**
+     * Call once per frame after the buffers were swapped. Returns true when
+     * the benchmark has just finished.
+     */
+    bool endFrame(){
+        if(!running)
+            return false;
+
+        // GPU times of this frame (waits for the GPU):
+        double sectionMs[SECTION_COUNT] = {0.0, 0.0};
+        for(int section = 0; section < SECTION_COUNT; ++section){
+            if(!queryIssued[section])
+                continue;
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[section], GL_QUERY_RESULT, &nanoseconds);
+            sectionMs[section] = double(nanoseconds) / 1e6;
+            queryIssued[section] = false;
+        }
+
+        Clock::time_point now = Clock::now();
+        double frameMs = std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+        lastFrameEnd = now;
+
+        ++stepFrame;
+
+        // Wait until all cameras of this step are processed (simulated point clouds arrive some frames later):
+        bool camerasReady = int(CameraPasses::getInstance().usedCameraIDs.size()) == cameras;
+        if(measuredFrames == 0 && (!camerasReady || stepFrame <= warmupFrames)){
+            if(!camerasReady && stepFrame > timeoutFrames){
+                std::cerr << "Camera scaling benchmark: Skipping " << cameras << " cameras (only " << CameraPasses::getInstance().usedCameraIDs.size() << " in use)." << std::endl;
+            } else {
+                return false;
+            }
+        } else {
+            current.frameMs += frameMs;
+            for(int section = 0; section < SECTION_COUNT; ++section)
+                current.sectionMs[section] += sectionMs[section];
+            ++measuredFrames;
+
+            if(measuredFrames < framesPerStep)
+                return false;
+
+            current.frames = measuredFrames;
+            current.frameMs /= measuredFrames;
+            for(int section = 0; section < SECTION_COUNT; ++section)
+                current.sectionMs[section] /= measuredFrames;
+            results.push_back(current);
+        }
+
+        if(cameras < maxCameras){
+            startStep(cameras + 1);
+            return false;
+        }
+
+        finish();
+        return true;
+    }
+
+    void printResults() const {
+        std::printf("%-8s %8s %12s %14s %14s %12s\n", "Cameras", "Frames", "Frame [ms]", "Camera [ms]", "Screen [ms]", "per Camera");
+        for(const Result& result : results){
+            double gpuMs = result.sectionMs[SECTION_CAMERA_PASSES] + result.sectionMs[SECTION_SCREEN_PASSES];
+            std::printf("%-8d %8d %12.2f %14.2f %14.2f %12.2f\n", result.cameras, result.frames, result.frameMs,
+                        result.sectionMs[SECTION_CAMERA_PASSES], result.sectionMs[SECTION_SCREEN_PASSES], gpuMs / result.cameras);
+        }
+    }
+
+    void writeCsv(const std::string& path) const {
+        std::ofstream file(path);
+        if(!file.is_open()){
+            std::cerr << "Camera scaling benchmark: Could not write " << path << std::endl;
+            return;
+        }
+
+        file << "cameras,frames,frame_ms,camera_passes_ms,screen_passes_ms" << std::endl;
+        for(const Result& result : results){
+            file << result.cameras << "," << result.frames << "," << result.frameMs << ","
+                 << result.sectionMs[SECTION_CAMERA_PASSES] << "," << result.sectionMs[SECTION_SCREEN_PASSES] << std::endl;
+        }
+        std::cout << "Camera scaling benchmark: Results written to " << path << std::endl;
+    }
+};
@@ -2,12 +2,15 @@
 // Author: Yaroslav Purgin
 #pragma once
 
+#include "src/gl/AsyncReadback.h"
+#include "src/gl/GPUProfiler.h"
 #include "src/gl/TextureFBO.h"
 #include "src/math/Vec4.h"
 #include "src/gl/primitive/Triangle.h"
 #include "src/gl/Mesh.h"
 #include "src/gl/Shader.h"
 #include <algorithm>
+#include <cstring>
 
 #include "src/Data.h"
 
@@ -34,6 +37,17 @@ private:
     static float lerp(const float a, const  float b, const float t) {
         return a + t * (b - a);
     }
+
+    /** Moves the exposure towards the value for the given average color of the image. */
+    void adaptExposure(const Vec4f& averageColor) {
+        // Calculate the average luminance from the average color with weights:
+        const float averageLuminance = 0.2126f * averageColor.x + 0.7152f * averageColor.y + 0.0722f * averageColor.z;
+        // Calculate the logarithmic average luminance:
+        const float logAvgLum = std::clamp(logf(averageLuminance + EPSILON), -3.f, 1.f);
+        // Calculate the exposure value:
+        Data::instance.exposure = lerp(Data::instance.exposure, KEY_VALUE / expf(logAvgLum), ADJ_SPEED);
+        Data::instance.exposure = std::clamp(Data::instance.exposure, 0.1f, 10.0f);
+    }
 public:
     /**
      * Construct, load the shader and create a mesh.
@@ -57,6 +71,8 @@ public:
     * Renders the second pass to the screen.
     */
     void render(const int display_w, const int display_h) {
+        GPUProfiler::Scope profilerScope("Post Processing");
+
         // Activate the default FBO to render directly to the screen:
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, display_w, display_h);
@@ -69,24 +85,24 @@ public:
         firstPassFBO.getTexture2D(0).bind(0);
         postShader.setUniform("renderedTexture", 0);
 
-        // Generate mipmap of the color texture (currently bound) and read back the lowest mipmap level (1x1 texture) for average color:
+        // Generate mipmap of the color texture (currently bound) and read back the lowest mipmap level (1x1 texture) for
+        // average color. The readback is asynchronous, so the exposure adapts to the image of a previous frame:
         glGenerateMipmap(GL_TEXTURE_2D);
-        Vec4f averageColor;
-        glGetTexImage(GL_TEXTURE_2D, static_cast<GLint>(log2(std::max(display_w, display_h))), GL_RGBA, GL_FLOAT, &averageColor);
+        AsyncReadback::getInstance().read(firstPassFBO.getTexture2D(0).texture, static_cast<GLint>(log2(std::max(display_w, display_h))), GL_RGBA, GL_FLOAT, sizeof(Vec4f),
+            [this](const void* data, size_t size){
+                Vec4f averageColor;
+                std::memcpy(&averageColor, data, sizeof(Vec4f));
+                adaptExposure(averageColor);
+            });
+
+        // The readback bound the texture to the current slot, so bind it again:
+        firstPassFBO.getTexture2D(0).bind(0);
 
         // Bind the depth texture of the FBO to texture slot 1 and tell our shader that
         // "renderedDepthTexture" should use this texture at texture slot 1:
         //firstPassFBO.getTexture2D(1).bind(1);
         //postShader.setUniform("renderedDepthTexture", 1);
 
-        // Calculate the average luminance from the average color with weights:
-        const float averageLuminance = 0.2126f * averageColor.x + 0.7152f * averageColor.y + 0.0722f * averageColor.z;
-        // Calculate the logarithmic average luminance:
-        const float logAvgLum = std::clamp(logf(averageLuminance + EPSILON), -3.f, 1.f);
-        // Calculate the exposure value:
-        Data::instance.exposure = lerp(Data::instance.exposure, KEY_VALUE / expf(logAvgLum), ADJ_SPEED);
-        Data::instance.exposure = std::clamp(Data::instance.exposure, 0.1f, 10.0f);
-
         // Set post-processing values in the shader:
         postShader.setUniform("exposure", Data::instance.exposure);
         postShader.setUniform("saturation", Data::instance.saturation);
@@ -0,0 +1,153 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+/**
+ * Compares the full resolution depth images with the 2x2 binned ones (see
+ * DepthBinning) headless: the surgical scene cameras raycast a mesh with the
+ * sensor noise model, the images are binned and each valid pixel is compared
+ * with the noise free depth along its (decimated) ray.
+ *
+ * Reports the binning time per frame, the pixel count of the camera passes,
+ * the share of valid pixels and the surface error (mean, RMS and 95th
+ * percentile of the absolute depth error in mm). The GPU frame time of the
+ * camera passes is shown in the GUI while switching "Depth Binning".
+ *
+ * Usage: DepthBinningBenchmark [mesh.obj] [frames]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "src/simulation/raycast/RaycastRGBDCamera.h"
+#include "src/processing/DepthBinning.h"
+
+// The loader is otherwise compiled in Mesh.cpp, which requires OpenGL:
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "src/tiny_obj_loader/tiny_obj_loader.h"
+
+static float degToRad(float degrees) {
+    return degrees / 180.f * M_PI;
+}
+
+struct SurfaceError {
+    size_t valid = 0;
+    size_t compared = 0;
+    std::vector<float> errors;
+
+    void add(uint16_t depth, float groundTruthMm) {
+        if (depth == 0) { return; }
+        ++valid;
+        if (groundTruthMm <= 0.f) { return; }
+        ++compared;
+        errors.push_back(std::abs(float(depth) - groundTruthMm));
+    }
+
+    void print(const char* name, int pixels, double ms) {
+        double sum = 0.0, squared = 0.0;
+        for (float e : errors) {
+            sum += e;
+            squared += double(e) * e;
+        }
+        float p95 = 0.f;
+        if (!errors.empty()) {
+            std::nth_element(errors.begin(), errors.begin() + errors.size() * 95 / 100, errors.end());
+            p95 = errors[errors.size() * 95 / 100];
+        }
+        size_t n = std::max<size_t>(1, errors.size());
+        std::printf("  %-12s %8d %8.3f ms %7.1f%% %9.2f %9.2f %9.2f\n", name, pixels, ms,
+                    100.0 * valid / std::max(1, pixels), sum / n, std::sqrt(squared / n), p95);
+    }
+};
+
+/** Noise free depth in mm along the ray (x/z, y/z, 1) of the camera, 0 if nothing is hit */
+static float groundTruthDepth(const RaycastScene& scene, const Mat4f& pose, float rayX, float rayY) {
+    Mat4f model = pose;
+    Vec4f direction = model * Vec4f(rayX, rayY, 1.f, 0.f);
+    RaycastScene::Hit hit;
+    if (!scene.intersect(pose.getPosition(), direction, 10.f, hit)) { return 0.f; }
+    return hit.t * 1000.f;
+}
+
+int main(int argc, char** argv)
+{
+    std::string meshPath = argc > 1 ? argv[1] : CMAKE_SOURCE_DIR "/models/projection-plane/ProjectionPlane.obj";
+    int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    RaycastScene scene;
+    if (scene.addObj(meshPath) < 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Camera poses of SurgicalScene:
+    std::vector<Mat4f> poses = {
+        Mat4f::translation(-0.05f, 0.1f, -0.065f) * Mat4f::translation(0.6f, 2.5f, 0.75f) * Mat4f::rotationY(degToRad(-10)) * Mat4f::rotationX(degToRad(26)) * Mat4f::rotationZ(degToRad(245.5f)) * Mat4f::rotationY(degToRad(90)),
+        Mat4f::translation(-0.05f, 0.1f, 0.065f) * Mat4f::translation(0.6f, 2.5f, -0.75f) * Mat4f::rotationY(degToRad(10)) * Mat4f::rotationX(degToRad(-26)) * Mat4f::rotationZ(degToRad(245.5f)) * Mat4f::rotationY(degToRad(90)),
+        Mat4f::translation(0.05f, 0.1f, 0.f) * Mat4f::translation(-0.6f, 2.5f, 0.f) * Mat4f::rotationY(M_PI) * Mat4f::rotationZ(degToRad(65.f + 180.f)) * Mat4f::rotationY(degToRad(90))
+    };
+
+    const DepthBinningMode modes[] = { DEPTH_BINNING_MEDIAN, DEPTH_BINNING_MIN };
+    const char* modeNames[] = { "2x2 Median", "2x2 Min" };
+
+    for (size_t cameraIndex = 0; cameraIndex < poses.size(); ++cameraIndex) {
+        RaycastRGBDCamera camera;
+        DepthBinning binning[2];
+        const int width = camera.width;
+        const int height = camera.height;
+
+        SurfaceError fullError;
+        SurfaceError binnedError[2];
+        double binningMs[2] = { 0.0, 0.0 };
+
+        std::vector<float> fullGroundTruth;
+        std::vector<float> binnedGroundTruth;
+
+        for (int frame = 0; frame < frames; ++frame) {
+            std::shared_ptr<OrganizedPointCloud> pc = camera.render(scene, poses[cameraIndex], true);
+
+            if (frame == 0) {
+                fullGroundTruth.resize(size_t(width) * height);
+                for (int i = 0; i < width * height; ++i)
+                    fullGroundTruth[i] = groundTruthDepth(scene, poses[cameraIndex], pc->lookupImageTo3D[i * 2], pc->lookupImageTo3D[i * 2 + 1]);
+            }
+
+            for (int i = 0; i < width * height; ++i)
+                fullError.add(pc->depth[i], fullGroundTruth[i]);
+
+            for (int m = 0; m < 2; ++m) {
+                auto start = Clock::now();
+                std::shared_ptr<OrganizedPointCloud> binned = binning[m].bin(pc, modes[m]);
+                binningMs[m] += milliseconds(Clock::now() - start);
+
+                const int binnedPixels = int(binned->width * binned->height);
+                if (binnedGroundTruth.size() != size_t(binnedPixels)) {
+                    binnedGroundTruth.resize(binnedPixels);
+                    for (int i = 0; i < binnedPixels; ++i)
+                        binnedGroundTruth[i] = groundTruthDepth(scene, poses[cameraIndex], binned->lookupImageTo3D[i * 2], binned->lookupImageTo3D[i * 2 + 1]);
+                }
+
+                for (int i = 0; i < binnedPixels; ++i)
+                    binnedError[m].add(binned->depth[i], binnedGroundTruth[i]);
+            }
+        }
+
+        // Valid share per frame:
+        fullError.valid /= frames;
+        for (SurfaceError& error : binnedError)
+            error.valid /= frames;
+
+        std::printf("Camera %zu (%d frames)\n", cameraIndex + 1, frames);
+        std::printf("  %-12s %8s %11s %8s %9s %9s %9s\n", "Mode", "Pixels", "Binning", "Valid", "Mean mm", "RMS mm", "P95 mm");
+        fullError.print("Full", width * height, 0.0);
+        for (int m = 0; m < 2; ++m)
+            binnedError[m].print(modeNames[m], (width / 2) * (height / 2), binningMs[m] / frames);
+    }
+
+    return EXIT_SUCCESS;
+}
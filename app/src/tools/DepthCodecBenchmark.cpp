@@ -0,0 +1,120 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+/**
+ * Measures compression ratio and single-core throughput of the RVL depth codec
+ * on the depth frames of a recorded session and verifies that every frame
+ * round-trips bit-exactly.
+ *
+ * Usage: DepthCodecBenchmark <recording.rgbdrec> [maxFramesPerStream]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "src/processing/codec/RVLDepthCodec.h"
+#include "src/processing/devices/recording/RGBDRecording.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::printf("Usage: %s <recording.rgbdrec> [maxFramesPerStream]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    RGBDRecordingReader reader(argv[1]);
+    if (!reader.isOpen()) {
+        return EXIT_FAILURE;
+    }
+
+    size_t maxFrames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : SIZE_MAX;
+
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    size_t totalFrames = 0;
+    size_t totalRawBytes = 0;
+    size_t totalEncodedBytes = 0;
+    double totalEncodeMs = 0.0;
+    double totalDecodeMs = 0.0;
+    bool allExact = true;
+
+    std::printf("%-24s %8s %8s %10s %10s %10s %10s\n", "Stream", "Frames", "Ratio", "Enc avg", "Enc max", "Dec avg", "Dec max");
+
+    for (size_t streamIndex = 0; streamIndex < reader.getStreamCount(); ++streamIndex) {
+        const RGBDRecordingReader::Stream& stream = reader.getStream(streamIndex);
+        size_t pixelCount = size_t(stream.info.width) * stream.info.height;
+
+        std::vector<uint16_t> depth(pixelCount);
+        std::vector<uint16_t> decoded(pixelCount);
+        std::vector<uint8_t> encoded(RVLDepthCodec::maxEncodedSize(pixelCount));
+
+        size_t frames = 0;
+        size_t encodedBytes = 0;
+        double encodeMs = 0.0, encodeMaxMs = 0.0;
+        double decodeMs = 0.0, decodeMaxMs = 0.0;
+
+        for (size_t frameIndex = 0; frameIndex < reader.getFrameCount(streamIndex) && frameIndex < maxFrames; ++frameIndex) {
+            RGBDRecordingReader::Frame frame = reader.getFrame(streamIndex, frameIndex);
+
+            // Get the raw depth image (recordings may already be compressed):
+            if (frame.header->depthEncoding == RGBD_RECORDING_DEPTH_RAW && frame.header->depthBytes == pixelCount * sizeof(uint16_t)) {
+                std::memcpy(depth.data(), frame.depth, frame.header->depthBytes);
+            } else if (frame.header->depthEncoding != RGBD_RECORDING_DEPTH_RVL
+                       || !RVLDepthCodec::decode(frame.depth, frame.header->depthBytes, depth.data(), pixelCount)) {
+                std::printf("Skipping frame %zu of stream %zu (no readable depth)\n", frameIndex, streamIndex);
+                continue;
+            }
+
+            auto start = Clock::now();
+            size_t size = RVLDepthCodec::encode(depth.data(), pixelCount, encoded.data());
+            auto encodeEnd = Clock::now();
+            bool decodedOk = RVLDepthCodec::decode(encoded.data(), size, decoded.data(), pixelCount);
+            auto decodeEnd = Clock::now();
+
+            if (!decodedOk || decoded != depth) {
+                std::printf("Round trip mismatch in frame %zu of stream %zu!\n", frameIndex, streamIndex);
+                allExact = false;
+            }
+
+            encodeMs += milliseconds(encodeEnd - start);
+            decodeMs += milliseconds(decodeEnd - encodeEnd);
+            encodeMaxMs = std::max(encodeMaxMs, milliseconds(encodeEnd - start));
+            decodeMaxMs = std::max(decodeMaxMs, milliseconds(decodeEnd - encodeEnd));
+            encodedBytes += size;
+            ++frames;
+        }
+
+        if (frames == 0) {
+            continue;
+        }
+
+        std::string name(stream.info.serial, strnlen(stream.info.serial, sizeof(stream.info.serial)));
+        std::printf("%-24s %8zu %7.2fx %7.3f ms %7.3f ms %7.3f ms %7.3f ms\n", name.c_str(), frames,
+                    double(frames * pixelCount * sizeof(uint16_t)) / encodedBytes,
+                    encodeMs / frames, encodeMaxMs, decodeMs / frames, decodeMaxMs);
+
+        totalFrames += frames;
+        totalRawBytes += frames * pixelCount * sizeof(uint16_t);
+        totalEncodedBytes += encodedBytes;
+        totalEncodeMs += encodeMs;
+        totalDecodeMs += decodeMs;
+    }
+
+    if (totalFrames == 0) {
+        std::printf("No depth frames found.\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("\nTotal: %zu frames, ratio %.2fx (%.1f MB -> %.1f MB)\n", totalFrames,
+                double(totalRawBytes) / totalEncodedBytes, totalRawBytes / 1e6, totalEncodedBytes / 1e6);
+    std::printf("Encode: %.3f ms/frame, %.0f MB/s\n", totalEncodeMs / totalFrames, totalRawBytes / 1e3 / totalEncodeMs);
+    std::printf("Decode: %.3f ms/frame, %.0f MB/s (%.0fx realtime at 30 fps)\n", totalDecodeMs / totalFrames,
+                totalRawBytes / 1e3 / totalDecodeMs, (1000.0 / 30.0) / (totalDecodeMs / totalFrames));
+    std::printf("Round trip: %s\n", allExact ? "bit-exact" : "MISMATCH");
+
+    return allExact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,77 @@
+// © 2026, CGVR (https://cgvr.informatik.uni-bremen.de/),
+
+/**
+ * Runs the CPU raycasting RGBD simulation headless (no window, no OpenGL):
+ * loads a mesh, raycasts it from the three camera poses of the surgical scene
+ * and reports BVH build time, frame times and the share of valid pixels.
+ *
+ * Usage: RaycastRGBDBenchmark [mesh.obj] [frames]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "src/simulation/raycast/RaycastRGBDCamera.h"
+
+// The loader is otherwise compiled in Mesh.cpp, which requires OpenGL:
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "src/tiny_obj_loader/tiny_obj_loader.h"
+
+static float degToRad(float degrees) {
+    return degrees / 180.f * M_PI;
+}
+
+int main(int argc, char** argv)
+{
+    std::string meshPath = argc > 1 ? argv[1] : CMAKE_SOURCE_DIR "/models/projection-plane/ProjectionPlane.obj";
+    int frames = argc > 2 ? std::atoi(argv[2]) : 30;
+
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    RaycastScene scene;
+    auto buildStart = Clock::now();
+    int instance = scene.addObj(meshPath);
+    if (instance < 0) {
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: %zu triangles, %zu BVH nodes, built in %.1f ms\n", meshPath.c_str(), scene.instances[instance].bvh->getTriangleCount(),
+                scene.instances[instance].bvh->getNodeCount(), milliseconds(Clock::now() - buildStart));
+
+    // Camera poses of SurgicalScene:
+    std::vector<Mat4f> poses = {
+        Mat4f::translation(-0.05f, 0.1f, -0.065f) * Mat4f::translation(0.6f, 2.5f, 0.75f) * Mat4f::rotationY(degToRad(-10)) * Mat4f::rotationX(degToRad(26)) * Mat4f::rotationZ(degToRad(245.5f)) * Mat4f::rotationY(degToRad(90)),
+        Mat4f::translation(-0.05f, 0.1f, 0.065f) * Mat4f::translation(0.6f, 2.5f, -0.75f) * Mat4f::rotationY(degToRad(10)) * Mat4f::rotationX(degToRad(-26)) * Mat4f::rotationZ(degToRad(245.5f)) * Mat4f::rotationY(degToRad(90)),
+        Mat4f::translation(0.05f, 0.1f, 0.f) * Mat4f::translation(-0.6f, 2.5f, 0.f) * Mat4f::rotationY(M_PI) * Mat4f::rotationZ(degToRad(65.f + 180.f)) * Mat4f::rotationY(degToRad(90))
+    };
+
+    std::printf("Worker threads: %u (+ calling thread)\n", WorkerPool::getInstance().getThreadCount());
+    std::printf("%-8s %10s %10s %8s\n", "Camera", "avg", "max", "valid");
+
+    for (size_t cameraIndex = 0; cameraIndex < poses.size(); ++cameraIndex) {
+        RaycastRGBDCamera camera;
+        double totalMs = 0.0, maxMs = 0.0;
+        size_t validPixels = 0;
+
+        for (int frame = 0; frame < frames; ++frame) {
+            auto start = Clock::now();
+            std::shared_ptr<OrganizedPointCloud> pc = camera.render(scene, poses[cameraIndex], true);
+            double ms = milliseconds(Clock::now() - start);
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+
+            if (frame == 0) {
+                for (int i = 0; i < camera.width * camera.height; ++i)
+                    validPixels += pc->depth[i] != 0;
+            }
+        }
+
+        std::printf("%-8zu %7.2f ms %7.2f ms %7.1f%%\n", cameraIndex + 1, totalMs / frames, maxMs,
+                    100.0 * validPixels / (camera.width * camera.height));
+    }
+
+    return EXIT_SUCCESS;
+}
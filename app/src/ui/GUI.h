@@ -14,6 +14,7 @@
 
 // Include functions to display Mat4f and Vec4f in the GUI:
 #include <imgui_cg1_helpers.h>
+#include <implot.h>
 
 // Include Data Struct:
 #include "src/Data.h"
@@ -21,10 +22,16 @@
 #include "src/simulation/scene/components/VirtualRGBDCamera.h"
 
 #include "src/ui/PipelineVisualization.h"
+#include "src/processing/LatencyTracer.h"
+#include "src/processing/devices/FramePreprocessor.h"
+#include "src/gl/AsyncReadback.h"
+#include "src/gl/GPUProfiler.h"
+#include "src/processing/blendpcr/CameraPasses.h"
 
 // Include Camera:
 #include "src/simulation/scene/Camera.h"
 
+#include <ctime>
 #include <functional>
 
 #include "GLFW/glfw3.h"
@@ -58,6 +65,17 @@ public:
         ImGui::Separator();
         static const char* labels[] = { "Off", "Very high", "Medium", "Low" };
         ImGui::SliderInt("Mesh Res.", &Data::instance.rectificationMeshStride, 1, 3, labels[Data::instance.rectificationMeshStride]);
+
+        // 2x2 binning of the depth images at ingest (quarter of the pixels in all camera passes):
+        static const char* binningLabels[] = { "Off", "2x2 Median", "2x2 Min" };
+        RGBDCameraManager& cameraManager = Data::instance.cameraManager;
+        for (int deviceIndex = 0; deviceIndex < cameraManager.getDeviceCount(); deviceIndex++) {
+            int mode = cameraManager.getDepthBinningMode(deviceIndex);
+            std::string label = "Depth Binning " + std::to_string(deviceIndex + 1);
+            if (ImGui::Combo(label.c_str(), &mode, binningLabels, IM_ARRAYSIZE(binningLabels))) {
+                cameraManager.setDepthBinningMode(deviceIndex, DepthBinningMode(mode));
+            }
+        }
         ImGui::Separator();
 
         auto DrawResButton = [](const char* label, int w, int h)
@@ -132,6 +150,23 @@ public:
         // Display rendered RGBD images:
         showRGBDCameras();
 
+        ImGui::Separator();
+        ImGui::Text(" ");
+        // Display statistics of the capture devices:
+        showCaptureStatistics();
+
+        // Display frame synchronization between the cameras:
+        showFrameSynchronization();
+
+        // Display capture-to-projection latencies:
+        showLatency();
+
+        // Display the implementation of the point cloud filters:
+        showPointCloudFilters();
+
+        // Display the GPU time of the passes:
+        showGPUProfiler();
+
         ImGui::Separator();
         ImGui::Text(" ");
         ImGui::Separator();
@@ -320,6 +355,11 @@ private:
         ImGui::Separator();
         ImGui::Checkbox("Render Point Cloud", &Data::instance.renderRawPointCloud);
         ImGui::Checkbox("Simulate Noise", &Data::instance.simulateRGBDNoise);
+        ImGui::Checkbox("Raycast on CPU", &Data::instance.raycastRGBDSimulation);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Raycasts the scene on worker threads instead of rendering\nand reading back the RGBD images on the render thread.");
+        if (Data::instance.raycastRGBDSimulation)
+            ImGui::Text("Raycasting: %.1f ms / frame", Data::instance.raycastRGBDFrameMs);
         ImGui::Checkbox("Show Color", &Data::instance.colorDistanceToggle);
         ImGui::Separator();
 
@@ -407,6 +447,381 @@ private:
         });
     }
 
+    /**
+     * Displays statistics of the real and virtual capture devices.
+     */
+    static void showCaptureStatistics() {
+        // Session recording (replay with --replay <file>):
+        RGBDCameraManager& cameraManager = Data::instance.cameraManager;
+        if (std::shared_ptr<RGBDSessionRecorder> recorder = cameraManager.getRecorder()) {
+            if (ImGui::Button("Stop Recording")) {
+                cameraManager.stopRecording();
+            }
+            ImGui::SameLine();
+            ImGui::Text("%zu frames (%zu dropped)", recorder->getWrittenFrameCount(), recorder->getDroppedFrameCount());
+        } else if (ImGui::Button("Record Session")) {
+            char filename[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(filename, sizeof(filename), "recording_%Y%m%d_%H%M%S.rgbdrec", std::localtime(&now));
+            cameraManager.startRecording(filename);
+        }
+
+        // Replay of recorded sessions (--replay <file>):
+        std::vector<std::shared_ptr<RecordedCamera>> recordedCameras;
+        for (const std::shared_ptr<RGBDCamera>& camera : cameraManager.getCameras()) {
+            if (std::shared_ptr<RecordedCamera> recordedCamera = std::dynamic_pointer_cast<RecordedCamera>(camera))
+                recordedCameras.push_back(recordedCamera);
+        }
+
+        if (!recordedCameras.empty()) {
+            bool playing = recordedCameras.front()->isPlaying();
+            if (ImGui::Button(playing ? "Pause Replay" : "Play Replay")) {
+                for (const std::shared_ptr<RecordedCamera>& recordedCamera : recordedCameras) {
+                    if (playing)
+                        recordedCamera->pause();
+                    else
+                        recordedCamera->play();
+                }
+            }
+            ImGui::SameLine();
+            ImGui::Text("%zu recorded cameras", recordedCameras.size());
+        }
+
+        if (!ImGui::CollapsingHeader("Capture Statistics", ImGuiTreeNodeFlags_None)) {
+            return;
+        }
+
+        auto showFramePool = [](const std::string& name, std::shared_ptr<FramePool> framePool) {
+            if (framePool == nullptr) { return; }
+
+            FramePool::Statistics stats = framePool->getStatistics();
+            ImGui::Text("%s", name.c_str());
+            ImGui::Text("  Pool: %zu hits, %zu misses", stats.hits, stats.misses);
+            ImGui::Text("  High-water: %zu buffers (%.1f MB)", stats.highWaterBuffers, stats.highWaterBytes / (1024.0 * 1024.0));
+        };
+
+        // Devices can be connected and disconnected at runtime:
+        std::string deviceStatus = cameraManager.getDeviceStatus();
+        if (!deviceStatus.empty()) {
+            ImGui::Text("%s", deviceStatus.c_str());
+        }
+
+        for (int deviceIndex = 0; deviceIndex < cameraManager.getDeviceCount(); deviceIndex++) {
+            if (cameraManager.isDeviceRemoved(deviceIndex)) {
+                ImGui::Text("Device %i: disconnected", deviceIndex);
+                continue;
+            }
+            ImGui::Text("Device %i: %llu frames, %llu overwritten", deviceIndex,
+                        (unsigned long long)cameraManager.getPublishedFrameCount(deviceIndex),
+                        (unsigned long long)cameraManager.getOverwrittenFrameCount(deviceIndex));
+
+            // Only devices which deliver raw frames (e.g. Orbbec cameras) go through the preprocessing stage:
+            FramePreprocessor::Statistics preprocessing = FramePreprocessor::getInstance().getStatistics(deviceIndex);
+            if (preprocessing.processedFrames == 0 && preprocessing.droppedFrames == 0) {
+                continue;
+            }
+            ImGui::Text("  Preprocessing: %llu frames, %llu dropped, %zu queued", (unsigned long long)preprocessing.processedFrames,
+                        (unsigned long long)preprocessing.droppedFrames, preprocessing.queuedFrames);
+
+            static const char* stageNames[FramePreprocessor::PREPROCESS_STAGE_COUNT] = { "Queue", "Conversion", "Filters", "Output" };
+            for (int stage = 0; stage < FramePreprocessor::PREPROCESS_STAGE_COUNT; stage++) {
+                ImGui::Text("    %-10s mean %.2f ms, p95 %.2f ms", stageNames[stage], preprocessing.meanMs[stage], preprocessing.p95Ms[stage]);
+            }
+        }
+        ImGui::Text("Preprocessing workers: %u", FramePreprocessor::getInstance().getThreadCount());
+
+        for (const std::shared_ptr<RGBDCamera>& camera : cameraManager.getCameras()) {
+            showFramePool(camera->type() + " " + camera->getSerial(), camera->getFramePool());
+        }
+
+        for (int cameraID = 0; cameraID < Data::instance.rgbdCameras.size(); cameraID++) {
+            showFramePool("Virtual RGBD Camera " + std::to_string(cameraID + 1), Data::instance.rgbdCameras[cameraID]->getFramePool());
+        }
+    }
+
+    /**
+     * Displays the settings and skew statistics of the timestamp-based frame
+     * grouping of the cameras.
+     */
+    static void showFrameSynchronization() {
+        if (!ImGui::CollapsingHeader("Frame Synchronization", ImGuiTreeNodeFlags_None)) {
+            return;
+        }
+
+        FrameSynchronizer& synchronizer = Data::instance.cameraManager.frameSynchronizer;
+        ImGui::Checkbox("Group Frames by Timestamp", &synchronizer.enabled);
+        ImGui::DragFloat("Tolerance (ms)", &synchronizer.toleranceMs, 0.1f, 0.0f, 33.0f);
+        ImGui::DragFloat("Max. Wait (ms)", &synchronizer.maxWaitMs, 0.5f, 0.0f, 200.0f);
+
+        static const char* policies[] = { "Use Latest", "Hold Previous", "Drop Camera" };
+        int policy = synchronizer.fallbackPolicy;
+        if (ImGui::Combo("Late / Unsynchronized Camera", &policy, policies, IM_ARRAYSIZE(policies))) {
+            synchronizer.fallbackPolicy = FrameSynchronizer::FallbackPolicy(policy);
+        }
+
+        FrameSynchronizer::Statistics stats = synchronizer.getStatistics();
+        ImGui::Text("Skew: p50 %.1f ms, p95 %.1f ms, max %.1f ms", stats.skewP50, stats.skewP95, stats.skewMax);
+        ImGui::Text("Groups: %zu (%zu within tolerance, %zu fallbacks)", stats.groups, stats.groupsWithinTolerance, stats.fallbacks);
+        for (size_t cameraID = 0; cameraID < stats.meanOffset.size(); cameraID++) {
+            ImGui::Text("  Camera %zu: %+.1f ms to reference", cameraID, stats.meanOffset[cameraID]);
+        }
+
+        if (ImGui::Button("Reset Statistics")) {
+            synchronizer.resetStatistics();
+        }
+    }
+
+    /**
+     * Displays the per-camera latency percentiles from SDK arrival to each
+     * pipeline stage and a histogram of the end-to-end latency.
+     */
+    static void showLatency() {
+        if (!ImGui::CollapsingHeader("Latency", ImGuiTreeNodeFlags_None)) {
+            return;
+        }
+
+        LatencyTracer& tracer = LatencyTracer::getInstance();
+        ImGui::Checkbox("Trace Latency", &tracer.enabled);
+        ImGui::SameLine();
+        if (ImGui::Button("Write CSV")) {
+            char filename[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(filename, sizeof(filename), "latency_%Y%m%d_%H%M%S.csv", std::localtime(&now));
+            tracer.writeCSV(filename);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) {
+            tracer.clear();
+        }
+
+        AsyncReadback::Statistics readbacks = AsyncReadback::getInstance().getStatistics();
+        ImGui::Text("GPU readbacks: %zu pending, %zu delivered, %zu forced waits, %zu buffers",
+                    readbacks.pending, readbacks.delivered, readbacks.forcedWaits, readbacks.buffers);
+
+        // Render thread cost of the texture uploads (compare both paths with the checkbox):
+        CameraPasses& cameraPasses = CameraPasses::getInstance();
+        ImGui::Checkbox("Upload via Pixel Buffers", &cameraPasses.usePixelBufferUpload);
+        ImGui::SameLine();
+        ImGui::Text("%.2f ms (%s)", cameraPasses.getUploadTime(), !cameraPasses.usePixelBufferUpload ? "direct"
+                    : PixelUploadRing::isPersistentMappingSupported() ? "persistent mapping" : "mapped per frame");
+
+        for (int cameraID : tracer.getCameraIDs()) {
+            ImGui::Text("Camera %i (ms since SDK arrival)", cameraID);
+
+            if (ImGui::BeginTable(("LatencyTable" + std::to_string(cameraID)).c_str(), 4, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp)) {
+                ImGui::TableSetupColumn("Stage");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p95");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableHeadersRow();
+
+                for (int stage = LATENCY_CALLBACK_DONE; stage < LATENCY_STAGE_COUNT; ++stage) {
+                    LatencyTracer::Percentiles percentiles = tracer.getPercentiles(cameraID, LatencyStage(stage));
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", LatencyTracer::getStageName(LatencyStage(stage)));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", percentiles.p50);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", percentiles.p95);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", percentiles.p99);
+                }
+                ImGui::EndTable();
+            }
+
+            std::vector<float> endToEnd = tracer.getLatencies(cameraID, LATENCY_BUFFER_SWAP);
+            if (!endToEnd.empty() && ImPlot::BeginPlot(("##LatencyHistogram" + std::to_string(cameraID)).c_str(), ImVec2(-1, 120))) {
+                ImPlot::SetupAxes("End-to-end [ms]", nullptr, ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+                ImPlot::PlotHistogram("Frames", endToEnd.data(), int(endToEnd.size()), ImPlotBin_Sqrt);
+                ImPlot::EndPlot();
+            }
+        }
+    }
+
+    /**
+     * Displays the settings of the point cloud filters (fragment passes or
+     * fused compute dispatches), of the MLS smoothing and of the normal
+     * estimation, and the GPU time of the per camera passes.
+     */
+    static void showPointCloudFilters() {
+        if (!ImGui::CollapsingHeader("Point Cloud Filters", ImGuiTreeNodeFlags_None)) {
+            return;
+        }
+
+        CameraPasses& cameraPasses = CameraPasses::getInstance();
+        ImGui::Checkbox("Reimplemented Filters", &cameraPasses.useReimplementedFilters);
+
+        if (cameraPasses.isComputeFilteringSupported()) {
+            ImGui::Checkbox("Fused Compute Filters", &cameraPasses.useComputeFilters);
+            if (ImGui::Button("Compare Fragment and Compute")) {
+                cameraPasses.requestFilterComparison();
+            }
+
+            if (!cameraPasses.getFilterComparisonResult().empty()) {
+                ImGui::TextWrapped("%s", cameraPasses.getFilterComparisonResult().c_str());
+            }
+        } else {
+            ImGui::Text("Fragment passes (compute shaders require OpenGL 4.3)");
+        }
+
+        // Faster approximations of the MLS smoothing:
+        int mlsMode = cameraPasses.mlsMode;
+        if (ImGui::BeginCombo("MLS", CameraPasses::getMLSModeName(cameraPasses.mlsMode))) {
+            for (int mode = 0; mode < CameraPasses::MLS_MODE_COUNT; mode++) {
+                if (ImGui::Selectable(CameraPasses::getMLSModeName(CameraPasses::MLSMode(mode)), mode == mlsMode)) {
+                    cameraPasses.mlsMode = CameraPasses::MLSMode(mode);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        if (ImGui::Button("Measure MLS Error")) {
+            cameraPasses.requestMLSQualityMeasurement();
+        }
+        if (!cameraPasses.getMLSQualityResult().empty()) {
+            ImGui::TextWrapped("%s", cameraPasses.getMLSQualityResult().c_str());
+        }
+
+        // Jump flooding: the cost of the edge proximity only grows with the logarithm of the radius:
+        ImGui::SliderInt("Edge Proximity Radius", &cameraPasses.edgeProximityRadius, 1, 32);
+
+        // Normal estimation (the summed-area tables cost the same for every radius):
+        if (cameraPasses.isSummedAreaNormalsSupported()) {
+            int normalsMode = cameraPasses.normalsMode;
+            if (ImGui::BeginCombo("Normals", CameraPasses::getNormalsModeName(cameraPasses.normalsMode))) {
+                for (int mode = 0; mode < CameraPasses::NORMALS_MODE_COUNT; mode++) {
+                    if (ImGui::Selectable(CameraPasses::getNormalsModeName(CameraPasses::NormalsMode(mode)), mode == normalsMode)) {
+                        cameraPasses.normalsMode = CameraPasses::NormalsMode(mode);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+        }
+        ImGui::SliderInt("Normal Radius", &cameraPasses.normalRadius, 1, 10);
+
+        if (cameraPasses.isSummedAreaNormalsSupported()) {
+            if (ImGui::Button("Compare Normal Modes")) {
+                cameraPasses.requestNormalsComparison();
+            }
+            if (!cameraPasses.getNormalsComparisonResult().empty()) {
+                ImGui::TextWrapped("%s", cameraPasses.getNormalsComparisonResult().c_str());
+                for (int mode = 0; mode < CameraPasses::NORMALS_MODE_COUNT; mode++) {
+                    CameraPasses::NormalsMode normalsMode = CameraPasses::NormalsMode(mode);
+                    ImGui::Text("  %-20s %.3f ms (one camera)", CameraPasses::getNormalsModeName(normalsMode), cameraPasses.getNormalsComparisonTime(normalsMode));
+                }
+            }
+        }
+
+        // Only recompute the tiles in which the depth changed:
+        ImGui::Checkbox("Recompute Dirty Tiles Only", &cameraPasses.useDirtyTiles);
+        if (cameraPasses.useDirtyTiles) {
+            ImGui::SliderFloat("Tile Noise at 1 m (mm)", &cameraPasses.dirtyTileSettings.noiseAtOneMeter, 0.5f, 20.f);
+            ImGui::SliderInt("Changed Pixels per Tile", &cameraPasses.dirtyTileSettings.minChangedPixels, 1, 64);
+            ImGui::SliderInt("Full Refresh Interval", &cameraPasses.dirtyTileSettings.refreshInterval, 0, 300);
+            ImGui::SliderInt("Temporal Filter Settle Frames", &cameraPasses.dirtyTileSettings.settleFrames, 0, 120);
+            ImGui::Text("Tiles skipped: %.1f %% (dilated by %i px)", cameraPasses.getSkippedTileRatio() * 100.f, cameraPasses.getDirtyTileRadius());
+            for (unsigned int cameraID : cameraPasses.usedCameraIDs) {
+                ImGui::Text("  Camera %u: %.1f %%", cameraID, cameraPasses.getSkippedTileRatio(cameraID) * 100.f);
+            }
+            if (ImGui::Button("Compare with Full Recomputation")) {
+                cameraPasses.requestDirtyTileComparison();
+            }
+            if (!cameraPasses.getDirtyTileComparisonResult().empty()) {
+                ImGui::TextWrapped("%s", cameraPasses.getDirtyTileComparisonResult().c_str());
+            }
+        }
+
+        ImGui::Text("GPU time (all cameras):");
+        for (int pass = 0; pass < CameraPasses::PASS_COUNT; pass++) {
+            ImGui::Text("  %-16s %.2f ms", CameraPasses::getPassName(CameraPasses::Pass(pass)), cameraPasses.getPassTime(CameraPasses::Pass(pass)));
+        }
+    }
+
+    /**
+     * Displays the GPU time of the profiled passes: a timeline of the last
+     * frames with the top level passes stacked, and the statistics of all
+     * passes (nested ones indented).
+     */
+    static void showGPUProfiler() {
+        if (!ImGui::CollapsingHeader("GPU Profiler", ImGuiTreeNodeFlags_None)) {
+            return;
+        }
+
+        GPUProfiler& profiler = GPUProfiler::getInstance();
+        ImGui::Checkbox("Profile GPU", &profiler.enabled);
+        ImGui::SameLine();
+        if (ImGui::Button("Write CSV##GPUProfiler")) {
+            char filename[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(filename, sizeof(filename), "gpu_profile_%Y%m%d_%H%M%S.csv", std::localtime(&now));
+            profiler.writeCSV(filename);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear##GPUProfiler")) {
+            profiler.clear();
+        }
+
+        GPUProfiler::PassStatistics frame = profiler.getFrameStatistics();
+        ImGui::Text("GPU frame: mean %.2f ms, p95 %.2f ms (%zu frames dropped)", frame.meanMs, frame.p95Ms, profiler.getDroppedFrames());
+
+        std::vector<std::string> passNames = profiler.getPassNames();
+        std::vector<float> frameTimes = profiler.getFrameHistory();
+        int count = int(frameTimes.size());
+
+        if (count > 0 && ImPlot::BeginPlot("##GPUTimeline", ImVec2(-1, 200))) {
+            ImPlot::SetupAxes("Frame", "GPU [ms]", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::SetupLegend(ImPlotLocation_North, ImPlotLegendFlags_Outside | ImPlotLegendFlags_Horizontal);
+
+            std::vector<float> frames(count), lower(count, 0.f), upper(count);
+            for (int i = 0; i < count; i++) {
+                frames[i] = float(i - count + 1);
+            }
+
+            // Nested passes are contained in their parents, so only the top level ones are stacked:
+            for (const std::string& passName : passNames) {
+                if (profiler.getPassDepth(passName) != 0) {
+                    continue;
+                }
+
+                std::vector<float> history = profiler.getHistory(passName);
+                for (int i = 0; i < count; i++) {
+                    upper[i] = lower[i] + (std::isnan(history[i]) ? 0.f : history[i]);
+                }
+                ImPlot::PlotShaded(passName.c_str(), frames.data(), lower.data(), upper.data(), count);
+                lower = upper;
+            }
+
+            // Includes the GPU time between the passes:
+            ImPlot::PlotLine("Frame", frames.data(), frameTimes.data(), count);
+            ImPlot::EndPlot();
+        }
+
+        if (ImGui::BeginTable("GPUProfilerTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp)) {
+            ImGui::TableSetupColumn("Pass [ms]");
+            ImGui::TableSetupColumn("mean");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+
+            for (const std::string& passName : passNames) {
+                GPUProfiler::PassStatistics pass = profiler.getStatistics(passName);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%*s%s", pass.depth * 2, "", passName.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", pass.meanMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", pass.p50Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", pass.p95Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", pass.maxMs);
+            }
+            ImGui::EndTable();
+        }
+    }
+
     /**
      * Displays other miscellaneous settings.
      */